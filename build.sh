@@ -1,5 +1,5 @@
 #!/bin/bash
-# Usage: ./build.sh [clean|debug|release|run|help]
+# Usage: ./build.sh [clean|debug|release|run|bench|determinism|help]
 
 set -e
 
@@ -11,6 +11,10 @@ YELLOW='\033[1;33m'
 CYAN='\033[0;36m'
 NC='\033[0m' # No Color
 
+# World hash of ft_vox_bench's default determinism box with the default seed. Only
+# update it along with changes that are meant to alter the terrain.
+EXPECTED_WORLD_HASH="0x22f406ed31cabd99"
+
 function show_help() {
     cat << EOF
 ft_vox - Build script
@@ -24,6 +28,8 @@ Available actions:
   release      - Compile in Release mode
   run          - Compile and run in Release mode
   run-debug    - Compile and run in Debug mode
+  bench        - Compile and run the benchmarks in Release mode
+  determinism  - Check that world generation still gives the reference chunks
   help         - Show this help
 
 Examples:
@@ -133,6 +139,29 @@ function run_project() {
     cd "$original_dir"
 }
 
+function run_bench() {
+    build_project "Release"
+
+    echo -e "${CYAN}📊 Running ft_vox_bench (Release)...${NC}"
+
+    # Same working directory as the game so asset paths resolve
+    local original_dir=$(pwd)
+    cd "build/Release"
+
+    ./ft_vox_bench "$@"
+
+    cd "$original_dir"
+}
+
+function run_determinism() {
+    build_project "Release"
+
+    echo -e "${CYAN}🔁 Checking world generation determinism (Release)...${NC}"
+    # Reference pass on one thread, then shuffled on one and on every hardware thread
+    ./build/Release/ft_vox_bench --suite determinism --threads 1,0 \
+        --expect-hash "$EXPECTED_WORLD_HASH"
+}
+
 case "$ACTION" in
     clean)
         clean_build
@@ -149,6 +178,13 @@ case "$ACTION" in
     run-debug)
         run_project "Debug"
         ;;
+    bench)
+        shift
+        run_bench "$@"
+        ;;
+    determinism)
+        run_determinism
+        ;;
     help)
         show_help
         exit 0
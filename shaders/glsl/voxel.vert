@@ -1,20 +1,17 @@
 #version 460
 #extension GL_ARB_shader_draw_parameters : require
 
-// --- PACKED VERTEX INPUT ---
-// We now receive a single uint as vertex input
-layout(location = 0) in uint inVertexData;
-
 // GLOBAL data - same for all draws in this batch
 layout(push_constant) uniform constants {
     mat4 viewProjection;
+    uint drawOffset; // Start of the culling phase's draw list in the chunk buffer
 }
 PushConstants;
 
 // PER-CHUNK data - indexed by the draw call
 struct GPUChunkData {
     vec3 chunkWorldPos;
-    float padding;
+    float voxelScale; // Merged regions are meshed on a coarser grid
 };
 
 // SSBO containing per-chunk data
@@ -23,6 +20,20 @@ layout(set = 0, binding = 0) readonly buffer ChunkDataBuffer {
 }
 chunkBuffer;
 
+// --- PACKED QUAD INPUT ---
+// No vertex buffer: every 6 vertices pull one quad record and build its two triangles
+// geometry bit layout: [X:5][Y:5][Z:5][Normal:3][Width-1:5][Height-1:5][Spare:4]
+// texture bit layout:  [Texture:7][Spare:25]
+struct VoxelQuad {
+    uint geometry;
+    uint texture;
+};
+
+layout(set = 0, binding = 1) readonly buffer QuadBuffer {
+    VoxelQuad quads[];
+}
+quadBuffer;
+
 layout(location = 0) out vec3 outNormal;
 layout(location = 1) out vec4 outColor;
 layout(location = 2) out vec2 outUV;
@@ -43,27 +54,54 @@ const vec2 UVS[4] = vec2[](vec2(0.0, 0.0), // 0: Bottom-left
                            vec2(0.0, 1.0)  // 3: Top-left
 );
 
+// Corner of each of the 6 vertices: triangles (0, 2, 1) and (0, 3, 2),
+// Counter-Clockwise when viewed from outside
+const uint QUAD_CORNERS[6] = uint[](0u, 2u, 1u, 0u, 3u, 2u);
+
+// Position of a corner inside the voxel grid, width and height extending along the
+// axes of ChunkMesh::getFaceAxes
+vec3 quadCorner(uint normalId, uint corner, vec3 origin, float w, float h) {
+    // 0 or the full size along each in-plane axis, from the UV corner
+    vec2 span = UVS[corner] * vec2(w, h);
+    switch (normalId) {
+    case 0u: // +X, width along Z, height along Y
+        return origin + vec3(1.0, span.y, span.x);
+    case 1u: // -X, width along Z (reversed), height along Y
+        return origin + vec3(0.0, span.y, w - span.x);
+    case 2u: // +Y, width along X, height along Z
+        return origin + vec3(span.x, 1.0, span.y);
+    case 3u: // -Y, width along X, height along Z (reversed)
+        return origin + vec3(span.x, 0.0, h - span.y);
+    case 4u: // +Z, width along X (reversed), height along Y
+        return origin + vec3(w - span.x, span.y, 1.0);
+    default: // -Z, width along X, height along Y
+        return origin + vec3(span.x, span.y, 0.0);
+    }
+}
+
 void main() {
     // --- UNPACKING LOGIC ---
-    // Bit layout: [X:6][Y:6][Z:6][Normal:3][UV:2][Texture:7][Spare:2]
-    uint x = (inVertexData) & 0x3Fu;
-    uint y = (inVertexData >> 6) & 0x3Fu;
-    uint z = (inVertexData >> 12) & 0x3Fu;
+    // firstVertex of each draw is 6 * its first quad, so this indexes the whole buffer
+    VoxelQuad quad = quadBuffer.quads[gl_VertexIndex / 6];
+    uint corner = QUAD_CORNERS[gl_VertexIndex % 6];
 
-    uint normalId = (inVertexData >> 18) & 0x7u;
-    uint uvId = (inVertexData >> 21) & 0x3u;
-    uint textureId = (inVertexData >> 23) & 0x7Fu;
+    uint x = quad.geometry & 0x1Fu;
+    uint y = (quad.geometry >> 5) & 0x1Fu;
+    uint z = (quad.geometry >> 10) & 0x1Fu;
+    uint normalId = (quad.geometry >> 15) & 0x7u;
+    float w = float(((quad.geometry >> 18) & 0x1Fu) + 1u);
+    float h = float(((quad.geometry >> 23) & 0x1Fu) + 1u);
+    uint textureId = quad.texture & 0x7Fu;
 
-    vec3 inPosition = vec3(float(x), float(y), float(z));
+    vec3 inPosition = quadCorner(normalId, corner, vec3(float(x), float(y), float(z)), w, h);
     vec3 normal = NORMALS[normalId];
-    vec2 uv = UVS[uvId];
+    vec2 uv = UVS[corner];
     // --- END UNPACKING LOGIC ---
 
     // --- Get per-chunk data from SSBO ---
-    // In Vulkan multi-draw indirect, we use gl_InstanceIndex
-    // We set firstInstance in the indirect command to identify each chunk
-    GPUChunkData chunkData = chunkBuffer.chunks[gl_DrawID];
-    vec3 worldPos = inPosition + chunkData.chunkWorldPos;
+    // Each culling phase writes its own draw list, gl_DrawID indexes into it
+    GPUChunkData chunkData = chunkBuffer.chunks[PushConstants.drawOffset + gl_DrawID];
+    vec3 worldPos = (inPosition * chunkData.voxelScale) + chunkData.chunkWorldPos;
 
     gl_Position = PushConstants.viewProjection * vec4(worldPos, 1.0);
 
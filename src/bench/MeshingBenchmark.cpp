@@ -0,0 +1,242 @@
+#include "MeshingBenchmark.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/Util/JobSystem.hpp"
+#include "common/Util/perlinNoise.hpp"
+#include "common/World/BlockRegistry.hpp"
+#include "common/World/Chunk.hpp"
+#include "common/World/ChunkMesh.hpp"
+#include "common/World/ChunkSnapshot.hpp"
+
+namespace {
+constexpr int GRID_SIZE = 4; // Terrains are GRID_SIZE x GRID_SIZE chunks at y = 0
+constexpr uint8_t STONE = 1;
+constexpr uint8_t GRASS = 2;
+constexpr uint8_t OAK_WOOD = 3;
+constexpr uint8_t WATER = 4;
+
+struct Terrain {
+    std::string name;
+    std::vector<std::unique_ptr<Chunk>> chunks; // Indexed x + z * GRID_SIZE
+
+    [[nodiscard]] const Chunk* at(int x, int z) const {
+        if (x < 0 || z < 0 || x >= GRID_SIZE || z >= GRID_SIZE) {
+            return nullptr;
+        }
+        return chunks[static_cast<size_t>(x + (z * GRID_SIZE))].get();
+    }
+};
+
+// Bytes a quad cost as 4 packed uint32 vertices and 6 uint32 indices, before
+// vertex pulling, kept as the reference for the upload column
+constexpr size_t INDEXED_QUAD_BYTES = (4 + 6) * sizeof(uint32_t);
+
+struct MeshResult {
+    size_t quads = 0;
+    size_t uploadBytes = 0;
+    double bestMs = 0.0; // Fastest full pass over the terrain
+};
+
+// heightAt(worldX, worldZ) returns the column height, columns are stone capped with grass
+Terrain buildHeightmapTerrain(const std::string& name,
+                              const std::function<int(int, int)>& heightAt) {
+    Terrain terrain{.name = name, .chunks = {}};
+    for (int cz = 0; cz < GRID_SIZE; cz++) {
+        for (int cx = 0; cx < GRID_SIZE; cx++) {
+            auto chunk = std::make_unique<Chunk>();
+            for (int x = 0; x < Chunk::CHUNK_SIZE; x++) {
+                for (int z = 0; z < Chunk::CHUNK_SIZE; z++) {
+                    int height = std::clamp(heightAt((cx * Chunk::CHUNK_SIZE) + x,
+                                                     (cz * Chunk::CHUNK_SIZE) + z),
+                                            1, Chunk::CHUNK_SIZE);
+                    for (int y = 0; y < height; y++) {
+                        chunk->setBlock(x, y, z, y < height - 3 ? STONE : GRASS);
+                    }
+                }
+            }
+            chunk->compactStorage();
+            terrain.chunks.push_back(std::move(chunk));
+        }
+    }
+    return terrain;
+}
+
+// The staircase pattern every chunk got before TerrainGenerator
+Terrain buildStaircaseTerrain() {
+    Terrain terrain{.name = "staircase", .chunks = {}};
+    for (int i = 0; i < GRID_SIZE * GRID_SIZE; i++) {
+        auto chunk = std::make_unique<Chunk>();
+        for (int x = 0; x < Chunk::CHUNK_SIZE; x++) {
+            for (int z = 0; z < Chunk::CHUNK_SIZE; z++) {
+                int height = (x + z) / 2;
+                for (int y = 0; y < height && y < Chunk::CHUNK_SIZE; y++) {
+                    if (y < height - 5) {
+                        chunk->setBlock(x, y, z, STONE);
+                    } else if (y < height - 1) {
+                        chunk->setBlock(x, y, z, GRASS);
+                    } else if ((x % 3 == 0) && (z % 3 == 0)) {
+                        chunk->setBlock(x, y, z, WATER);
+                    } else {
+                        chunk->setBlock(x, y, z, OAK_WOOD);
+                    }
+                }
+            }
+        }
+        chunk->compactStorage();
+        terrain.chunks.push_back(std::move(chunk));
+    }
+    return terrain;
+}
+
+Terrain buildPerlinTerrain() {
+    constexpr int WORLD_SIZE = GRID_SIZE * Chunk::CHUNK_SIZE;
+    constexpr float BASE_FREQUENCY = 0.02F;
+    constexpr long int SEED = 42;
+    constexpr int OCTAVES = 4;
+    constexpr float PERSISTENCE = 0.5F;
+    const std::vector<std::vector<float>> noise =
+        perlinNoise(WORLD_SIZE, WORLD_SIZE, BASE_FREQUENCY, SEED, OCTAVES, PERSISTENCE);
+
+    return buildHeightmapTerrain("perlin heightmap", [&noise](int x, int z) {
+        return 16 + static_cast<int>(noise[static_cast<size_t>(z)][static_cast<size_t>(x)] * 24.0F);
+    });
+}
+
+MeshResult meshTerrain(const Terrain& terrain, const BlockRegistry& registry,
+                       ChunkMesh::MeshingMode mode, int iterations) {
+    MeshResult result;
+    std::vector<VoxelQuad> quads;
+
+    for (int iteration = 0; iteration < iterations; iteration++) {
+        MeshResult pass;
+        const auto start = std::chrono::steady_clock::now();
+        for (int z = 0; z < GRID_SIZE; z++) {
+            for (int x = 0; x < GRID_SIZE; x++) {
+                ChunkMesh::generateMesh(*terrain.at(x, z), registry, quads, terrain.at(x, z + 1),
+                                        terrain.at(x, z - 1), terrain.at(x + 1, z),
+                                        terrain.at(x - 1, z), nullptr, nullptr, mode);
+                pass.quads += quads.size();
+            }
+        }
+        pass.bestMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() -
+                                                                start)
+                          .count();
+        pass.uploadBytes = pass.quads * sizeof(VoxelQuad);
+
+        if (iteration == 0 || pass.bestMs < result.bestMs) {
+            result = pass;
+        }
+    }
+    return result;
+}
+
+// Same work as meshTerrain(), but every chunk is meshed as a job from its snapshot
+MeshResult meshTerrainParallel(const Terrain& terrain, const BlockRegistry& registry,
+                               ChunkMesh::MeshingMode mode, int iterations, JobSystem& jobs) {
+    struct ChunkJob {
+        std::unique_ptr<ChunkSnapshot> snapshot;
+        std::vector<VoxelQuad> quads;
+    };
+    MeshResult result;
+
+    for (int iteration = 0; iteration < iterations; iteration++) {
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<ChunkJob> chunkJobs;
+        for (int z = 0; z < GRID_SIZE; z++) {
+            for (int x = 0; x < GRID_SIZE; x++) {
+                chunkJobs.push_back(ChunkJob{
+                    .snapshot = std::make_unique<ChunkSnapshot>(
+                        *terrain.at(x, z), terrain.at(x, z + 1), terrain.at(x, z - 1),
+                        terrain.at(x + 1, z), terrain.at(x - 1, z), nullptr, nullptr),
+                    .quads = {}});
+            }
+        }
+
+        JobSystem::Counter counter;
+        for (ChunkJob& chunkJob : chunkJobs) {
+            jobs.submit(
+                [&chunkJob, &registry, mode]() {
+                    ChunkMesh::generateMesh(*chunkJob.snapshot, registry, chunkJob.quads, mode);
+                },
+                &counter);
+        }
+        jobs.wait(counter);
+
+        MeshResult pass;
+        pass.bestMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() -
+                                                                start)
+                          .count();
+        for (const ChunkJob& chunkJob : chunkJobs) {
+            pass.quads += chunkJob.quads.size();
+        }
+        pass.uploadBytes = pass.quads * sizeof(VoxelQuad);
+
+        if (iteration == 0 || pass.bestMs < result.bestMs) {
+            result = pass;
+        }
+    }
+    return result;
+}
+
+void printRow(const std::string& mode, const MeshResult& result) {
+    constexpr double KIB = 1024.0;
+    std::cout << "  " << std::left << std::setw(10) << mode << std::right << std::setw(10)
+              << result.quads << std::setw(12) << result.quads * 2 << std::setw(14) << std::fixed
+              << std::setprecision(1) << static_cast<double>(result.uploadBytes) / KIB
+              << std::setw(14) << static_cast<double>(result.quads * INDEXED_QUAD_BYTES) / KIB
+              << std::setw(12) << std::setprecision(3) << result.bestMs << std::setw(12)
+              << std::setprecision(1) << result.bestMs * 1000.0 / (GRID_SIZE * GRID_SIZE) << "\n";
+}
+} // namespace
+
+void runMeshingBenchmark(const BlockRegistry& registry, int iterations) {
+    constexpr std::array MODES = {ChunkMesh::MeshingMode::PerFace, ChunkMesh::MeshingMode::Greedy,
+                                  ChunkMesh::MeshingMode::Binary};
+
+    // The calling thread helps while waiting, so count it in the label
+    JobSystem jobs;
+    const std::string parallelLabel = "Binary x" + std::to_string(jobs.getThreadCount() + 1);
+
+    std::vector<Terrain> terrains;
+    terrains.push_back(buildStaircaseTerrain());
+    terrains.push_back(buildPerlinTerrain());
+    terrains.push_back(buildHeightmapTerrain("flat", [](int, int) { return 16; }));
+
+    std::cout << "Meshing benchmark: " << GRID_SIZE << "x" << GRID_SIZE
+              << " chunks per terrain, best of " << iterations << " passes\n";
+    for (const Terrain& terrain : terrains) {
+        std::cout << "\n[" << terrain.name << "]\n";
+        std::cout << "  " << std::left << std::setw(10) << "mode" << std::right << std::setw(10)
+                  << "quads" << std::setw(12) << "triangles" << std::setw(14) << "upload KiB"
+                  << std::setw(14) << "indexed KiB" << std::setw(12) << "time ms" << std::setw(12)
+                  << "us/chunk" << "\n";
+
+        MeshResult reference;
+        for (ChunkMesh::MeshingMode mode : MODES) {
+            MeshResult result = meshTerrain(terrain, registry, mode, iterations);
+            printRow(ChunkMesh::getMeshingModeName(mode), result);
+            if (mode == ChunkMesh::MeshingMode::PerFace) {
+                reference = result;
+            } else if (result.quads > 0) {
+                std::cout << "  " << std::setw(10) << "" << std::setprecision(2)
+                          << static_cast<double>(reference.quads) /
+                                 static_cast<double>(result.quads)
+                          << "x fewer quads, " << reference.bestMs / result.bestMs
+                          << "x mesh speed\n";
+            }
+        }
+
+        MeshResult parallel = meshTerrainParallel(terrain, registry,
+                                                  ChunkMesh::MeshingMode::Binary, iterations, jobs);
+        printRow(parallelLabel, parallel);
+    }
+}
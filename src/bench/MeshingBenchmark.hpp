@@ -0,0 +1,7 @@
+#pragma once
+
+class BlockRegistry;
+
+// Meshes a few representative terrains with every ChunkMesh::MeshingMode and prints
+// quad/triangle/vertex counts, upload size and meshing time side by side.
+void runMeshingBenchmark(const BlockRegistry& registry, int iterations);
@@ -0,0 +1,676 @@
+#include "WorldBenchmark.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <memory>
+#include <numbers>
+#include <ostream>
+#include <random>
+#include <span>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/Util/JobSystem.hpp"
+#include "common/Util/perlinNoise.hpp"
+#include "common/World/BiomeMap.hpp"
+#include "common/World/BlockRegistry.hpp"
+#include "common/World/Chunk.hpp"
+#include "common/World/ChunkInstanciator.hpp"
+#include "common/World/ChunkMesh.hpp"
+#include "common/World/ChunkSnapshot.hpp"
+#include "common/World/TerrainGenerator.hpp"
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+// Lookups timed together: a single one is below the clock's resolution
+constexpr size_t LOOKUP_BATCH = 4096;
+constexpr size_t LOOKUP_BATCHES_PER_ITERATION = 64;
+
+// Neighbour offset across each ChunkSnapshot::BorderSide
+const std::array<glm::ivec3, 6> NEIGHBOR_OFFSETS = {
+    glm::ivec3(1, 0, 0), glm::ivec3(-1, 0, 0), glm::ivec3(0, 1, 0),
+    glm::ivec3(0, -1, 0), glm::ivec3(0, 0, 1), glm::ivec3(0, 0, -1)};
+
+double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+double elapsedUs(Clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+// Summary of a set of samples, nearest-rank percentiles
+nlohmann::json summarize(std::vector<double> samples) {
+    if (samples.empty()) {
+        return nlohmann::json::object();
+    }
+    std::sort(samples.begin(), samples.end());
+    const auto percentile = [&samples](double p) {
+        const auto rank = static_cast<size_t>(p * static_cast<double>(samples.size() - 1));
+        return samples.at(rank);
+    };
+    double sum = 0.0;
+    for (double sample : samples) {
+        sum += sample;
+    }
+    return {{"mean", sum / static_cast<double>(samples.size())},
+            {"p50", percentile(0.50)},
+            {"p90", percentile(0.90)},
+            {"p99", percentile(0.99)},
+            {"max", samples.back()}};
+}
+
+// work(i) for every i < count on `threads` threads, the calling one included
+void runParallel(size_t count, unsigned int threads, const std::function<void(size_t)>& work) {
+    if (threads <= 1) {
+        for (size_t i = 0; i < count; i++) {
+            work(i);
+        }
+        return;
+    }
+    JobSystem jobs(threads - 1);
+    JobSystem::Counter counter;
+    for (size_t i = 0; i < count; i++) {
+        jobs.submit([&work, i]() { work(i); }, &counter);
+    }
+    jobs.wait(counter);
+}
+
+std::vector<glm::ivec3> worldPositions(const WorldBenchmarkOptions& options) {
+    std::vector<glm::ivec3> positions;
+    for (int y = 0; y < options.worldHeight; y++) {
+        for (int z = 0; z < options.worldSize; z++) {
+            for (int x = 0; x < options.worldSize; x++) {
+                positions.emplace_back(x, y, z);
+            }
+        }
+    }
+    return positions;
+}
+
+void printRate(std::ostream* report, const std::string& label, double value,
+               const std::string& unit) {
+    if (report != nullptr) {
+        *report << "  " << std::left << std::setw(28) << label << std::right << std::setw(14)
+                << std::fixed << std::setprecision(1) << value << " " << unit << "\n";
+    }
+}
+
+void printPercentiles(std::ostream* report, const std::string& label,
+                      const nlohmann::json& summary, const std::string& unit) {
+    if (report != nullptr && !summary.empty()) {
+        *report << "  " << std::left << std::setw(28) << label << std::right << std::fixed
+                << std::setprecision(2) << "p50 " << summary["p50"].get<double>() << "  p90 "
+                << summary["p90"].get<double>() << "  p99 " << summary["p99"].get<double>()
+                << "  max " << summary["max"].get<double>() << " " << unit << "\n";
+    }
+}
+
+// Generates every chunk of the box once per thread count. Keeps the last world.
+nlohmann::json benchmarkGeneration(const WorldBenchmarkOptions& options, chunkMap& world,
+                                   std::ostream* report) {
+    const std::vector<glm::ivec3> positions = worldPositions(options);
+    nlohmann::json results = nlohmann::json::array();
+
+    for (unsigned int threads : options.threadCounts) {
+        std::vector<std::unique_ptr<Chunk>> chunks(positions.size());
+        std::vector<double> chunkUs(positions.size());
+        const TerrainGenerator generator(options.seed); // Fresh counters for each run
+        const auto start = Clock::now();
+        runParallel(positions.size(), threads, [&](size_t i) {
+            const auto chunkStart = Clock::now();
+            chunks.at(i) = generator.generate(positions.at(i));
+            chunkUs.at(i) = elapsedUs(chunkStart);
+        });
+        const double wallMs = elapsedMs(start);
+        const TerrainGenerator::GenerationStats stats = generator.getStats();
+        const BiomeMap::CacheStats biomeCache = generator.getBiomeMap().getCacheStats();
+
+        const double chunksPerSecond = static_cast<double>(positions.size()) * 1000.0 / wallMs;
+        nlohmann::json result = {{"threads", threads},
+                                 {"chunks", positions.size()},
+                                 {"wall_ms", wallMs},
+                                 {"chunks_per_s", chunksPerSecond},
+                                 {"voxels_per_s", chunksPerSecond * Chunk::VOLUME},
+                                 {"air_chunks", stats.airChunks},
+                                 {"solid_chunks", stats.solidChunks},
+                                 {"density_samples", stats.densitySamples},
+                                 {"biome_cache_hits", biomeCache.hits},
+                                 {"biome_cache_misses", biomeCache.misses},
+                                 {"chunk_us", summarize(chunkUs)}};
+        if (report != nullptr) {
+            *report << "\n[chunk generation, " << threads << " thread(s)]\n";
+        }
+        printRate(report, "chunks/s", chunksPerSecond, "");
+        printRate(report, "voxels/s", chunksPerSecond * Chunk::VOLUME, "");
+        printRate(report, "skipped chunks (air)", static_cast<double>(stats.airChunks), "");
+        printRate(report, "skipped chunks (solid)", static_cast<double>(stats.solidChunks), "");
+        printRate(report, "density samples", static_cast<double>(stats.densitySamples), "");
+        printRate(report, "biome regions computed", static_cast<double>(biomeCache.misses), "");
+        printPercentiles(report, "per chunk", result["chunk_us"], "us");
+        results.push_back(result);
+
+        world.clear();
+        for (size_t i = 0; i < positions.size(); i++) {
+            world.emplace(positions.at(i), std::move(chunks.at(i)));
+        }
+    }
+    return results;
+}
+
+// The box generated single-threaded at each density cell size, against cell size 1 (the
+// exact per-voxel function) for the noise samples saved and the voxels that changed
+nlohmann::json benchmarkDensityLattice(const WorldBenchmarkOptions& options,
+                                       std::ostream* report) {
+    // Up to 4 the cell size is the same everywhere, 8 lets the flatter biomes use it
+    constexpr std::array CELL_SIZES = {1, 2, 4, 8};
+    const std::vector<glm::ivec3> positions = worldPositions(options);
+    std::vector<std::unique_ptr<Chunk>> exact;
+    nlohmann::json results = nlohmann::json::array();
+
+    for (int cellSize : CELL_SIZES) {
+        const TerrainGenerator generator(options.seed, cellSize);
+        std::vector<std::unique_ptr<Chunk>> chunks;
+        const auto start = Clock::now();
+        for (const glm::ivec3& position : positions) {
+            chunks.push_back(generator.generate(position));
+        }
+        const double wallMs = elapsedMs(start);
+
+        size_t changedVoxels = 0;
+        if (exact.empty()) {
+            exact = std::move(chunks);
+        } else {
+            std::array<uint8_t, Chunk::VOLUME> blocks{};
+            std::array<uint8_t, Chunk::VOLUME> exactBlocks{};
+            for (size_t i = 0; i < positions.size(); i++) {
+                chunks.at(i)->copyBlocks(blocks);
+                exact.at(i)->copyBlocks(exactBlocks);
+                for (size_t voxel = 0; voxel < blocks.size(); voxel++) {
+                    changedVoxels += blocks.at(voxel) != exactBlocks.at(voxel) ? 1 : 0;
+                }
+            }
+        }
+
+        const TerrainGenerator::GenerationStats stats = generator.getStats();
+        const size_t sampledChunks = stats.generatedChunks - stats.airChunks - stats.solidChunks;
+        const double samplesPerChunk =
+            sampledChunks == 0 ? 0.0
+                               : static_cast<double>(stats.densitySamples) /
+                                     static_cast<double>(sampledChunks);
+        const double changedPercent = 100.0 * static_cast<double>(changedVoxels) /
+                                      (static_cast<double>(positions.size()) * Chunk::VOLUME);
+        results.push_back({{"max_cell_size", cellSize},
+                           {"wall_ms", wallMs},
+                           {"chunks_per_s", static_cast<double>(positions.size()) * 1000.0 /
+                                                wallMs},
+                           {"density_samples", stats.densitySamples},
+                           {"samples_per_sampled_chunk", samplesPerChunk},
+                           {"changed_voxels", changedVoxels},
+                           {"changed_percent", changedPercent}});
+        if (report != nullptr) {
+            *report << "\n[density lattice, cell size up to " << cellSize << "]\n";
+        }
+        printRate(report, "chunks/s", static_cast<double>(positions.size()) * 1000.0 / wallMs,
+                  "");
+        printRate(report, "samples per sampled chunk", samplesPerChunk, "");
+        printRate(report, "voxels changed vs exact", changedPercent, "%");
+    }
+    return results;
+}
+
+// The box generated twice in a row by one generator on this thread: the first pass
+// computes each region column's 2D layers once for every chunk stacked on it, the
+// second revisits the box with the layers all cached
+nlohmann::json benchmarkBiomeCache(const WorldBenchmarkOptions& options,
+                                   std::ostream* report) {
+    constexpr std::array PASSES = {"cold", "revisit"};
+    const std::vector<glm::ivec3> positions = worldPositions(options);
+    const TerrainGenerator generator(options.seed);
+    BiomeMap::CacheStats previous{};
+    nlohmann::json results = nlohmann::json::array();
+
+    for (const char* pass : PASSES) {
+        const auto start = Clock::now();
+        for (const glm::ivec3& position : positions) {
+            (void)generator.generate(position);
+        }
+        const double wallMs = elapsedMs(start);
+
+        const BiomeMap::CacheStats stats = generator.getBiomeMap().getCacheStats();
+        const size_t hits = stats.hits - previous.hits;
+        const size_t misses = stats.misses - previous.misses;
+        const double hitPercent =
+            hits + misses == 0 ? 0.0
+                               : 100.0 * static_cast<double>(hits) /
+                                     static_cast<double>(hits + misses);
+        previous = stats;
+        results.push_back({{"pass", pass},
+                           {"wall_ms", wallMs},
+                           {"chunks_per_s", static_cast<double>(positions.size()) * 1000.0 /
+                                                wallMs},
+                           {"hits", hits},
+                           {"misses", misses},
+                           {"hit_percent", hitPercent},
+                           {"resident_regions", stats.residentRegions}});
+        if (report != nullptr) {
+            *report << "\n[biome cache, " << pass << " pass]\n";
+        }
+        printRate(report, "chunks/s", static_cast<double>(positions.size()) * 1000.0 / wallMs,
+                  "");
+        printRate(report, "regions computed", static_cast<double>(misses), "");
+        printRate(report, "hit rate", hitPercent, "%");
+    }
+    return results;
+}
+
+// perlinNoise before the batched kernel, one sample at a time with the gradients' exact
+// angles, kept as the baseline the batched one is timed and checked against
+namespace reference {
+glm::vec2 randomGradient(int ix, int iy, unsigned int seed) {
+    unsigned int h = (ix * 374761393) + (iy * 668265263);
+    h ^= (seed * 0x27d4eb2d);
+    h = (h ^ (h >> 13)) * 1274126177;
+    const float angle = static_cast<float>(h & 0xFFFFFFU) / static_cast<float>(0xFFFFFFU) *
+                        2.0F * std::numbers::pi_v<float>;
+    return {std::cos(angle), std::sin(angle)};
+}
+
+float dotGridGradient(int ix, int iy, float x, float y, long int seed) {
+    const glm::vec2 gradient = randomGradient(ix, iy, seed);
+    return ((x - static_cast<float>(ix)) * gradient[0]) +
+           ((y - static_cast<float>(iy)) * gradient[1]);
+}
+
+float interpolate(float a0, float a1, float w) {
+    const float fade = w * w * w * (w * (w * 6 - 15) + 10);
+    return a0 + (fade * (a1 - a0));
+}
+
+float perlinValue(float x, float y, long int seed) {
+    const int x0 = static_cast<int>(std::floor(x));
+    const int y0 = static_cast<int>(std::floor(y));
+    const float sx = x - static_cast<float>(x0);
+    const float sy = y - static_cast<float>(y0);
+    const float ix0 = interpolate(dotGridGradient(x0, y0, x, y, seed),
+                                  dotGridGradient(x0 + 1, y0, x, y, seed), sx);
+    const float ix1 = interpolate(dotGridGradient(x0, y0 + 1, x, y, seed),
+                                  dotGridGradient(x0 + 1, y0 + 1, x, y, seed), sx);
+    return interpolate(ix0, ix1, sy);
+}
+
+std::vector<std::vector<float>> perlinNoise(int width, int height, float baseFrequency,
+                                            long int seed, int octaves, float persistence) {
+    std::vector<std::vector<float>> perlin(height, std::vector<float>(width));
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            float amplitude = 1.0F;
+            float frequency = baseFrequency;
+            float noiseValue = 0.0F;
+            float maxValue = 0.0F;
+            for (int o = 0; o < octaves; ++o) {
+                noiseValue += perlinValue(static_cast<float>(x) * frequency,
+                                          static_cast<float>(y) * frequency, seed) *
+                              amplitude;
+                maxValue += amplitude;
+                amplitude *= persistence;
+                frequency *= 2.0F;
+            }
+            perlin[y][x] = noiseValue / maxValue;
+        }
+    }
+    return perlin;
+}
+} // namespace reference
+
+// One heightmap the size of the box's top face per call, as a terrain generator would,
+// with the reference implementation and with perlinNoiseBatch
+nlohmann::json benchmarkPerlin(const WorldBenchmarkOptions& options, std::ostream* report) {
+    constexpr float BASE_FREQUENCY = 0.02F;
+    constexpr long int SEED = 42;
+    constexpr int OCTAVES = 4;
+    constexpr float PERSISTENCE = 0.5F;
+    const int size = options.worldSize * Chunk::CHUNK_SIZE;
+    const double samples = static_cast<double>(size) * size * options.iterations;
+
+    std::vector<double> referenceMs;
+    double checksum = 0.0; // Keeps the calls from being optimised out
+    auto start = Clock::now();
+    for (int i = 0; i < options.iterations; i++) {
+        const auto callStart = Clock::now();
+        const std::vector<std::vector<float>> noise =
+            reference::perlinNoise(size, size, BASE_FREQUENCY, SEED + i, OCTAVES, PERSISTENCE);
+        referenceMs.push_back(elapsedMs(callStart));
+        checksum += noise.at(0).at(0);
+    }
+    const double referenceWallMs = elapsedMs(start);
+
+    std::vector<float> batch(static_cast<size_t>(size) * size);
+    std::vector<double> batchMs;
+    start = Clock::now();
+    for (int i = 0; i < options.iterations; i++) {
+        const auto callStart = Clock::now();
+        perlinNoiseBatch(batch, 0, 0, size, size, BASE_FREQUENCY, SEED + i, OCTAVES,
+                         PERSISTENCE);
+        batchMs.push_back(elapsedMs(callStart));
+        checksum += batch.front();
+    }
+    const double batchWallMs = elapsedMs(start);
+
+    // Same seed through both, outside the timings
+    const std::vector<std::vector<float>> expected =
+        reference::perlinNoise(size, size, BASE_FREQUENCY, SEED, OCTAVES, PERSISTENCE);
+    perlinNoiseBatch(batch, 0, 0, size, size, BASE_FREQUENCY, SEED, OCTAVES, PERSISTENCE);
+    double maxError = 0.0;
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            const float value = batch.at((static_cast<size_t>(y) * size) + x);
+            maxError = std::max(maxError, static_cast<double>(std::abs(value - expected[y][x])));
+        }
+    }
+
+    const double referenceRate = samples * 1000.0 / referenceWallMs;
+    const double batchRate = samples * 1000.0 / batchWallMs;
+    nlohmann::json result = {{"width", size},
+                             {"height", size},
+                             {"octaves", OCTAVES},
+                             {"calls", options.iterations},
+                             {"backend", perlinNoiseBackend()},
+                             {"reference_samples_per_s", referenceRate},
+                             {"reference_call_ms", summarize(referenceMs)},
+                             {"samples_per_s", batchRate},
+                             {"call_ms", summarize(batchMs)},
+                             {"speedup", batchRate / referenceRate},
+                             {"max_abs_error", maxError},
+                             {"tolerance", PERLIN_BATCH_TOLERANCE},
+                             {"passed", maxError <= PERLIN_BATCH_TOLERANCE},
+                             {"checksum", checksum}};
+    if (report != nullptr) {
+        *report << "\n[perlinNoise " << size << "x" << size << ", " << OCTAVES
+                << " octaves, batched with " << perlinNoiseBackend() << "]\n";
+    }
+    printRate(report, "reference samples/s", referenceRate, "");
+    printRate(report, "batched samples/s", batchRate, "");
+    printRate(report, "speedup", batchRate / referenceRate, "x");
+    printPercentiles(report, "batched per call", result["call_ms"], "ms");
+    if (report != nullptr) {
+        *report << "  " << std::left << std::setw(28) << "max error vs reference" << std::right
+                << std::setw(14) << std::scientific << std::setprecision(2) << maxError
+                << " (tolerance " << PERLIN_BATCH_TOLERANCE << ")" << std::fixed << "\n";
+    }
+    return result;
+}
+
+// Snapshots on the calling thread, meshes as jobs, like VoxelRenderer::remeshChunks
+nlohmann::json benchmarkMeshing(const WorldBenchmarkOptions& options, const chunkMap& world,
+                                const BlockRegistry& registry, std::ostream* report) {
+    constexpr ChunkMesh::MeshingMode MODE = ChunkMesh::MeshingMode::Binary;
+    nlohmann::json results = nlohmann::json::array();
+
+    for (unsigned int threads : options.threadCounts) {
+        std::vector<double> chunkUs;
+        size_t quads = 0;
+        double bestMs = 0.0;
+        for (int iteration = 0; iteration < options.iterations; iteration++) {
+            const auto start = Clock::now();
+            std::vector<std::unique_ptr<ChunkSnapshot>> snapshots;
+            snapshots.reserve(world.size());
+            for (const auto& [position, chunk] : world) {
+                std::array<const Chunk*, 6> neighbors{};
+                for (size_t side = 0; side < NEIGHBOR_OFFSETS.size(); side++) {
+                    auto it = world.find(position + NEIGHBOR_OFFSETS.at(side));
+                    neighbors.at(side) = it != world.end() ? it->second.get() : nullptr;
+                }
+                snapshots.push_back(
+                    std::make_unique<ChunkSnapshot>(*chunk, 0, neighbors, std::array<int, 6>{}));
+            }
+
+            std::vector<std::vector<VoxelQuad>> meshes(snapshots.size());
+            std::vector<double> passUs(snapshots.size());
+            runParallel(snapshots.size(), threads, [&](size_t i) {
+                const auto chunkStart = Clock::now();
+                ChunkMesh::generateMesh(*snapshots.at(i), registry, meshes.at(i), MODE);
+                passUs.at(i) = elapsedUs(chunkStart);
+            });
+            const double passMs = elapsedMs(start);
+
+            if (iteration == 0 || passMs < bestMs) {
+                bestMs = passMs;
+            }
+            chunkUs.insert(chunkUs.end(), passUs.begin(), passUs.end());
+            quads = 0;
+            for (const std::vector<VoxelQuad>& mesh : meshes) {
+                quads += mesh.size();
+            }
+        }
+
+        const double chunksPerSecond = static_cast<double>(world.size()) * 1000.0 / bestMs;
+        const double quadsPerSecond = static_cast<double>(quads) * 1000.0 / bestMs;
+        nlohmann::json result = {{"threads", threads},
+                                 {"mesher", ChunkMesh::getMeshingModeName(MODE)},
+                                 {"chunks", world.size()},
+                                 {"quads", quads},
+                                 {"best_pass_ms", bestMs},
+                                 {"chunks_per_s", chunksPerSecond},
+                                 {"voxels_per_s", chunksPerSecond * Chunk::VOLUME},
+                                 {"quads_per_s", quadsPerSecond},
+                                 {"chunk_us", summarize(chunkUs)}};
+        if (report != nullptr) {
+            *report << "\n[meshing, " << ChunkMesh::getMeshingModeName(MODE) << ", " << threads
+                    << " thread(s), best of " << options.iterations << " passes]\n";
+        }
+        printRate(report, "chunks/s", chunksPerSecond, "");
+        printRate(report, "voxels/s", chunksPerSecond * Chunk::VOLUME, "");
+        printRate(report, "quads/s", quadsPerSecond, "");
+        printPercentiles(report, "per chunk", result["chunk_us"], "us");
+        results.push_back(result);
+    }
+    return results;
+}
+
+// Random positions inside the box (hits) and in the layer of chunks just around it
+// (misses, like the border lookups of the edge chunks)
+nlohmann::json benchmarkLookups(const WorldBenchmarkOptions& options, const chunkMap& world,
+                                std::ostream* report) {
+    std::mt19937 random(1234);
+    std::uniform_int_distribution<int> horizontal(0, options.worldSize - 1);
+    std::uniform_int_distribution<int> vertical(0, options.worldHeight - 1);
+    std::uniform_int_distribution<size_t> side(0, NEIGHBOR_OFFSETS.size() - 1);
+
+    std::vector<glm::ivec3> hits(LOOKUP_BATCH);
+    std::vector<glm::ivec3> misses(LOOKUP_BATCH);
+    for (size_t i = 0; i < LOOKUP_BATCH; i++) {
+        hits.at(i) = {horizontal(random), vertical(random), horizontal(random)};
+        // Pushed out of the box along one axis
+        glm::ivec3 miss = hits.at(i);
+        const glm::ivec3 offset = NEIGHBOR_OFFSETS.at(side(random));
+        const glm::ivec3 extent(options.worldSize, options.worldHeight, options.worldSize);
+        for (int axis = 0; axis < 3; axis++) {
+            if (offset[axis] > 0) {
+                miss[axis] = extent[axis];
+            } else if (offset[axis] < 0) {
+                miss[axis] = -1;
+            }
+        }
+        misses.at(i) = miss;
+    }
+
+    nlohmann::json results = nlohmann::json::array();
+    for (const auto& [kind, positions] :
+         {std::pair<std::string, const std::vector<glm::ivec3>*>{"hit", &hits},
+          std::pair<std::string, const std::vector<glm::ivec3>*>{"miss", &misses}}) {
+        std::vector<double> batchNs;
+        size_t found = 0;
+        const auto start = Clock::now();
+        const size_t batches = LOOKUP_BATCHES_PER_ITERATION * options.iterations;
+        for (size_t batch = 0; batch < batches; batch++) {
+            const auto batchStart = Clock::now();
+            for (const glm::ivec3& position : *positions) {
+                found += world.find(position) != world.end() ? 1 : 0;
+            }
+            batchNs.push_back(std::chrono::duration<double, std::nano>(Clock::now() - batchStart)
+                                  .count() /
+                              static_cast<double>(LOOKUP_BATCH));
+        }
+        const double wallMs = elapsedMs(start);
+
+        const double lookups = static_cast<double>(batches * LOOKUP_BATCH);
+        nlohmann::json result = {{"kind", kind},
+                                 {"map_size", world.size()},
+                                 {"lookups", batches * LOOKUP_BATCH},
+                                 {"found", found},
+                                 {"lookups_per_s", lookups * 1000.0 / wallMs},
+                                 {"lookup_ns", summarize(batchNs)}};
+        if (report != nullptr) {
+            *report << "\n[chunk map lookups, " << kind << "]\n";
+        }
+        printRate(report, "lookups/s", lookups * 1000.0 / wallMs, "");
+        printPercentiles(report, "per lookup (batch mean)", result["lookup_ns"], "ns");
+        results.push_back(result);
+    }
+    return results;
+}
+
+// 64-bit FNV-1a, byte by byte so the value is the same on every platform
+constexpr uint64_t FNV_OFFSET = 14695981039346656037ULL;
+constexpr uint64_t FNV_PRIME = 1099511628211ULL;
+
+uint64_t hashBytes(std::span<const uint8_t> bytes, uint64_t hash = FNV_OFFSET) {
+    for (uint8_t byte : bytes) {
+        hash = (hash ^ byte) * FNV_PRIME;
+    }
+    return hash;
+}
+
+// Little-endian bytes of each value, whatever the host's byte order
+template <typename T> uint64_t hashValue(T value, uint64_t hash) {
+    std::array<uint8_t, sizeof(T)> bytes{};
+    for (size_t i = 0; i < sizeof(T); i++) {
+        bytes.at(i) = static_cast<uint8_t>(static_cast<uint64_t>(value) >> (i * 8));
+    }
+    return hashBytes(bytes, hash);
+}
+
+uint64_t hashChunk(const Chunk& chunk) {
+    std::array<uint8_t, Chunk::VOLUME> blocks{};
+    chunk.copyBlocks(blocks);
+    return hashBytes(blocks);
+}
+
+std::string toHex(uint64_t value) {
+    std::ostringstream stream;
+    stream << "0x" << std::hex << std::setw(16) << std::setfill('0') << value;
+    return stream.str();
+}
+} // namespace
+
+nlohmann::json runWorldBenchmark(const BlockRegistry& registry,
+                                 const WorldBenchmarkOptions& options, std::ostream* report) {
+    const size_t chunkCount = static_cast<size_t>(options.worldSize) * options.worldSize *
+                              options.worldHeight;
+    if (report != nullptr) {
+        *report << "World benchmark: " << options.worldSize << "x" << options.worldHeight << "x"
+                << options.worldSize << " chunks (" << chunkCount << ")\n";
+    }
+
+    chunkMap world;
+    nlohmann::json results;
+    results["config"] = {{"world_size", options.worldSize},
+                         {"world_height", options.worldHeight},
+                         {"chunks", chunkCount},
+                         {"iterations", options.iterations},
+                         {"seed", options.seed},
+                         {"threads", options.threadCounts},
+                         {"hardware_threads", std::thread::hardware_concurrency()}};
+    results["chunk_generation"] = benchmarkGeneration(options, world, report);
+    results["density_lattice"] = benchmarkDensityLattice(options, report);
+    results["biome_cache"] = benchmarkBiomeCache(options, report);
+    results["perlin"] = benchmarkPerlin(options, report);
+    results["meshing"] = benchmarkMeshing(options, world, registry, report);
+    results["map_lookups"] = benchmarkLookups(options, world, report);
+    return results;
+}
+
+nlohmann::json runDeterminismCheck(const WorldBenchmarkOptions& options, std::ostream* report) {
+    // Centred on the origin and one layer below it, so negative coordinates are covered
+    std::vector<glm::ivec3> positions;
+    for (int y = -1; y < options.worldHeight - 1; y++) {
+        for (int z = -options.worldSize / 2; z < options.worldSize - (options.worldSize / 2);
+             z++) {
+            for (int x = -options.worldSize / 2; x < options.worldSize - (options.worldSize / 2);
+                 x++) {
+                positions.emplace_back(x, y, z);
+            }
+        }
+    }
+
+    // Reference: a fresh generator, in order, on this thread
+    std::vector<uint64_t> expected(positions.size());
+    {
+        const TerrainGenerator generator(options.seed);
+        for (size_t i = 0; i < positions.size(); i++) {
+            expected.at(i) = hashChunk(*generator.generate(positions.at(i)));
+        }
+    }
+    uint64_t worldHash = FNV_OFFSET;
+    for (size_t i = 0; i < positions.size(); i++) {
+        worldHash = hashValue(static_cast<uint32_t>(positions.at(i).x), worldHash);
+        worldHash = hashValue(static_cast<uint32_t>(positions.at(i).y), worldHash);
+        worldHash = hashValue(static_cast<uint32_t>(positions.at(i).z), worldHash);
+        worldHash = hashValue(expected.at(i), worldHash);
+    }
+    if (report != nullptr) {
+        *report << "[determinism, seed " << options.seed << ", " << positions.size()
+                << " chunks, noise " << perlinNoiseBackend() << "]\n";
+    }
+
+    // Then fresh generators again, shuffled across each thread count
+    bool passed = true;
+    nlohmann::json passes = nlohmann::json::array();
+    for (unsigned int threads : options.threadCounts) {
+        std::vector<size_t> order(positions.size());
+        for (size_t i = 0; i < order.size(); i++) {
+            order.at(i) = i;
+        }
+        std::mt19937 random(threads);
+        std::shuffle(order.begin(), order.end(), random);
+
+        const TerrainGenerator generator(options.seed);
+        std::vector<uint64_t> hashes(positions.size());
+        runParallel(order.size(), threads, [&](size_t i) {
+            const size_t index = order.at(i);
+            hashes.at(index) = hashChunk(*generator.generate(positions.at(index)));
+        });
+
+        size_t mismatches = 0;
+        for (size_t i = 0; i < positions.size(); i++) {
+            mismatches += hashes.at(i) != expected.at(i) ? 1 : 0;
+        }
+        passed = passed && mismatches == 0;
+        passes.push_back({{"threads", threads}, {"order", "shuffled"}, {"mismatches", mismatches}});
+        if (report != nullptr) {
+            *report << "  " << std::left << std::setw(28)
+                    << ("shuffled, " + std::to_string(threads) + " thread(s)") << std::right
+                    << std::setw(14) << mismatches << " mismatching chunk(s)\n";
+        }
+    }
+    if (report != nullptr) {
+        *report << "  " << std::left << std::setw(28) << "world hash" << std::right
+                << std::setw(14) << toHex(worldHash) << "\n";
+    }
+
+    return {{"seed", options.seed},
+            {"chunks", positions.size()},
+            {"noise_backend", perlinNoiseBackend()},
+            {"passes", passes},
+            {"passed", passed},
+            {"world_hash", toHex(worldHash)}};
+}
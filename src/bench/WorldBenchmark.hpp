@@ -0,0 +1,37 @@
+#pragma once
+
+#include <iosfwd>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "common/World/TerrainGenerator.hpp"
+
+class BlockRegistry;
+
+struct WorldBenchmarkOptions {
+    int worldSize = 8;   // Chunks along x and z
+    int worldHeight = 4; // Chunks along y
+    int iterations = 20; // Passes of the cheaper stages, generation runs once
+    std::vector<unsigned int> threadCounts = {1};
+    long int seed = TerrainGenerator::DEFAULT_SEED;
+};
+
+// Times the world pipeline without a window or GPU: TerrainGenerator (its density cell
+// sizes against the exact function, and its biome cache cold and revisited), perlinNoise
+// (the per-sample reference against perlinNoiseBatch, with the largest difference),
+// ChunkMesh::generateMesh (Binary, from snapshots like the renderer) and chunk map
+// lookups, over a worldSize x worldHeight x worldSize box of chunks and each of the
+// thread counts. Returns the results as JSON (throughputs, and percentiles of the per
+// chunk, per call or per lookup times, with "perlin"/"passed" false when the batch is
+// further than PERLIN_BATCH_TOLERANCE from the reference) and writes a readable summary
+// to `report` when given.
+nlohmann::json runWorldBenchmark(const BlockRegistry& registry,
+                                 const WorldBenchmarkOptions& options, std::ostream* report);
+
+// Regenerates a box of chunks around the origin, first in order on one thread, then
+// shuffled on each of the thread counts, every pass from a fresh generator, and compares
+// the 64-bit FNV-1a hashes of every chunk's blocks. Returns the results as JSON:
+// "passed" when every pass matched, and "world_hash", a hash of all the chunk hashes in
+// position order to compare across machines and builds.
+nlohmann::json runDeterminismCheck(const WorldBenchmarkOptions& options, std::ostream* report);
@@ -1,7 +1,12 @@
 #include "App.hpp"
 
+#include <array>
+#include <cmath>
 #include <iostream>
 #include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 #include <SDL3/SDL.h>
 #include <SDL3/SDL_events.h>
@@ -9,19 +14,28 @@
 #include "client/Game/Camera.hpp"
 #include "client/Graphics/Core/VulkanDevice.hpp"
 #include "client/Graphics/Renderer.hpp"
+#include "client/Graphics/Rendering/GpuProfiler.hpp"
+#include "client/Graphics/Rendering/UploadManager.hpp"
+#include "client/Graphics/Voxel/VoxelRenderer.hpp"
+#include "common/Util/Profiler.hpp"
+#include "common/World/BiomeMap.hpp"
 #include "common/World/BlockRegistry.hpp"
+#include "common/World/ChunkInstanciator.hpp"
+#include "common/World/ChunkRegion.hpp"
+#include "common/World/TerrainGenerator.hpp"
 #include "imgui.h"
 #include "imgui_impl_sdl3.h"
 #include "imgui_impl_vulkan.h"
 #include "InputManager.hpp"
 #include "Window.hpp"
 
-App::App() {
+App::App(long int worldSeed) {
     try {
         _blockRegistry = std::make_unique<BlockRegistry>();
         _window = std::make_unique<Window>(WIDTH, HEIGHT, WINDOW_TITLE);
         _vulkanDevice = std::make_unique<VulkanDevice>(_window->getSDLWindow());
-        _renderer = std::make_unique<Renderer>(*_window, *_vulkanDevice, *_blockRegistry);
+        _renderer =
+            std::make_unique<Renderer>(*_window, *_vulkanDevice, *_blockRegistry, worldSeed);
     } catch (const std::exception& e) {
         std::cerr << "Failed to create window: " << e.what() << "\n";
         throw;
@@ -94,13 +108,177 @@ void App::run() {
         ImGui::Separator();
         const glm::vec3 camPos = camera.getPosition();
         ImGui::Text("Camera Position: (%.1f, %.1f, %.1f)", camPos.x, camPos.y, camPos.z);
+
+        ImGui::Separator();
+        const ChunkInstanciator& chunks = _renderer->getChunkInstanciator();
+        const ChunkInstanciator::ResidencyStats& residency = chunks.getResidencyStats();
+        constexpr float MIB = 1024.0F * 1024.0F;
+        ImGui::Text("Resident Chunks: %zu (%.1f / %.0f MiB)", residency.residentChunks,
+                    static_cast<float>(residency.residentBytes) / MIB,
+                    static_cast<float>(residency.maxResidentBytes) / MIB);
+        ImGui::Text("Chunk Queue: %zu queued, %zu generating", chunks.getQueuedCount(),
+                    chunks.getInFlightCount());
+        ImGui::Text("Unloaded: %zu, Evicted: %zu", residency.unloadedChunks,
+                    residency.evictedChunks);
+        ImGui::Text("World Seed: %ld", chunks.getGenerator().getSeed());
+        const TerrainGenerator::GenerationStats generation = chunks.getGenerator().getStats();
+        const size_t sampledChunks =
+            generation.generatedChunks - generation.airChunks - generation.solidChunks;
+        ImGui::Text("Generated: %zu (%zu air, %zu solid skipped)", generation.generatedChunks,
+                    generation.airChunks, generation.solidChunks);
+        ImGui::Text("Density Samples: %.0f per sampled chunk",
+                    sampledChunks == 0 ? 0.0
+                                       : static_cast<double>(generation.densitySamples) /
+                                             static_cast<double>(sampledChunks));
+        const BiomeMap& biomes = chunks.getGenerator().getBiomeMap();
+        const BiomeMap::CacheStats biomeCache = biomes.getCacheStats();
+        const size_t biomeLookups = biomeCache.hits + biomeCache.misses;
+        ImGui::Text("Biome Cache: %zu / %zu regions, %.1f%% hits (%zu evicted)",
+                    biomeCache.residentRegions, biomeCache.capacity,
+                    biomeLookups == 0 ? 0.0
+                                      : 100.0 * static_cast<double>(biomeCache.hits) /
+                                            static_cast<double>(biomeLookups),
+                    biomeCache.evictions);
+        const BiomeMap::Column column = biomes.sampleColumn(
+            static_cast<int>(std::floor(camPos.x)), static_cast<int>(std::floor(camPos.z)));
+        ImGui::Text("Biome: %s (temperature %.2f, humidity %.2f, continentalness %.2f)",
+                    BiomeMap::getBiomeName(column.biome), column.temperature, column.humidity,
+                    column.continentalness);
+
+        ImGui::Separator();
+        VoxelRenderer& voxelRenderer = _renderer->getVoxelRenderer();
+        constexpr std::array MESHING_MODES = {ChunkMesh::MeshingMode::PerFace,
+                                              ChunkMesh::MeshingMode::Greedy,
+                                              ChunkMesh::MeshingMode::Binary};
+        ChunkMesh::MeshingMode currentMode = voxelRenderer.getMeshingMode();
+        if (ImGui::BeginCombo("Meshing", ChunkMesh::getMeshingModeName(currentMode))) {
+            for (ChunkMesh::MeshingMode mode : MESHING_MODES) {
+                if (ImGui::Selectable(ChunkMesh::getMeshingModeName(mode), mode == currentMode)) {
+                    _renderer->setMeshingMode(mode);
+                }
+            }
+            ImGui::EndCombo();
+        }
+        const VoxelRenderer::MeshStats& meshStats = voxelRenderer.getMeshStats();
+        ImGui::Text("Chunk Meshes: %zu (%zu quads)", meshStats.residentMeshes, meshStats.quads);
+        ImGui::Text("Per LOD: %zu x1, %zu x2, %zu x4", meshStats.meshesPerLevel.at(0),
+                    meshStats.meshesPerLevel.at(1), meshStats.meshesPerLevel.at(2));
+        ImGui::Text("Regions: %zu (%d^3 chunks each)", meshStats.residentRegions,
+                    ChunkRegion::SIZE);
+        const double chunksPerSecond =
+            meshStats.meshTimeMs > 0.0
+                ? static_cast<double>(meshStats.meshedChunks) * 1000.0 / meshStats.meshTimeMs
+                : 0.0;
+        ImGui::Text("Meshed: %zu chunks in %.1f ms (%.0f chunks/s)", meshStats.meshedChunks,
+                    meshStats.meshTimeMs, chunksPerSecond);
+        ImGui::Text("Uploaded: %.1f MiB", static_cast<float>(meshStats.uploadBytes) / MIB);
+        const VoxelRenderer::RemeshStats& remeshStats = voxelRenderer.getRemeshStats();
+        ImGui::Text("Last Remesh: %zu chunks in %.2f ms (%zu in place, %zu moved)",
+                    remeshStats.remeshedChunks, remeshStats.remeshTimeMs, remeshStats.inPlace,
+                    remeshStats.reallocated);
+        bool occlusionCulling = voxelRenderer.isOcclusionCullingEnabled();
+        if (ImGui::Checkbox("Occlusion Culling", &occlusionCulling)) {
+            voxelRenderer.setOcclusionCullingEnabled(occlusionCulling);
+        }
+        const VoxelRenderer::CullStats& cullStats = voxelRenderer.getCullStats();
+        ImGui::Text("Chunks Tested: %u", cullStats.tested);
+        ImGui::Text("Culled: %u frustum, %u occluded", cullStats.frustumCulled,
+                    cullStats.occlusionCulled);
+        ImGui::Text("Draws: %u (%u early, %u late)", cullStats.drawnEarly + cullStats.drawnLate,
+                    cullStats.drawnEarly, cullStats.drawnLate);
+        ImGui::Text("Back-facing Ranges Skipped: %u", cullStats.backFacingSkipped);
+
+        ImGui::Separator();
+        bool compaction = voxelRenderer.isCompactionEnabled();
+        if (ImGui::Checkbox("Compact Mesh Pool", &compaction)) {
+            voxelRenderer.setCompactionEnabled(compaction);
+        }
+        const MeshBufferPool::Stats poolStats = voxelRenderer.getMeshPoolStats();
+        constexpr float QUADS_TO_MIB = sizeof(VoxelQuad) / MIB;
+        const RangeAllocator::Stats& quadRanges = poolStats.quads;
+        ImGui::Text("Quad Pool: %.1f / %.0f MiB, %zu free blocks, %.0f%% fragmented",
+                    static_cast<float>(quadRanges.usedUnits) * QUADS_TO_MIB,
+                    static_cast<float>(quadRanges.capacity) * QUADS_TO_MIB, quadRanges.freeBlocks,
+                    quadRanges.fragmentation() * 100.0F);
+        ImGui::Text("Relocated: %zu ranges, %.1f MiB", poolStats.relocatedMeshes,
+                    static_cast<float>(poolStats.relocatedBytes) / MIB);
+
+        ImGui::Separator();
+        const UploadManager::Stats& uploads = _renderer->getUploadManager().getStats();
+        ImGui::Text("Uploads: %.1f KiB/frame in %zu copies (%.1f KiB overflow)",
+                    static_cast<float>(uploads.bytesLastFlush) / 1024.0F, uploads.copiesLastFlush,
+                    static_cast<float>(uploads.overflowBytesLastFlush) / 1024.0F);
+        ImGui::Text("Upload Latency: %.2f ms (avg %.2f ms)", uploads.lastLatencyMs,
+                    uploads.averageLatencyMs);
+        ImGui::Text("Transfer Queue: %s (%zu ownership transfers)",
+                    uploads.dedicatedTransferQueue ? "dedicated" : "shared with graphics",
+                    uploads.ownershipTransfersLastFlush);
+        ImGui::Text("Staging Ring: %.1f / %.0f MiB", static_cast<float>(uploads.stagingUsed) / MIB,
+                    static_cast<float>(uploads.stagingCapacity) / MIB);
         ImGui::End();
 
+        drawProfilerWindow();
+
         ImGui::Render();
 
         // Update FPS counter
         _renderer->updateFPS(deltaTime);
 
         _renderer->draw();
+        Profiler::endFrame();
+    }
+}
+
+void App::drawProfilerWindow() {
+    ImGui::Begin("Profiler", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
+    bool enabled = Profiler::isEnabled();
+    if (ImGui::Checkbox("Record Scopes", &enabled)) {
+        Profiler::setEnabled(enabled);
+    }
+    if (!_renderer->getGpuProfiler().isSupported()) {
+        ImGui::TextUnformatted("GPU timestamps not supported by the graphics queue");
+    }
+
+    // 0 to 33 ms: a 30 FPS frame fills the graph
+    constexpr float GRAPH_MAX_MS = 33.3F;
+    const Profiler::History history = Profiler::getHistory();
+    if (!history.cpuMs.empty()) {
+        ImGui::PlotLines("CPU (ms)", history.cpuMs.data(), static_cast<int>(history.cpuMs.size()),
+                         0, nullptr, 0.0F, GRAPH_MAX_MS, ImVec2(0.0F, 60.0F));
+        ImGui::PlotLines("GPU (ms)", history.gpuMs.data(), static_cast<int>(history.gpuMs.size()),
+                         0, nullptr, 0.0F, GRAPH_MAX_MS, ImVec2(0.0F, 60.0F));
+    }
+
+    // Worker scopes add up across threads, GPU ones are a few frames old
+    const std::vector<Profiler::ScopeTotal> scopes = Profiler::getLastFrame();
+    if (!scopes.empty() &&
+        ImGui::BeginTable("Scopes", 3, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV)) {
+        ImGui::TableSetupColumn("Scope");
+        ImGui::TableSetupColumn("ms");
+        ImGui::TableSetupColumn("Calls");
+        ImGui::TableHeadersRow();
+        for (const Profiler::ScopeTotal& scope : scopes) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::Text("%s%s", scope.gpu ? "[GPU] " : "", scope.name);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", scope.ms);
+            ImGui::TableNextColumn();
+            ImGui::Text("%u", scope.calls);
+        }
+        ImGui::EndTable();
+    }
+
+    if (ImGui::Button("Export Chrome Trace")) {
+        try {
+            const size_t events = Profiler::writeChromeTrace(TRACE_FILE);
+            _traceStatus = "Wrote " + std::to_string(events) + " events to " + TRACE_FILE;
+        } catch (const std::runtime_error& e) {
+            _traceStatus = e.what();
+        }
+    }
+    if (!_traceStatus.empty()) {
+        ImGui::TextUnformatted(_traceStatus.c_str());
     }
+    ImGui::End();
 }
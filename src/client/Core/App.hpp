@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <string>
 
 class Window;
 class VulkanDevice;
@@ -9,7 +10,7 @@ class BlockRegistry;
 
 class App {
   public:
-    App();
+    explicit App(long int worldSeed);
     ~App();
 
     App(const App&) = delete;
@@ -20,12 +21,18 @@ class App {
     static constexpr int WIDTH = 800;
     static constexpr int HEIGHT = 600;
     static constexpr const char* WINDOW_TITLE = "Vulkan App";
+    // Written to the working directory by the profiler window's export button
+    static constexpr const char* TRACE_FILE = "ft_vox_trace.json";
 
     void run();
 
   private:
+    // Frame time graphs, last frame's scopes and the Chrome trace export
+    void drawProfilerWindow();
+
     std::unique_ptr<BlockRegistry> _blockRegistry;
     std::unique_ptr<Window> _window;
     std::unique_ptr<VulkanDevice> _vulkanDevice;
     std::unique_ptr<Renderer> _renderer;
+    std::string _traceStatus; // Result of the last trace export
 };
@@ -9,7 +9,7 @@
 
 VulkanDevice::VulkanDevice(SDL_Window* window)
     : _instance(nullptr), _debugMessenger(nullptr), _surface(nullptr), _physicalDevice(nullptr),
-      _device(nullptr), _graphicsQueue(nullptr) {
+      _device(nullptr), _graphicsQueue(nullptr), _transferQueue(nullptr) {
 
     vkb::InstanceBuilder instanceBuilder;
     auto instRet = instanceBuilder.set_app_name("ft_vox")
@@ -37,7 +37,10 @@ VulkanDevice::VulkanDevice(SDL_Window* window)
 
     VkPhysicalDeviceVulkan12Features features12{
         .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+        .drawIndirectCount = VK_TRUE,
         .descriptorIndexing = VK_TRUE,
+        .samplerFilterMinmax = VK_TRUE,
+        .timelineSemaphore = VK_TRUE,
         .bufferDeviceAddress = VK_TRUE};
 
     VkPhysicalDeviceVulkan11Features features11{
@@ -89,6 +92,18 @@ VulkanDevice::VulkanDevice(SDL_Window* window)
     }
     _graphicsQueueFamily = queueFamilyRet.value();
 
+    // A transfer-only family lets uploads run alongside rendering (DMA engines on
+    // discrete GPUs). vk-bootstrap creates one queue per family, so it is already there.
+    auto transferQueueRet = vkbDevice.get_dedicated_queue(vkb::QueueType::transfer);
+    auto transferFamilyRet = vkbDevice.get_dedicated_queue_index(vkb::QueueType::transfer);
+    if (transferQueueRet && transferFamilyRet) {
+        _transferQueue = transferQueueRet.value();
+        _transferQueueFamily = transferFamilyRet.value();
+    } else {
+        _transferQueue = _graphicsQueue;
+        _transferQueueFamily = _graphicsQueueFamily;
+    }
+
     VmaAllocatorCreateInfo allocatorInfo = {.flags = VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT,
                                             .physicalDevice = _physicalDevice,
                                             .device = _device,
@@ -22,6 +22,12 @@ class VulkanDevice {
     [[nodiscard]] VkDevice getDevice() const { return _device; }
     [[nodiscard]] VkQueue getQueue() const { return _graphicsQueue; }
     [[nodiscard]] uint32_t getGraphicsQueueFamily() const { return _graphicsQueueFamily; }
+    // Dedicated transfer queue when the device has one, the graphics queue otherwise
+    [[nodiscard]] VkQueue getTransferQueue() const { return _transferQueue; }
+    [[nodiscard]] uint32_t getTransferQueueFamily() const { return _transferQueueFamily; }
+    [[nodiscard]] bool hasDedicatedTransferQueue() const {
+        return _transferQueueFamily != _graphicsQueueFamily;
+    }
     [[nodiscard]] VmaAllocator getAllocator() const { return _allocator; }
 
   private:
@@ -32,5 +38,7 @@ class VulkanDevice {
     VkDevice _device;
     VkQueue _graphicsQueue;
     uint32_t _graphicsQueueFamily;
+    VkQueue _transferQueue;
+    uint32_t _transferQueueFamily;
     VmaAllocator _allocator;
 };
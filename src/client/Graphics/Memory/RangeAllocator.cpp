@@ -0,0 +1,138 @@
+#include "RangeAllocator.hpp"
+
+#include <bit>
+#include <stdexcept>
+
+RangeAllocator::RangeAllocator(uint32_t capacity) : _capacity(capacity) {
+    reset();
+}
+
+size_t RangeAllocator::sizeClass(uint32_t size) {
+    return static_cast<size_t>(std::bit_width(size) - 1); // floor(log2(size))
+}
+
+void RangeAllocator::insertFreeBlock(uint32_t offset, uint32_t size) {
+    const size_t sizeClassIndex = sizeClass(size);
+    _freeLists.at(sizeClassIndex).emplace(size, offset);
+    _nonEmptyClasses |= 1U << sizeClassIndex;
+    _freeByOffset.emplace(offset, size);
+}
+
+void RangeAllocator::eraseFreeBlock(uint32_t offset, uint32_t size) {
+    const size_t sizeClassIndex = sizeClass(size);
+    auto& freeList = _freeLists.at(sizeClassIndex);
+    freeList.erase({size, offset});
+    if (freeList.empty()) {
+        _nonEmptyClasses &= ~(1U << sizeClassIndex);
+    }
+    _freeByOffset.erase(offset);
+}
+
+uint32_t RangeAllocator::splitFreeBlock(uint32_t offset, uint32_t blockSize, uint32_t size) {
+    eraseFreeBlock(offset, blockSize);
+    if (blockSize > size) {
+        insertFreeBlock(offset + size, blockSize - size);
+    }
+    _allocations.emplace(offset, size);
+    _usedUnits += size;
+    return offset;
+}
+
+std::optional<uint32_t> RangeAllocator::allocate(uint32_t size) {
+    if (size == 0) {
+        throw std::runtime_error("RangeAllocator: zero-sized allocation");
+    }
+
+    // Best fit inside the block's own class, where sizes may still be too small
+    const size_t sizeClassIndex = sizeClass(size);
+    const auto& sameClass = _freeLists.at(sizeClassIndex);
+    auto fit = sameClass.lower_bound({size, 0});
+    if (fit != sameClass.end()) {
+        return splitFreeBlock(fit->second, fit->first, size);
+    }
+
+    // Any block of a larger class fits: take the smallest of the first non-empty one
+    if (sizeClassIndex + 1 >= SIZE_CLASSES) {
+        return std::nullopt;
+    }
+    const uint32_t largerClasses = _nonEmptyClasses & ~((2U << sizeClassIndex) - 1);
+    if (largerClasses == 0) {
+        return std::nullopt;
+    }
+    const auto& freeList = _freeLists.at(static_cast<size_t>(std::countr_zero(largerClasses)));
+    auto smallest = freeList.begin();
+    return splitFreeBlock(smallest->second, smallest->first, size);
+}
+
+std::optional<uint32_t> RangeAllocator::allocateBelow(uint32_t size, uint32_t limit) {
+    if (size == 0) {
+        throw std::runtime_error("RangeAllocator: zero-sized allocation");
+    }
+    for (const auto& [offset, blockSize] : _freeByOffset) {
+        if (static_cast<uint64_t>(offset) + size > limit) {
+            break; // Sorted by offset, nothing further down can end before the limit
+        }
+        if (blockSize >= size) {
+            return splitFreeBlock(offset, blockSize, size);
+        }
+    }
+    return std::nullopt;
+}
+
+void RangeAllocator::free(uint32_t offset) {
+    auto allocation = _allocations.find(offset);
+    if (allocation == _allocations.end()) {
+        throw std::runtime_error("RangeAllocator: freeing an unknown range");
+    }
+    uint32_t start = offset;
+    uint32_t size = allocation->second;
+    _allocations.erase(allocation);
+    _usedUnits -= size;
+
+    // Merge with the free block right after, then the one right before
+    auto next = _freeByOffset.find(start + size);
+    if (next != _freeByOffset.end()) {
+        const uint32_t nextSize = next->second;
+        eraseFreeBlock(next->first, nextSize);
+        size += nextSize;
+    }
+    auto previous = _freeByOffset.lower_bound(start);
+    if (previous != _freeByOffset.begin()) {
+        --previous;
+        if (previous->first + previous->second == start) {
+            start = previous->first;
+            const uint32_t previousSize = previous->second;
+            eraseFreeBlock(start, previousSize);
+            size += previousSize;
+        }
+    }
+    insertFreeBlock(start, size);
+}
+
+void RangeAllocator::reset() {
+    for (auto& freeList : _freeLists) {
+        freeList.clear();
+    }
+    _nonEmptyClasses = 0;
+    _freeByOffset.clear();
+    _allocations.clear();
+    _usedUnits = 0;
+    if (_capacity > 0) {
+        insertFreeBlock(0, _capacity);
+    }
+}
+
+RangeAllocator::Stats RangeAllocator::getStats() const {
+    Stats stats;
+    stats.capacity = _capacity;
+    stats.usedUnits = _usedUnits;
+    stats.freeUnits = _capacity - _usedUnits;
+    stats.freeBlocks = _freeByOffset.size();
+    stats.allocations = _allocations.size();
+    if (_nonEmptyClasses != 0) {
+        // The largest block sits at the end of the highest non-empty class
+        const auto highestClass = static_cast<size_t>(std::bit_width(_nonEmptyClasses) - 1);
+        stats.largestFreeBlock = _freeLists.at(highestClass).rbegin()->first;
+    }
+    return stats;
+}
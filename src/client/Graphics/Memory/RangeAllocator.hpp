@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <set>
+#include <utility>
+
+// Offset allocator for carving ranges out of one big buffer.
+// Free blocks are kept in segregated lists, one per power-of-two size class, with a
+// bitmask of non-empty classes so finding a fit is a bit scan plus one set lookup
+// (a single-level TLSF). Freed blocks coalesce with free neighbours immediately.
+// Offsets and sizes are in caller-defined units (MeshBufferPool uses uint32 elements).
+class RangeAllocator {
+  public:
+    static constexpr size_t SIZE_CLASSES = 32;
+
+    struct Stats {
+        uint64_t capacity = 0;
+        uint64_t usedUnits = 0;
+        uint64_t freeUnits = 0;
+        uint64_t largestFreeBlock = 0;
+        size_t freeBlocks = 0;
+        size_t allocations = 0;
+
+        // 0 when all free space is one block, approaching 1 as it splinters
+        [[nodiscard]] float fragmentation() const {
+            if (freeUnits == 0) {
+                return 0.0F;
+            }
+            return 1.0F -
+                   (static_cast<float>(largestFreeBlock) / static_cast<float>(freeUnits));
+        }
+    };
+
+    explicit RangeAllocator(uint32_t capacity);
+    ~RangeAllocator() = default;
+
+    RangeAllocator(const RangeAllocator&) = delete;
+    RangeAllocator& operator=(const RangeAllocator&) = delete;
+    RangeAllocator(RangeAllocator&&) = default;
+    RangeAllocator& operator=(RangeAllocator&&) = default;
+
+    // Returns the offset of a free range of `size` units, or nullopt when none fits
+    std::optional<uint32_t> allocate(uint32_t size);
+    // First fit that ends at or before `limit`, used to slide live ranges down
+    std::optional<uint32_t> allocateBelow(uint32_t size, uint32_t limit);
+    // Releases a range returned by allocate (throws on an unknown offset)
+    void free(uint32_t offset);
+    // Forgets every allocation
+    void reset();
+
+    [[nodiscard]] Stats getStats() const;
+
+  private:
+    static size_t sizeClass(uint32_t size);
+
+    void insertFreeBlock(uint32_t offset, uint32_t size);
+    void eraseFreeBlock(uint32_t offset, uint32_t size);
+    // Takes `size` units at the front of a free block, returning the rest to the lists
+    uint32_t splitFreeBlock(uint32_t offset, uint32_t blockSize, uint32_t size);
+
+    uint32_t _capacity = 0;
+    uint64_t _usedUnits = 0;
+
+    // Free blocks by size class, each ordered by (size, offset) for a best fit
+    std::array<std::set<std::pair<uint32_t, uint32_t>>, SIZE_CLASSES> _freeLists;
+    uint32_t _nonEmptyClasses = 0;
+    // The same free blocks by offset, to find neighbours when coalescing
+    std::map<uint32_t, uint32_t> _freeByOffset;
+    // Live allocations, offset -> size
+    std::map<uint32_t, uint32_t> _allocations;
+};
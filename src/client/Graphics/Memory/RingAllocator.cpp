@@ -0,0 +1,27 @@
+#include "RingAllocator.hpp"
+
+#include <algorithm>
+
+std::optional<uint64_t> RingAllocator::allocate(uint64_t size, uint64_t alignment) {
+    if (size == 0 || size > _capacity) {
+        return std::nullopt;
+    }
+
+    uint64_t offset = _head % _capacity;
+    uint64_t padding = ((offset + alignment - 1) / alignment * alignment) - offset;
+    if (offset + padding + size > _capacity) {
+        padding = _capacity - offset; // Skip the end, start again at offset 0
+    }
+    if (getUsed() + padding + size > _capacity) {
+        return std::nullopt;
+    }
+
+    _head += padding;
+    offset = _head % _capacity;
+    _head += size;
+    return offset;
+}
+
+void RingAllocator::release(uint64_t mark) {
+    _tail = std::clamp(mark, _tail, _head);
+}
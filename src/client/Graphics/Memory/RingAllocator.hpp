@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+// FIFO sub-allocator over a fixed-size ring (a persistent staging buffer).
+// Space is handed out in order and given back in the same order: callers remember
+// getHead() after a group of allocations and release up to that mark once the GPU
+// is done with the group. Positions are monotonic 64-bit byte counts, so there is
+// no full/empty ambiguity when head and tail meet.
+class RingAllocator {
+  public:
+    explicit RingAllocator(uint64_t capacity) : _capacity(capacity) {}
+    ~RingAllocator() = default;
+
+    RingAllocator(const RingAllocator&) = delete;
+    RingAllocator& operator=(const RingAllocator&) = delete;
+    RingAllocator(RingAllocator&&) = default;
+    RingAllocator& operator=(RingAllocator&&) = default;
+
+    // Returns the byte offset inside the ring, or nullopt when there is not enough
+    // free space. An allocation never wraps: the end of the ring is skipped instead.
+    std::optional<uint64_t> allocate(uint64_t size, uint64_t alignment);
+    // Frees everything allocated before `mark` (a value previously returned by getHead)
+    void release(uint64_t mark);
+
+    [[nodiscard]] uint64_t getHead() const { return _head; }
+    [[nodiscard]] uint64_t getCapacity() const { return _capacity; }
+    [[nodiscard]] uint64_t getUsed() const { return _head - _tail; }
+
+  private:
+    uint64_t _capacity = 0;
+    uint64_t _head = 0; // Total bytes ever allocated, padding included
+    uint64_t _tail = 0; // Total bytes ever released
+};
@@ -1,14 +1,18 @@
 #include "Renderer.hpp"
 
+#include <algorithm>
 #include <iostream>
 #include <memory>
+#include <thread>
+#include <vector>
 
 #include <SDL3/SDL.h>
 #include <vulkan/vulkan.h>
 
 #include "../Core/Window.hpp"
 #include "../Game/Camera.hpp"
-#include "common/World/Chunk.hpp"
+#include "common/Util/Profiler.hpp"
+#include "common/World/ChunkInstanciator.hpp"
 #include "Core/VulkanBuffer.hpp"
 #include "Core/VulkanDevice.hpp"
 #include "Core/VulkanSwapchain.hpp"
@@ -17,20 +21,37 @@
 #include "imgui_impl_vulkan.h"
 #include "Rendering/CommandExecutor.hpp"
 #include "Rendering/FrameManager.hpp"
+#include "Rendering/GpuProfiler.hpp"
 #include "Rendering/RenderContext.hpp"
+#include "Rendering/UploadManager.hpp"
 #include "Voxel/MeshManager.hpp"
 #include "Voxel/VoxelRenderer.hpp"
 
-// tmp ChunkInstanciator
-
-ChunkInstanciator* chunkInstanciator = nullptr;
+namespace {
+struct WorkerSplit {
+    unsigned int generation;
+    unsigned int meshing;
+};
+
+// The render thread keeps a core (it also helps with meshing while it waits); chunk
+// generation and meshing share the others instead of each pool starting one worker per
+// core, which would run twice as many busy threads as there are cores
+WorkerSplit splitWorkerThreads() {
+    const unsigned int hardwareThreads = std::max(2U, std::thread::hardware_concurrency());
+    const unsigned int workers = hardwareThreads - 1;
+    const unsigned int generation = std::max(1U, workers / 2);
+    return {.generation = generation, .meshing = std::max(1U, workers - generation)};
+}
+} // namespace
 
-Renderer::Renderer(Window& window, VulkanDevice& device, BlockRegistry& registry)
+Renderer::Renderer(Window& window, VulkanDevice& device, BlockRegistry& registry,
+                   long int worldSeed)
     : _window(window), _device(device), _blockRegistry(registry) {
     try {
         _swapchain = std::make_unique<VulkanSwapchain>(window, device);
         _bufferManager = std::make_unique<VulkanBuffer>(device);
-        _meshManager = std::make_unique<MeshManager>(device, *_bufferManager);
+        _uploadManager = std::make_unique<UploadManager>(device, *_bufferManager);
+        _meshManager = std::make_unique<MeshManager>(device, *_bufferManager, *_uploadManager);
     } catch (const std::runtime_error& e) {
         std::cerr << "Failed to create VulkanSwapchain: " << e.what() << "\n";
         throw;
@@ -74,7 +95,8 @@ Renderer::Renderer(Window& window, VulkanDevice& device, BlockRegistry& registry
 
     std::vector<DescriptorAllocatorGrowable::PoolSizeRatio> sizes = {
         {.type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, .ratio = 1.0F},
-        {.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, .ratio = 1.0F}};
+        {.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, .ratio = 1.0F},
+        {.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, .ratio = 1.0F}};
 
     _globalDescriptorAllocator.init(_device.getDevice(), 10, sizes);
     _mainDeletionQueue.push(
@@ -84,12 +106,13 @@ Renderer::Renderer(Window& window, VulkanDevice& device, BlockRegistry& registry
     _camera = std::make_unique<Camera>(glm::vec3(30.0F, 70.0F, 30.0F), -135.0F, -20.0F);
 
     // Initialize voxel renderer
-    _voxelRenderer = std::make_unique<VoxelRenderer>(device, *_meshManager, registry,
-                                                     *_renderContext, *_commandExecutor,
-                                                     *_bufferManager, _globalDescriptorAllocator);
+    const WorkerSplit workers = splitWorkerThreads();
+    _voxelRenderer = std::make_unique<VoxelRenderer>(
+        device, *_meshManager, registry, *_renderContext, *_commandExecutor, *_bufferManager,
+        *_uploadManager, _globalDescriptorAllocator, workers.meshing);
     _voxelRenderer->initPipelines();
-    _voxelRenderer->initTestChunk();
-    chunkInstanciator = new ChunkInstanciator();
+    _chunkInstanciator = std::make_unique<ChunkInstanciator>(worldSeed, workers.generation);
+    _gpuProfiler = std::make_unique<GpuProfiler>(device);
 
     // Initialize ImGui - must be last after all Vulkan resources are ready
     initImGui();
@@ -99,9 +122,15 @@ Renderer::~Renderer() {
     vkDeviceWaitIdle(_device.getDevice());
 
     _mainDeletionQueue.flush();
+    // Pending frame deletions may point into the voxel renderer's mesh pool
+    _frameManager->flushDeletionQueues();
     // Destroy managed objects first (in reverse order of creation)
     // This ensures their internal deletion queues are flushed before the main queue
+    _gpuProfiler.reset();
+    _chunkInstanciator.reset();
     _voxelRenderer.reset();
+    _meshManager.reset();
+    _uploadManager.reset();
     _commandExecutor.reset();
     _renderContext.reset();
     _frameManager.reset();
@@ -113,12 +142,17 @@ void Renderer::draw() {
     auto& currentFrame = _frameManager->getCurrentFrame();
 
     // Wait for the previous frame to finish
-    VkResult ret = vkWaitForFences(_device.getDevice(), 1, &currentFrame._renderFence, VK_TRUE,
-                                   VULKAN_TIMEOUT_NS);
+    VkResult ret = VK_SUCCESS;
+    {
+        const Profiler::Scope scope("Wait for frame fence");
+        ret = vkWaitForFences(_device.getDevice(), 1, &currentFrame._renderFence, VK_TRUE,
+                              VULKAN_TIMEOUT_NS);
+    }
     checkVkResult(ret, "Failed to wait for fence");
 
     currentFrame._deletionQueue.flush();
     currentFrame._frameDescriptors.clearPools(_device.getDevice());
+    _uploadManager->collectCompleted();
 
     ret = vkResetFences(_device.getDevice(), 1, &currentFrame._renderFence);
     checkVkResult(ret, "Failed to reset fence");
@@ -127,9 +161,12 @@ void Renderer::draw() {
     uint32_t swapchainImageIndex = 0;
     auto semaphoreIndex =
         static_cast<uint32_t>(_frameManager->getFrameNumber() % _swapchainSemaphores.size());
-    ret =
-        vkAcquireNextImageKHR(_device.getDevice(), _swapchain->getSwapchain(), VULKAN_TIMEOUT_NS,
-                              _swapchainSemaphores[semaphoreIndex], nullptr, &swapchainImageIndex);
+    {
+        const Profiler::Scope scope("Acquire swapchain image");
+        ret = vkAcquireNextImageKHR(_device.getDevice(), _swapchain->getSwapchain(),
+                                    VULKAN_TIMEOUT_NS, _swapchainSemaphores[semaphoreIndex],
+                                    nullptr, &swapchainImageIndex);
+    }
     checkVkResult(ret, "Failed to acquire next image");
 
     // Reset and begin command buffer
@@ -144,6 +181,8 @@ void Renderer::draw() {
 
     ret = vkBeginCommandBuffer(commandBuffer, &cmdBeginInfo);
     checkVkResult(ret, "Failed to begin command buffer");
+    // This frame's fence has signalled: its timestamps from FRAME_OVERLAP frames ago are in
+    _gpuProfiler->beginFrame(commandBuffer, _frameManager->getFrameNumber());
 
     // Get images from RenderContext
     const RenderContext::AllocatedImage& drawImage = _renderContext->getDrawImage();
@@ -153,21 +192,54 @@ void Renderer::draw() {
     _commandExecutor->transitionImage(commandBuffer, drawImage.image, VK_IMAGE_LAYOUT_UNDEFINED,
                                       VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
 
-    // Transition depth image to DEPTH_ATTACHMENT_OPTIMAL
-    static bool firstFrame = true;
-    if (firstFrame) {
-        _commandExecutor->transitionImage(commandBuffer, depthImage.image,
-                                          VK_IMAGE_LAYOUT_UNDEFINED,
-                                          VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL);
-        firstFrame = false;
+    // Transition depth image to DEPTH_ATTACHMENT_OPTIMAL. Every frame: it is cleared
+    // anyway, and the depth pyramid build moves it through other layouts.
+    _commandExecutor->transitionImage(commandBuffer, depthImage.image, VK_IMAGE_LAYOUT_UNDEFINED,
+                                      VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL);
+    // Queue missing chunks around the camera, then integrate what the workers finished
+    const glm::vec3 cameraPos = _camera->getPosition();
+    {
+        const Profiler::Scope scope("Chunk streaming");
+        _chunkInstanciator->updateChunksAroundPlayer(cameraPos.x, cameraPos.y, cameraPos.z,
+                                                     CHUNK_LOAD_DISTANCE, CHUNK_UNLOAD_DISTANCE);
+        _chunkInstanciator->processGeneratedChunks(CHUNK_STREAMING_BUDGET);
+    }
+    // Chunks that crossed a level-of-detail ring are rebuilt at their new level, far ones
+    // are merged into regions and near regions split back into chunks
+    std::vector<glm::ivec3> lodChanges =
+        _voxelRenderer->updateLodCenter(cameraPos, currentFrame._deletionQueue);
+    if (!lodChanges.empty()) {
+        _chunkInstanciator->requestRemesh(lodChanges);
     }
-    // ici
 
-    chunkInstanciator->updateChunksAroundPlayer(_camera->getPosition().x, _camera->getPosition().y,
-                                                _camera->getPosition().z, 12);
+    // Drop the meshes of unloaded chunks, then mesh new and edited ones, nearest first
+    std::vector<glm::ivec3> unloaded = _chunkInstanciator->takeUnloadedChunks();
+    if (!unloaded.empty()) {
+        _voxelRenderer->releaseChunkMeshes(unloaded, currentFrame._deletionQueue);
+    }
+    // Also rebuilds a few dirty regions, even when no chunk is queued
+    std::vector<glm::ivec3> remeshQueue =
+        _chunkInstanciator->takeRemeshQueue(MAX_REMESHES_PER_FRAME);
+    {
+        const Profiler::Scope scope("Meshing");
+        _voxelRenderer->remeshChunks(*_chunkInstanciator, remeshQueue,
+                                     currentFrame._deletionQueue);
+    }
+    {
+        const Profiler::Scope scope("Upload");
+        _voxelRenderer->compactMeshPool(currentFrame._deletionQueue);
+        _voxelRenderer->uploadDrawCandidates();
+        // One transfer submission for every mesh write of this frame, ahead of the draw
+        _uploadManager->flush();
+        const GpuProfiler::Scope gpuScope(*_gpuProfiler, commandBuffer, "Upload copies");
+        _uploadManager->recordGraphicsCommands(commandBuffer);
+    }
 
     // Render voxel geometry using VoxelRenderer
-    _voxelRenderer->drawVoxels(commandBuffer, *_camera, _wireframeMode);
+    {
+        const Profiler::Scope scope("Record voxel draws");
+        _voxelRenderer->drawVoxels(commandBuffer, *_camera, _wireframeMode, *_gpuProfiler);
+    }
 
     // Transition draw image to TRANSFER_SRC for copying to swapchain
     _commandExecutor->transitionImage(commandBuffer, drawImage.image,
@@ -175,12 +247,16 @@ void Renderer::draw() {
                                       VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
 
     VkImage swapchainImage = _swapchain->getSwapchainImages().at(swapchainImageIndex);
-    _commandExecutor->transitionImage(commandBuffer, swapchainImage, VK_IMAGE_LAYOUT_UNDEFINED,
-                                      VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    {
+        const GpuProfiler::Scope gpuScope(*_gpuProfiler, commandBuffer, "Blit to swapchain");
+        _commandExecutor->transitionImage(commandBuffer, swapchainImage,
+                                          VK_IMAGE_LAYOUT_UNDEFINED,
+                                          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
 
-    _commandExecutor->copyImageToImage(commandBuffer, drawImage.image, swapchainImage,
-                                       {drawImage.extent.width, drawImage.extent.height},
-                                       _swapchain->getSwapchainExtent());
+        _commandExecutor->copyImageToImage(commandBuffer, drawImage.image, swapchainImage,
+                                           {drawImage.extent.width, drawImage.extent.height},
+                                           _swapchain->getSwapchainExtent());
+    }
 
     _commandExecutor->transitionImage(commandBuffer, swapchainImage,
                                       VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
@@ -201,11 +277,14 @@ void Renderer::draw() {
     renderInfo.colorAttachmentCount = 1;
     renderInfo.pColorAttachments = &colorAttachment;
 
-    vkCmdBeginRendering(commandBuffer, &renderInfo);
+    {
+        const GpuProfiler::Scope gpuScope(*_gpuProfiler, commandBuffer, "ImGui");
+        vkCmdBeginRendering(commandBuffer, &renderInfo);
 
-    ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), commandBuffer);
+        ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), commandBuffer);
 
-    vkCmdEndRendering(commandBuffer);
+        vkCmdEndRendering(commandBuffer);
+    }
 
     _commandExecutor->transitionImage(commandBuffer, swapchainImage,
                                       VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
@@ -220,30 +299,44 @@ void Renderer::draw() {
                                       .commandBuffer = commandBuffer,
                                       .deviceMask = 0};
 
-    VkSemaphoreSubmitInfo waitInfo{.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
-                                   .pNext = nullptr,
-                                   .semaphore = _swapchainSemaphores[semaphoreIndex],
-                                   .value = 1,
-                                   .stageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR,
-                                   .deviceIndex = 0};
-    VkSemaphoreSubmitInfo signalInfo{.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
-                                     .pNext = nullptr,
-                                     .semaphore = _renderSemaphores[semaphoreIndex],
-                                     .value = 1,
-                                     .stageMask = VK_PIPELINE_STAGE_2_ALL_GRAPHICS_BIT,
-                                     .deviceIndex = 0};
+    std::array<VkSemaphoreSubmitInfo, 2> waitInfos{
+        VkSemaphoreSubmitInfo{.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+                              .pNext = nullptr,
+                              .semaphore = _swapchainSemaphores[semaphoreIndex],
+                              .value = 1,
+                              .stageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR,
+                              .deviceIndex = 0},
+        // Uploads up to this frame must have landed before they are acquired, copied or drawn
+        VkSemaphoreSubmitInfo{.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+                              .pNext = nullptr,
+                              .semaphore = _uploadManager->getTimelineSemaphore(),
+                              .value = _uploadManager->getSubmittedValue(),
+                              .stageMask = UploadManager::CONSUMER_STAGES,
+                              .deviceIndex = 0}};
+    std::array<VkSemaphoreSubmitInfo, 2> signalInfos{
+        VkSemaphoreSubmitInfo{.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+                              .pNext = nullptr,
+                              .semaphore = _renderSemaphores[semaphoreIndex],
+                              .value = 1,
+                              .stageMask = VK_PIPELINE_STAGE_2_ALL_GRAPHICS_BIT,
+                              .deviceIndex = 0},
+        // Lets the transfer queue know when this frame no longer reads mesh memory
+        _uploadManager->nextFrameSignal()};
 
     VkSubmitInfo2 submit{.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2,
                          .pNext = nullptr,
                          .flags = 0,
-                         .waitSemaphoreInfoCount = 1,
-                         .pWaitSemaphoreInfos = &waitInfo,
+                         .waitSemaphoreInfoCount = static_cast<uint32_t>(waitInfos.size()),
+                         .pWaitSemaphoreInfos = waitInfos.data(),
                          .commandBufferInfoCount = 1,
                          .pCommandBufferInfos = &cmdinfo,
-                         .signalSemaphoreInfoCount = 1,
-                         .pSignalSemaphoreInfos = &signalInfo};
+                         .signalSemaphoreInfoCount = static_cast<uint32_t>(signalInfos.size()),
+                         .pSignalSemaphoreInfos = signalInfos.data()};
 
-    ret = vkQueueSubmit2(_device.getQueue(), 1, &submit, currentFrame._renderFence);
+    {
+        const Profiler::Scope scope("Submit");
+        ret = vkQueueSubmit2(_device.getQueue(), 1, &submit, currentFrame._renderFence);
+    }
     checkVkResult(ret, "Failed to submit to queue");
 
     // Present the rendered image to the screen
@@ -256,12 +349,23 @@ void Renderer::draw() {
                                  .pSwapchains = &retSwapchain,
                                  .pImageIndices = &swapchainImageIndex,
                                  .pResults = nullptr};
-    ret = vkQueuePresentKHR(_device.getQueue(), &presentInfo);
+    {
+        const Profiler::Scope scope("Present");
+        ret = vkQueuePresentKHR(_device.getQueue(), &presentInfo);
+    }
     checkVkResult(ret, "Failed to present swapchain image");
 
     _frameManager->incrementFrame();
 }
 
+void Renderer::setMeshingMode(ChunkMesh::MeshingMode mode) {
+    if (mode == _voxelRenderer->getMeshingMode()) {
+        return;
+    }
+    _voxelRenderer->setMeshingMode(mode);
+    _chunkInstanciator->requestRemeshAll();
+}
+
 void Renderer::checkVkResult(VkResult result, const char* errorMessage) {
     if (result != VK_SUCCESS) {
         throw std::runtime_error(errorMessage);
@@ -284,6 +388,7 @@ void Renderer::resizeSwapchain() {
     // Recreate draw and depth images with new size
     VkExtent2D newExtent = _swapchain->getSwapchainExtent();
     _renderContext->createDrawImages(newExtent);
+    _voxelRenderer->onDrawImagesResized();
 }
 
 void Renderer::initImGui() {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <chrono>
 #include <memory>
 #include <vk_mem_alloc.h>
 
@@ -8,6 +9,7 @@
 #include <vulkan/vulkan.h>
 
 #include "common/Types/RenderTypes.hpp"
+#include "common/World/ChunkMesh.hpp"
 #include "Core/DeletionQueue.hpp"
 #include "Core/VulkanTypes.hpp"
 #include "Memory/DescriptorAllocator.hpp"
@@ -17,6 +19,7 @@ class VulkanDevice;
 class VulkanSwapchain;
 class Window;
 class VulkanBuffer;
+class UploadManager;
 class MeshManager;
 class Chunk;
 class BlockRegistry;
@@ -25,10 +28,13 @@ class FrameManager;
 class RenderContext;
 class CommandExecutor;
 class VoxelRenderer;
+class ChunkInstanciator;
+class GpuProfiler;
 
 class Renderer {
   public:
-    Renderer(Window& window, VulkanDevice& device, BlockRegistry& registry);
+    // worldSeed picks the terrain, the same seed always gives the same world
+    Renderer(Window& window, VulkanDevice& device, BlockRegistry& registry, long int worldSeed);
     ~Renderer();
 
     Renderer(const Renderer&) = delete;
@@ -37,6 +43,15 @@ class Renderer {
     Renderer& operator=(Renderer&&) = delete;
 
     static constexpr uint64_t VULKAN_TIMEOUT_NS = 1000000000; // 1 second
+    // Main-thread time allowed per frame for integrating generated chunks
+    static constexpr std::chrono::microseconds CHUNK_STREAMING_BUDGET{2000};
+    // Chunks (re)meshed per frame at most, the rest waits in the remesh queue
+    static constexpr size_t MAX_REMESHES_PER_FRAME = 128;
+    // Chunks stay resident until they are one chunk past the load distance.
+    // Past ChunkRegion::MERGE_DISTANCE chunks are drawn as merged regions, which keeps
+    // the candidates of a 12 chunk box under VoxelRenderer::MAX_CHUNKS.
+    static constexpr float CHUNK_LOAD_DISTANCE = 12.0F * 32.0F;
+    static constexpr float CHUNK_UNLOAD_DISTANCE = CHUNK_LOAD_DISTANCE + 32.0F;
     void draw();
     void resizeSwapchain();
     void updateFPS(float deltaTime);
@@ -46,6 +61,15 @@ class Renderer {
     [[nodiscard]] bool isWireframeMode() const { return _wireframeMode; }
     [[nodiscard]] float getFPS() const { return _fps; }
     [[nodiscard]] Camera& getCamera() { return *_camera; }
+    [[nodiscard]] const ChunkInstanciator& getChunkInstanciator() const {
+        return *_chunkInstanciator;
+    }
+    [[nodiscard]] VoxelRenderer& getVoxelRenderer() { return *_voxelRenderer; }
+    // Switches mesher and queues every loaded chunk for a remesh. Meshes are replaced
+    // over the next frames, within the per-frame remesh budget.
+    void setMeshingMode(ChunkMesh::MeshingMode mode);
+    [[nodiscard]] const UploadManager& getUploadManager() const { return *_uploadManager; }
+    [[nodiscard]] const GpuProfiler& getGpuProfiler() const { return *_gpuProfiler; }
     [[nodiscard]] DescriptorAllocatorGrowable& getGlobalDescriptorAllocator() {
         return _globalDescriptorAllocator;
     }
@@ -63,12 +87,15 @@ class Renderer {
     std::vector<VkSemaphore> _renderSemaphores;
     DeletionQueue _mainDeletionQueue;
     std::unique_ptr<VulkanBuffer> _bufferManager;
+    std::unique_ptr<UploadManager> _uploadManager;
     std::unique_ptr<MeshManager> _meshManager;
     std::unique_ptr<Camera> _camera;
     std::unique_ptr<FrameManager> _frameManager;
     std::unique_ptr<RenderContext> _renderContext;
     std::unique_ptr<CommandExecutor> _commandExecutor;
     std::unique_ptr<VoxelRenderer> _voxelRenderer;
+    std::unique_ptr<ChunkInstanciator> _chunkInstanciator;
+    std::unique_ptr<GpuProfiler> _gpuProfiler;
 
     // Wireframe mode
     bool _wireframeMode = false;
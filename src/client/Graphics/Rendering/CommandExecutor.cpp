@@ -10,8 +10,10 @@ CommandExecutor::CommandExecutor(VulkanDevice& device, RenderContext& context)
     : _device(device), _context(context) {}
 
 VkImageAspectFlags CommandExecutor::getImageAspectMask(VkImageLayout layout) {
-    return (layout == VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL) ? VK_IMAGE_ASPECT_DEPTH_BIT
-                                                                : VK_IMAGE_ASPECT_COLOR_BIT;
+    return (layout == VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL ||
+            layout == VK_IMAGE_LAYOUT_DEPTH_READ_ONLY_OPTIMAL)
+               ? VK_IMAGE_ASPECT_DEPTH_BIT
+               : VK_IMAGE_ASPECT_COLOR_BIT;
 }
 
 VkImageMemoryBarrier2 CommandExecutor::createImageBarrier(VkImage image, VkImageLayout oldLayout,
@@ -54,6 +56,29 @@ void CommandExecutor::transitionImage(VkCommandBuffer cmd, VkImage image, VkImag
     vkCmdPipelineBarrier2(cmd, &depInfo);
 }
 
+void CommandExecutor::memoryBarrier(VkCommandBuffer cmd, VkPipelineStageFlags2 srcStage,
+                                    VkAccessFlags2 srcAccess, VkPipelineStageFlags2 dstStage,
+                                    VkAccessFlags2 dstAccess) const {
+    VkMemoryBarrier2 barrier{.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
+                             .pNext = nullptr,
+                             .srcStageMask = srcStage,
+                             .srcAccessMask = srcAccess,
+                             .dstStageMask = dstStage,
+                             .dstAccessMask = dstAccess};
+
+    VkDependencyInfo depInfo{.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+                             .pNext = nullptr,
+                             .dependencyFlags = 0,
+                             .memoryBarrierCount = 1,
+                             .pMemoryBarriers = &barrier,
+                             .bufferMemoryBarrierCount = 0,
+                             .pBufferMemoryBarriers = nullptr,
+                             .imageMemoryBarrierCount = 0,
+                             .pImageMemoryBarriers = nullptr};
+
+    vkCmdPipelineBarrier2(cmd, &depInfo);
+}
+
 void CommandExecutor::copyImageToImage(VkCommandBuffer cmd, VkImage source, VkImage destination,
                                        VkExtent2D srcSize, VkExtent2D dstSize) {
     VkImageBlit2 blitRegion{.sType = VK_STRUCTURE_TYPE_IMAGE_BLIT_2, .pNext = nullptr};
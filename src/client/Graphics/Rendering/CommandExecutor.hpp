@@ -21,6 +21,10 @@ class CommandExecutor {
 
     void transitionImage(VkCommandBuffer cmd, VkImage image, VkImageLayout oldLayout,
                          VkImageLayout newLayout) const;
+    // Global memory dependency, for buffers shared between passes of one command buffer
+    void memoryBarrier(VkCommandBuffer cmd, VkPipelineStageFlags2 srcStage,
+                       VkAccessFlags2 srcAccess, VkPipelineStageFlags2 dstStage,
+                       VkAccessFlags2 dstAccess) const;
     void copyImageToImage(VkCommandBuffer cmd, VkImage source, VkImage destination,
                           VkExtent2D srcSize, VkExtent2D dstSize);
     void immediateSubmit(std::function<void(VkCommandBuffer cmd)>&& function);
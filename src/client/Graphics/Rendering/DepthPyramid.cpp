@@ -0,0 +1,220 @@
+#include "DepthPyramid.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+#include <glm/glm.hpp>
+
+#include "../Core/VulkanDevice.hpp"
+#include "../Pipeline/ComputePipelineBuilder.hpp"
+#include "CommandExecutor.hpp"
+
+namespace {
+// Must match the push constants of depth_reduce.comp
+struct ReducePushConstants {
+    glm::vec2 outputSize;
+    glm::vec2 inputSize;
+};
+} // namespace
+
+DepthPyramid::DepthPyramid(VulkanDevice& device, CommandExecutor& executor)
+    : _device(device), _executor(executor) {
+    // Linear filtering with a MAX reduction returns the furthest of the 2x2 texels
+    // under the sample instead of their average
+    VkSamplerReductionModeCreateInfo reductionInfo{
+        .sType = VK_STRUCTURE_TYPE_SAMPLER_REDUCTION_MODE_CREATE_INFO,
+        .pNext = nullptr,
+        .reductionMode = VK_SAMPLER_REDUCTION_MODE_MAX};
+    VkSamplerCreateInfo samplerInfo{.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+                                    .pNext = &reductionInfo,
+                                    .flags = 0,
+                                    .magFilter = VK_FILTER_LINEAR,
+                                    .minFilter = VK_FILTER_LINEAR,
+                                    .mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST,
+                                    .addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+                                    .addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+                                    .addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+                                    .mipLodBias = 0.0F,
+                                    .anisotropyEnable = VK_FALSE,
+                                    .maxAnisotropy = 1.0F,
+                                    .compareEnable = VK_FALSE,
+                                    .compareOp = VK_COMPARE_OP_ALWAYS,
+                                    .minLod = 0.0F,
+                                    .maxLod = VK_LOD_CLAMP_NONE,
+                                    .borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE,
+                                    .unnormalizedCoordinates = VK_FALSE};
+    if (vkCreateSampler(_device.getDevice(), &samplerInfo, nullptr, &_sampler) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create depth pyramid sampler");
+    }
+
+    std::vector<DescriptorAllocatorGrowable::PoolSizeRatio> sizes = {
+        {.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, .ratio = 1.0F},
+        {.type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, .ratio = 1.0F}};
+    _descriptorAllocator.init(_device.getDevice(), 16, sizes);
+
+    createReducePipeline();
+}
+
+DepthPyramid::~DepthPyramid() {
+    destroyImage();
+    _descriptorAllocator.destroyPools(_device.getDevice());
+    if (_reducePipeline.getLayout() != VK_NULL_HANDLE) {
+        vkDestroyPipelineLayout(_device.getDevice(), _reducePipeline.getLayout(), nullptr);
+    }
+    _reducePipeline.cleanup(_device);
+    vkDestroyDescriptorSetLayout(_device.getDevice(), _reduceSetLayout, nullptr);
+    vkDestroySampler(_device.getDevice(), _sampler, nullptr);
+}
+
+void DepthPyramid::createReducePipeline() {
+    DescriptorLayoutBuilder layoutBuilder;
+    layoutBuilder.addBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER); // Source level
+    layoutBuilder.addBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE);          // Target level
+    _reduceSetLayout = layoutBuilder.build(_device.getDevice(), VK_SHADER_STAGE_COMPUTE_BIT);
+
+    ComputePipelineBuilder pipelineBuilder;
+    pipelineBuilder.setShader("shaders/depth_reduce.comp.spv");
+    pipelineBuilder.setDescriptorSetLayout(_reduceSetLayout);
+    pipelineBuilder.setPushConstantRange(VkPushConstantRange{
+        .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+        .offset = 0,
+        .size = sizeof(ReducePushConstants)});
+    ComputePipelineBuilder::BuildResult result = pipelineBuilder.build(_device);
+    _reducePipeline.init(result.pipeline, result.layout, result.descriptorSetLayout);
+}
+
+void DepthPyramid::destroyImage() {
+    for (VkImageView view : _mipViews) {
+        vkDestroyImageView(_device.getDevice(), view, nullptr);
+    }
+    _mipViews.clear();
+    _reduceSets.clear();
+    if (_imageView != VK_NULL_HANDLE) {
+        vkDestroyImageView(_device.getDevice(), _imageView, nullptr);
+        _imageView = VK_NULL_HANDLE;
+    }
+    if (_image != VK_NULL_HANDLE) {
+        vmaDestroyImage(_device.getAllocator(), _image, _allocation);
+        _image = VK_NULL_HANDLE;
+    }
+}
+
+void DepthPyramid::resize(VkExtent2D depthExtent, VkImageView depthView) {
+    destroyImage();
+    _descriptorAllocator.clearPools(_device.getDevice());
+
+    // Powers of two keep every reduction after level 0 an exact 2x2 step. Level 0 is
+    // smaller than the depth image by a ratio in (1, 2] per axis, so its texels take the
+    // furthest depth of their whole footprint instead (see depth_reduce.comp).
+    _depthExtent = depthExtent;
+    _extent = {.width = std::bit_floor(std::max(depthExtent.width, 1U)),
+               .height = std::bit_floor(std::max(depthExtent.height, 1U))};
+    _mipLevels = static_cast<uint32_t>(std::bit_width(std::max(_extent.width, _extent.height)));
+
+    VkImageCreateInfo imageInfo{.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+                                .pNext = nullptr,
+                                .flags = 0,
+                                .imageType = VK_IMAGE_TYPE_2D,
+                                .format = VK_FORMAT_R32_SFLOAT,
+                                .extent = {.width = _extent.width,
+                                           .height = _extent.height,
+                                           .depth = 1},
+                                .mipLevels = _mipLevels,
+                                .arrayLayers = 1,
+                                .samples = VK_SAMPLE_COUNT_1_BIT,
+                                .tiling = VK_IMAGE_TILING_OPTIMAL,
+                                .usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_STORAGE_BIT};
+    VmaAllocationCreateInfo allocInfo{
+        .usage = VMA_MEMORY_USAGE_GPU_ONLY,
+        .requiredFlags = VkMemoryPropertyFlags(VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)};
+    if (vmaCreateImage(_device.getAllocator(), &imageInfo, &allocInfo, &_image, &_allocation,
+                       nullptr) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create depth pyramid image");
+    }
+
+    auto createView = [&](uint32_t baseMip, uint32_t levelCount) {
+        VkImageViewCreateInfo viewInfo{.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+                                       .pNext = nullptr,
+                                       .flags = 0,
+                                       .image = _image,
+                                       .viewType = VK_IMAGE_VIEW_TYPE_2D,
+                                       .format = VK_FORMAT_R32_SFLOAT,
+                                       .subresourceRange = {
+                                           .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                                           .baseMipLevel = baseMip,
+                                           .levelCount = levelCount,
+                                           .baseArrayLayer = 0,
+                                           .layerCount = 1,
+                                       }};
+        VkImageView view = VK_NULL_HANDLE;
+        if (vkCreateImageView(_device.getDevice(), &viewInfo, nullptr, &view) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create depth pyramid view");
+        }
+        return view;
+    };
+    _imageView = createView(0, _mipLevels);
+    for (uint32_t mip = 0; mip < _mipLevels; mip++) {
+        _mipViews.push_back(createView(mip, 1));
+    }
+
+    for (uint32_t mip = 0; mip < _mipLevels; mip++) {
+        VkDescriptorSet set = _descriptorAllocator.allocate(_device.getDevice(), _reduceSetLayout);
+        DescriptorWriter writer;
+        if (mip == 0) {
+            writer.writeImage(0, depthView, _sampler, VK_IMAGE_LAYOUT_DEPTH_READ_ONLY_OPTIMAL,
+                              VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
+        } else {
+            writer.writeImage(0, _mipViews.at(mip - 1), _sampler, VK_IMAGE_LAYOUT_GENERAL,
+                              VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
+        }
+        writer.writeImage(1, _mipViews.at(mip), VK_NULL_HANDLE, VK_IMAGE_LAYOUT_GENERAL,
+                          VK_DESCRIPTOR_TYPE_STORAGE_IMAGE);
+        writer.updateSet(_device.getDevice(), set);
+        _reduceSets.push_back(set);
+    }
+
+    // Valid to sample before the first build (occlusion culling may start disabled)
+    _executor.immediateSubmit([this](VkCommandBuffer cmd) {
+        _executor.transitionImage(cmd, _image, VK_IMAGE_LAYOUT_UNDEFINED,
+                                  VK_IMAGE_LAYOUT_GENERAL);
+    });
+}
+
+void DepthPyramid::build(VkCommandBuffer cmd, VkImage depthImage) {
+    _executor.transitionImage(cmd, depthImage, VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL,
+                              VK_IMAGE_LAYOUT_DEPTH_READ_ONLY_OPTIMAL);
+    // Previous contents are not needed, and the last culling pass is done reading them
+    _executor.transitionImage(cmd, _image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL);
+
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, _reducePipeline.getPipeline());
+    for (uint32_t mip = 0; mip < _mipLevels; mip++) {
+        const uint32_t width = std::max(_extent.width >> mip, 1U);
+        const uint32_t height = std::max(_extent.height >> mip, 1U);
+        const uint32_t inputWidth =
+            mip == 0 ? _depthExtent.width : std::max(_extent.width >> (mip - 1), 1U);
+        const uint32_t inputHeight =
+            mip == 0 ? _depthExtent.height : std::max(_extent.height >> (mip - 1), 1U);
+        const ReducePushConstants constants{
+            .outputSize = glm::vec2(static_cast<float>(width), static_cast<float>(height)),
+            .inputSize =
+                glm::vec2(static_cast<float>(inputWidth), static_cast<float>(inputHeight))};
+
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE,
+                                _reducePipeline.getLayout(), 0, 1, &_reduceSets.at(mip), 0,
+                                nullptr);
+        vkCmdPushConstants(cmd, _reducePipeline.getLayout(), VK_SHADER_STAGE_COMPUTE_BIT, 0,
+                           sizeof(ReducePushConstants), &constants);
+        vkCmdDispatch(cmd, (width + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE,
+                      (height + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1);
+
+        // The next level samples this one
+        _executor.memoryBarrier(cmd, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                                VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+                                VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                                VK_ACCESS_2_SHADER_SAMPLED_READ_BIT);
+    }
+
+    _executor.transitionImage(cmd, depthImage, VK_IMAGE_LAYOUT_DEPTH_READ_ONLY_OPTIMAL,
+                              VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL);
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <vector>
+
+#include <vk_mem_alloc.h>
+
+#include <vulkan/vulkan.h>
+
+#include "../Memory/DescriptorAllocator.hpp"
+#include "../Pipeline/Pipeline.hpp"
+
+class VulkanDevice;
+class CommandExecutor;
+
+// Hierarchical-Z buffer for occlusion culling: a mip chain where every texel holds the
+// furthest depth of the area it covers. Built from the depth image with a compute
+// reduction, and sampled through getSampler(), which also reduces with MAX, so one
+// textureLod gives a conservative occluder depth for a whole screen rectangle.
+// Level 0 is the depth extent rounded down to powers of two, each of its texels covering
+// its whole footprint of the depth image.
+class DepthPyramid {
+  public:
+    // Must match local_size_x/y in depth_reduce.comp
+    static constexpr uint32_t WORKGROUP_SIZE = 16;
+
+    DepthPyramid(VulkanDevice& device, CommandExecutor& executor);
+    ~DepthPyramid();
+
+    DepthPyramid(const DepthPyramid&) = delete;
+    DepthPyramid& operator=(const DepthPyramid&) = delete;
+    DepthPyramid(DepthPyramid&&) = delete;
+    DepthPyramid& operator=(DepthPyramid&&) = delete;
+
+    // (Re)creates the pyramid for a depth image. The device must be idle.
+    void resize(VkExtent2D depthExtent, VkImageView depthView);
+    // Expects the depth image in DEPTH_ATTACHMENT_OPTIMAL with rendering done, and
+    // leaves it there. The pyramid stays in GENERAL for the culling pass.
+    void build(VkCommandBuffer cmd, VkImage depthImage);
+
+    [[nodiscard]] VkImageView getImageView() const { return _imageView; }
+    [[nodiscard]] VkSampler getSampler() const { return _sampler; }
+    [[nodiscard]] VkExtent2D getExtent() const { return _extent; }
+    [[nodiscard]] uint32_t getMipLevels() const { return _mipLevels; }
+
+  private:
+    void createReducePipeline();
+    void destroyImage();
+
+    VulkanDevice& _device;
+    CommandExecutor& _executor;
+
+    VkSampler _sampler = VK_NULL_HANDLE;
+    VkDescriptorSetLayout _reduceSetLayout = VK_NULL_HANDLE;
+    Pipeline _reducePipeline;
+    DescriptorAllocatorGrowable _descriptorAllocator;
+
+    VkImage _image = VK_NULL_HANDLE;
+    VmaAllocation _allocation = VK_NULL_HANDLE;
+    VkImageView _imageView = VK_NULL_HANDLE; // Every level, for sampling
+    std::vector<VkImageView> _mipViews;      // One level each, for storage writes
+    std::vector<VkDescriptorSet> _reduceSets; // Level i reads level i - 1 (or depth)
+    VkExtent2D _extent{};
+    VkExtent2D _depthExtent{}; // Source of level 0
+    uint32_t _mipLevels = 0;
+};
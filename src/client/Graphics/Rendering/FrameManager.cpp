@@ -11,10 +11,14 @@ FrameManager::FrameManager(VulkanDevice& device) : _device(device), _frameNumber
 }
 
 FrameManager::~FrameManager() {
+    flushDeletionQueues();
+    _frameDeletionQueue.flush();
+}
+
+void FrameManager::flushDeletionQueues() {
     for (auto& frame : _frameData) {
         frame._deletionQueue.flush();
     }
-    _frameDeletionQueue.flush();
 }
 
 FrameManager::FrameData& FrameManager::getCurrentFrame() {
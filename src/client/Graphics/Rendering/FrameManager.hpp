@@ -32,6 +32,8 @@ class FrameManager {
     [[nodiscard]] FrameData& getCurrentFrame();
     [[nodiscard]] uint64_t getFrameNumber() const { return _frameNumber; }
     void incrementFrame() { _frameNumber++; }
+    // Runs every frame's pending deletions now (the device must be idle)
+    void flushDeletionQueues();
 
   private:
     void createFrameCommandPools();
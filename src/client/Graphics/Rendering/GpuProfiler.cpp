@@ -0,0 +1,109 @@
+#include "GpuProfiler.hpp"
+
+#include <stdexcept>
+
+#include "../Core/VulkanDevice.hpp"
+#include "common/Util/Profiler.hpp"
+
+GpuProfiler::Scope::Scope(GpuProfiler& profiler, VkCommandBuffer cmd, const char* name)
+    : _profiler(profiler), _cmd(cmd), _pass(profiler.beginPass(cmd, name)) {}
+
+GpuProfiler::Scope::~Scope() { _profiler.endPass(_cmd, _pass); }
+
+GpuProfiler::GpuProfiler(VulkanDevice& device) : _device(device) {
+    uint32_t familyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(_device.getPhysicalDevice(), &familyCount,
+                                             nullptr);
+    std::vector<VkQueueFamilyProperties> families(familyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(_device.getPhysicalDevice(), &familyCount,
+                                             families.data());
+    const uint32_t validBits = families.at(_device.getGraphicsQueueFamily()).timestampValidBits;
+
+    VkPhysicalDeviceProperties properties{};
+    vkGetPhysicalDeviceProperties(_device.getPhysicalDevice(), &properties);
+    if (validBits == 0 || properties.limits.timestampPeriod <= 0.0F) {
+        return; // No timestamps on this queue, stay inactive
+    }
+    _timestampPeriodNs = static_cast<double>(properties.limits.timestampPeriod);
+    _timestampMask = validBits >= 64 ? UINT64_MAX : (uint64_t{1} << validBits) - 1;
+
+    VkQueryPoolCreateInfo poolInfo{.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+                                   .pNext = nullptr,
+                                   .flags = 0,
+                                   .queryType = VK_QUERY_TYPE_TIMESTAMP,
+                                   .queryCount = FrameManager::FRAME_OVERLAP * MAX_PASSES * 2,
+                                   .pipelineStatistics = 0};
+    if (vkCreateQueryPool(_device.getDevice(), &poolInfo, nullptr, &_queryPool) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create timestamp query pool");
+    }
+}
+
+GpuProfiler::~GpuProfiler() {
+    if (_queryPool != VK_NULL_HANDLE) {
+        vkDestroyQueryPool(_device.getDevice(), _queryPool, nullptr);
+    }
+}
+
+void GpuProfiler::beginFrame(VkCommandBuffer cmd, uint64_t frameNumber) {
+    if (_queryPool == VK_NULL_HANDLE) {
+        return;
+    }
+    _currentSlice = static_cast<uint32_t>(frameNumber % FrameManager::FRAME_OVERLAP);
+    FrameQueries& frame = _frames.at(_currentSlice);
+    collect(frame, firstQuery());
+
+    frame.passNames.clear();
+    frame.cpuStartUs = Profiler::now();
+    vkCmdResetQueryPool(cmd, _queryPool, firstQuery(), MAX_PASSES * 2);
+}
+
+uint32_t GpuProfiler::beginPass(VkCommandBuffer cmd, const char* name) {
+    FrameQueries& frame = _frames.at(_currentSlice);
+    if (_queryPool == VK_NULL_HANDLE || !Profiler::isEnabled() ||
+        frame.passNames.size() == MAX_PASSES) {
+        return NO_PASS;
+    }
+    const auto pass = static_cast<uint32_t>(frame.passNames.size());
+    frame.passNames.push_back(name);
+    vkCmdWriteTimestamp2(cmd, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, _queryPool,
+                         firstQuery() + (pass * 2));
+    return pass;
+}
+
+void GpuProfiler::endPass(VkCommandBuffer cmd, uint32_t pass) {
+    if (pass == NO_PASS) {
+        return;
+    }
+    vkCmdWriteTimestamp2(cmd, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, _queryPool,
+                         firstQuery() + (pass * 2) + 1);
+}
+
+void GpuProfiler::collect(FrameQueries& frame, uint32_t firstQuery) {
+    if (frame.passNames.empty()) {
+        return;
+    }
+    std::vector<uint64_t> timestamps(frame.passNames.size() * 2);
+    // The frame's fence has signalled, so the results are there; without WAIT_BIT a
+    // missing one returns VK_NOT_READY and the frame is skipped rather than stalling
+    const VkResult result = vkGetQueryPoolResults(
+        _device.getDevice(), _queryPool, firstQuery, static_cast<uint32_t>(timestamps.size()),
+        timestamps.size() * sizeof(uint64_t), timestamps.data(), sizeof(uint64_t),
+        VK_QUERY_RESULT_64_BIT);
+    if (result != VK_SUCCESS) {
+        return;
+    }
+
+    // GPU and CPU clocks are not calibrated: the passes are laid out on the trace from
+    // the CPU time the frame was recorded at, spaced as the GPU ran them
+    const uint64_t origin = timestamps.front() & _timestampMask;
+    const auto toUs = [&](uint64_t timestamp) {
+        const uint64_t ticks = ((timestamp & _timestampMask) - origin) & _timestampMask;
+        return static_cast<int64_t>(static_cast<double>(ticks) * _timestampPeriodNs / 1000.0);
+    };
+    for (size_t pass = 0; pass < frame.passNames.size(); pass++) {
+        const int64_t startUs = toUs(timestamps.at(pass * 2));
+        const int64_t endUs = toUs(timestamps.at((pass * 2) + 1));
+        Profiler::recordGpu(frame.passNames.at(pass), frame.cpuStartUs + startUs,
+                            endUs - startUs);
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+#include "FrameManager.hpp"
+
+class VulkanDevice;
+
+// GPU pass timings from timestamp queries, fed to Profiler::recordGpu(). Every frame in
+// flight owns a slice of the query pool; its results are read back when the slice comes
+// round again, after that frame's fence has signalled, so nothing ever waits on them.
+// Passes are recorded back to back and should not nest. Inactive while the Profiler is
+// disabled or when the graphics queue has no timestamps.
+class GpuProfiler {
+  public:
+    static constexpr uint32_t MAX_PASSES = 16; // Per frame, the rest is not timed
+    static constexpr uint32_t NO_PASS = UINT32_MAX;
+
+    // Times the commands recorded during its lifetime
+    class Scope {
+      public:
+        Scope(GpuProfiler& profiler, VkCommandBuffer cmd, const char* name);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+        Scope(Scope&&) = delete;
+        Scope& operator=(Scope&&) = delete;
+
+      private:
+        GpuProfiler& _profiler;
+        VkCommandBuffer _cmd;
+        uint32_t _pass;
+    };
+
+    explicit GpuProfiler(VulkanDevice& device);
+    ~GpuProfiler();
+
+    GpuProfiler(const GpuProfiler&) = delete;
+    GpuProfiler& operator=(const GpuProfiler&) = delete;
+    GpuProfiler(GpuProfiler&&) = delete;
+    GpuProfiler& operator=(GpuProfiler&&) = delete;
+
+    // Collects what this frame's slice measured FRAME_OVERLAP frames ago and resets it.
+    // Call once the frame's fence has signalled, first thing in its command buffer.
+    void beginFrame(VkCommandBuffer cmd, uint64_t frameNumber);
+    // NO_PASS when inactive or out of passes
+    uint32_t beginPass(VkCommandBuffer cmd, const char* name);
+    void endPass(VkCommandBuffer cmd, uint32_t pass);
+
+    [[nodiscard]] bool isSupported() const { return _queryPool != VK_NULL_HANDLE; }
+
+  private:
+    struct FrameQueries {
+        std::vector<const char*> passNames; // Pass i uses queries 2i and 2i + 1
+        int64_t cpuStartUs = 0;             // Profiler::now() when the frame was recorded
+    };
+
+    [[nodiscard]] uint32_t firstQuery() const { return _currentSlice * MAX_PASSES * 2; }
+    void collect(FrameQueries& frame, uint32_t firstQuery);
+
+    VulkanDevice& _device;
+    VkQueryPool _queryPool = VK_NULL_HANDLE;
+    double _timestampPeriodNs = 1.0;
+    uint64_t _timestampMask = 0; // Only the valid bits of a timestamp count
+    std::array<FrameQueries, FrameManager::FRAME_OVERLAP> _frames;
+    uint32_t _currentSlice = 0;
+};
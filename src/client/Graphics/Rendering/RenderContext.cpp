@@ -66,7 +66,9 @@ void RenderContext::createDrawImages(VkExtent2D extent) {
     _depthImage.format = VK_FORMAT_D32_SFLOAT;
     _depthImage.extent = _drawImage.extent;
 
-    VkImageUsageFlags depthImageUsages = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+    // Sampled when building the depth pyramid for occlusion culling
+    VkImageUsageFlags depthImageUsages =
+        VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
 
     VkImageCreateInfo dimg_info{.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
                                 .pNext = nullptr,
@@ -0,0 +1,367 @@
+#include "UploadManager.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../Core/VulkanBuffer.hpp"
+#include "../Core/VulkanDevice.hpp"
+
+namespace {
+void recordMemoryBarrier(VkCommandBuffer cmd, VkPipelineStageFlags2 srcStage,
+                         VkAccessFlags2 srcAccess, VkPipelineStageFlags2 dstStage,
+                         VkAccessFlags2 dstAccess) {
+    VkMemoryBarrier2 barrier{.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
+                             .pNext = nullptr,
+                             .srcStageMask = srcStage,
+                             .srcAccessMask = srcAccess,
+                             .dstStageMask = dstStage,
+                             .dstAccessMask = dstAccess};
+    VkDependencyInfo dependencyInfo{.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+                                    .pNext = nullptr,
+                                    .dependencyFlags = 0,
+                                    .memoryBarrierCount = 1,
+                                    .pMemoryBarriers = &barrier,
+                                    .bufferMemoryBarrierCount = 0,
+                                    .pBufferMemoryBarriers = nullptr,
+                                    .imageMemoryBarrierCount = 0,
+                                    .pImageMemoryBarriers = nullptr};
+    vkCmdPipelineBarrier2(cmd, &dependencyInfo);
+}
+
+void recordBufferBarriers(VkCommandBuffer cmd,
+                          const std::vector<VkBufferMemoryBarrier2>& barriers) {
+    VkDependencyInfo dependencyInfo{.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+                                    .pNext = nullptr,
+                                    .dependencyFlags = 0,
+                                    .memoryBarrierCount = 0,
+                                    .pMemoryBarriers = nullptr,
+                                    .bufferMemoryBarrierCount =
+                                        static_cast<uint32_t>(barriers.size()),
+                                    .pBufferMemoryBarriers = barriers.data(),
+                                    .imageMemoryBarrierCount = 0,
+                                    .pImageMemoryBarriers = nullptr};
+    vkCmdPipelineBarrier2(cmd, &dependencyInfo);
+}
+
+VkSemaphore createTimelineSemaphore(VkDevice device) {
+    VkSemaphoreTypeCreateInfo timelineInfo{.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+                                           .pNext = nullptr,
+                                           .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+                                           .initialValue = 0};
+    VkSemaphoreCreateInfo semaphoreInfo{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO, .pNext = &timelineInfo, .flags = 0};
+    VkSemaphore semaphore = VK_NULL_HANDLE;
+    if (vkCreateSemaphore(device, &semaphoreInfo, nullptr, &semaphore) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create upload timeline semaphore");
+    }
+    return semaphore;
+}
+} // namespace
+
+UploadManager::UploadManager(VulkanDevice& device, VulkanBuffer& bufferManager)
+    : _device(device), _bufferManager(bufferManager) {
+    // Persistently mapped (createBuffer always maps) and host coherent
+    _stagingBuffer = _bufferManager.createStagingBuffer(STAGING_RING_SIZE);
+    createCommandStructures();
+    _stats.dedicatedTransferQueue = _device.hasDedicatedTransferQueue();
+}
+
+UploadManager::~UploadManager() {
+    // The renderer waits for the device to go idle before tearing this down
+    for (Batch& batch : _batches) {
+        for (const AllocatedBuffer& buffer : batch.overflowBuffers) {
+            _bufferManager.destroyBuffer(buffer);
+        }
+    }
+    for (const AllocatedBuffer& buffer : _overflowBuffers) {
+        _bufferManager.destroyBuffer(buffer);
+    }
+    _bufferManager.destroyBuffer(_stagingBuffer);
+    vkDestroySemaphore(_device.getDevice(), _timeline, nullptr);
+    vkDestroySemaphore(_device.getDevice(), _frameTimeline, nullptr);
+    vkDestroyCommandPool(_device.getDevice(), _commandPool, nullptr);
+}
+
+void UploadManager::createCommandStructures() {
+    VkCommandPoolCreateInfo commandPoolInfo{.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+                                            .pNext = nullptr,
+                                            .flags =
+                                                VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+                                            .queueFamilyIndex = _device.getTransferQueueFamily()};
+    if (vkCreateCommandPool(_device.getDevice(), &commandPoolInfo, nullptr, &_commandPool) !=
+        VK_SUCCESS) {
+        throw std::runtime_error("Failed to create upload command pool");
+    }
+
+    std::array<VkCommandBuffer, MAX_BATCHES_IN_FLIGHT> commandBuffers{};
+    VkCommandBufferAllocateInfo allocInfo{.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+                                          .pNext = nullptr,
+                                          .commandPool = _commandPool,
+                                          .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+                                          .commandBufferCount = MAX_BATCHES_IN_FLIGHT};
+    if (vkAllocateCommandBuffers(_device.getDevice(), &allocInfo, commandBuffers.data()) !=
+        VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate upload command buffers");
+    }
+    for (size_t i = 0; i < MAX_BATCHES_IN_FLIGHT; i++) {
+        _batches.at(i).commandBuffer = commandBuffers.at(i);
+    }
+
+    _timeline = createTimelineSemaphore(_device.getDevice());
+    _frameTimeline = createTimelineSemaphore(_device.getDevice());
+}
+
+void UploadManager::enqueueUpload(VkBuffer dst, VkDeviceSize dstOffset,
+                                  std::span<const std::byte> data, bool overwritesLiveData) {
+    if (data.empty()) {
+        return;
+    }
+    _waitForFrames = _waitForFrames || overwritesLiveData;
+
+    VkBuffer src = _stagingBuffer.buffer;
+    VkDeviceSize srcOffset = 0;
+    std::optional<uint64_t> ringOffset = _ring.allocate(data.size(), STAGING_ALIGNMENT);
+    if (ringOffset.has_value()) {
+        srcOffset = *ringOffset;
+        std::memcpy(static_cast<std::byte*>(_stagingBuffer.info.pMappedData) + srcOffset,
+                    data.data(), data.size());
+    } else {
+        // Ring full (a burst larger than what retires per frame): a one-off buffer
+        // freed with its batch keeps this non-blocking
+        AllocatedBuffer overflow = _bufferManager.createStagingBuffer(data.size());
+        _bufferManager.uploadToBuffer(overflow, data.data(), data.size());
+        _overflowBuffers.push_back(overflow);
+        src = overflow.buffer;
+        _pendingOverflowBytes += data.size();
+    }
+
+    const VkBufferCopy region{.srcOffset = srcOffset, .dstOffset = dstOffset, .size = data.size()};
+    _uploads.push_back(PendingCopy{.src = src, .dst = dst, .region = region});
+    _pendingBytes += data.size();
+}
+
+void UploadManager::enqueueCopy(VkBuffer src, VkBuffer dst, const VkBufferCopy& region) {
+    _copies.push_back(PendingCopy{.src = src, .dst = dst, .region = region});
+}
+
+VkSemaphoreSubmitInfo UploadManager::nextFrameSignal() {
+    _frameValue++;
+    return VkSemaphoreSubmitInfo{.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+                                 .pNext = nullptr,
+                                 .semaphore = _frameTimeline,
+                                 .value = _frameValue,
+                                 .stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                                 .deviceIndex = 0};
+}
+
+std::vector<VkBufferMemoryBarrier2> UploadManager::ownershipTransferBarriers() const {
+    // Only the bytes the batch wrote change family: a span covering gaps between uploads
+    // would also transfer live ranges that in-flight frames are still reading. Ranges
+    // are only merged where they touch or overlap.
+    std::unordered_map<VkBuffer, std::vector<std::pair<VkDeviceSize, VkDeviceSize>>> ranges;
+    for (const PendingCopy& upload : _uploads) {
+        const VkDeviceSize begin = upload.region.dstOffset;
+        ranges[upload.dst].emplace_back(begin, begin + upload.region.size);
+    }
+
+    // Release and acquire must describe the same ranges; only stages and accesses differ
+    std::vector<VkBufferMemoryBarrier2> barriers;
+    const auto pushBarrier = [&](VkBuffer buffer, VkDeviceSize begin, VkDeviceSize end) {
+        barriers.push_back(VkBufferMemoryBarrier2{
+            .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+            .pNext = nullptr,
+            .srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT,
+            .srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+            .dstStageMask = VK_PIPELINE_STAGE_2_NONE,
+            .dstAccessMask = VK_ACCESS_2_NONE,
+            .srcQueueFamilyIndex = _device.getTransferQueueFamily(),
+            .dstQueueFamilyIndex = _device.getGraphicsQueueFamily(),
+            .buffer = buffer,
+            .offset = begin,
+            .size = end - begin});
+    };
+    for (auto& [buffer, bufferRanges] : ranges) {
+        std::sort(bufferRanges.begin(), bufferRanges.end());
+        VkDeviceSize begin = bufferRanges.front().first;
+        VkDeviceSize end = bufferRanges.front().second;
+        for (size_t i = 1; i < bufferRanges.size(); i++) {
+            if (bufferRanges[i].first <= end) {
+                end = std::max(end, bufferRanges[i].second);
+                continue;
+            }
+            pushBarrier(buffer, begin, end);
+            begin = bufferRanges[i].first;
+            end = bufferRanges[i].second;
+        }
+        pushBarrier(buffer, begin, end);
+    }
+    return barriers;
+}
+
+void UploadManager::retire(Batch& batch) {
+    const double latencyMs = std::chrono::duration<double, std::milli>(
+                                 std::chrono::steady_clock::now() - batch.submitTime)
+                                 .count();
+    _stats.lastLatencyMs = latencyMs;
+    // Exponential moving average, smooth enough for the overlay
+    _stats.averageLatencyMs = (_stats.completedBatches == 0)
+                                  ? latencyMs
+                                  : (_stats.averageLatencyMs * 0.9) + (latencyMs * 0.1);
+    _stats.completedBatches++;
+
+    for (const AllocatedBuffer& buffer : batch.overflowBuffers) {
+        _bufferManager.destroyBuffer(buffer);
+    }
+    batch.overflowBuffers.clear();
+    _ring.release(batch.ringMark);
+    batch.timelineValue = 0;
+}
+
+void UploadManager::collectCompleted() {
+    uint64_t completedValue = 0;
+    if (vkGetSemaphoreCounterValue(_device.getDevice(), _timeline, &completedValue) !=
+        VK_SUCCESS) {
+        throw std::runtime_error("Failed to read upload timeline semaphore");
+    }
+    for (Batch& batch : _batches) {
+        if (batch.timelineValue != 0 && batch.timelineValue <= completedValue) {
+            retire(batch);
+        }
+    }
+    _stats.stagingUsed = _ring.getUsed();
+}
+
+void UploadManager::flush() {
+    _stats.bytesLastFlush = _pendingBytes;
+    _stats.copiesLastFlush = _uploads.size() + _copies.size();
+    _stats.overflowBytesLastFlush = _pendingOverflowBytes;
+    _stats.ownershipTransfersLastFlush = 0;
+    if (_uploads.empty()) {
+        return; // Copies alone are recorded on the graphics queue
+    }
+
+    Batch& batch = _batches.at(_nextBatch);
+    if (batch.timelineValue != 0) {
+        // Only reachable with more batches in flight than frames, kept as a safety net
+        VkSemaphoreWaitInfo waitInfo{.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+                                     .pNext = nullptr,
+                                     .flags = 0,
+                                     .semaphoreCount = 1,
+                                     .pSemaphores = &_timeline,
+                                     .pValues = &batch.timelineValue};
+        if (vkWaitSemaphores(_device.getDevice(), &waitInfo, UINT64_MAX) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to wait for upload batch");
+        }
+        retire(batch);
+    }
+
+    VkCommandBuffer cmd = batch.commandBuffer;
+    vkResetCommandBuffer(cmd, 0);
+    VkCommandBufferBeginInfo beginInfo{.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+                                       .pNext = nullptr,
+                                       .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+                                       .pInheritanceInfo = nullptr};
+    if (vkBeginCommandBuffer(cmd, &beginInfo) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to begin upload command buffer");
+    }
+
+    // Destinations may still be read or written by earlier submissions on this queue
+    recordMemoryBarrier(cmd, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_ACCESS_2_MEMORY_WRITE_BIT,
+                        VK_PIPELINE_STAGE_2_COPY_BIT,
+                        VK_ACCESS_2_TRANSFER_READ_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT);
+    for (const PendingCopy& upload : _uploads) {
+        vkCmdCopyBuffer(cmd, upload.src, upload.dst, 1, &upload.region);
+    }
+    if (_device.hasDedicatedTransferQueue()) {
+        // Exclusive buffers: hand the written ranges over to the graphics family
+        std::vector<VkBufferMemoryBarrier2> releases = ownershipTransferBarriers();
+        recordBufferBarriers(cmd, releases);
+        for (VkBufferMemoryBarrier2& acquire : releases) {
+            acquire.srcStageMask = VK_PIPELINE_STAGE_2_NONE;
+            acquire.srcAccessMask = VK_ACCESS_2_NONE;
+            acquire.dstStageMask = CONSUMER_STAGES;
+            acquire.dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT;
+        }
+        _stats.ownershipTransfersLastFlush = releases.size();
+        _pendingAcquires = std::move(releases);
+    } else {
+        recordMemoryBarrier(cmd, VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                            VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                            VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT);
+    }
+
+    if (vkEndCommandBuffer(cmd) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to end upload command buffer");
+    }
+
+    _submittedValue++;
+    VkCommandBufferSubmitInfo cmdInfo{.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO,
+                                      .pNext = nullptr,
+                                      .commandBuffer = cmd,
+                                      .deviceMask = 0};
+    VkSemaphoreSubmitInfo signalInfo{.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+                                     .pNext = nullptr,
+                                     .semaphore = _timeline,
+                                     .value = _submittedValue,
+                                     .stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                                     .deviceIndex = 0};
+    // In-place rewrites must not start while a submitted frame may still draw the old
+    // contents; other batches only touch fresh ranges and overlap those frames freely
+    VkSemaphoreSubmitInfo waitInfo{.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+                                   .pNext = nullptr,
+                                   .semaphore = _frameTimeline,
+                                   .value = _frameValue,
+                                   .stageMask = VK_PIPELINE_STAGE_2_COPY_BIT,
+                                   .deviceIndex = 0};
+    const bool waitForFrames = _waitForFrames && _frameValue > 0;
+    VkSubmitInfo2 submit{.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2,
+                         .pNext = nullptr,
+                         .flags = 0,
+                         .waitSemaphoreInfoCount = waitForFrames ? 1U : 0U,
+                         .pWaitSemaphoreInfos = waitForFrames ? &waitInfo : nullptr,
+                         .commandBufferInfoCount = 1,
+                         .pCommandBufferInfos = &cmdInfo,
+                         .signalSemaphoreInfoCount = 1,
+                         .pSignalSemaphoreInfos = &signalInfo};
+    if (vkQueueSubmit2(_device.getTransferQueue(), 1, &submit, VK_NULL_HANDLE) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to submit upload batch");
+    }
+
+    batch.timelineValue = _submittedValue;
+    batch.ringMark = _ring.getHead();
+    batch.overflowBuffers = std::move(_overflowBuffers);
+    batch.submitTime = std::chrono::steady_clock::now();
+    _nextBatch = (_nextBatch + 1) % MAX_BATCHES_IN_FLIGHT;
+
+    _overflowBuffers.clear();
+    _uploads.clear();
+    _waitForFrames = false;
+    _pendingBytes = 0;
+    _pendingOverflowBytes = 0;
+    _stats.stagingUsed = _ring.getUsed();
+}
+
+void UploadManager::recordGraphicsCommands(VkCommandBuffer cmd) {
+    // Executes behind the frame's wait on the upload timeline at CONSUMER_STAGES
+    if (!_pendingAcquires.empty()) {
+        recordBufferBarriers(cmd, _pendingAcquires);
+        _pendingAcquires.clear();
+    }
+    if (_copies.empty()) {
+        return;
+    }
+
+    // Sources were written by uploads ordered above; destinations are fresh ranges
+    for (const PendingCopy& copy : _copies) {
+        vkCmdCopyBuffer(cmd, copy.src, copy.dst, 1, &copy.region);
+    }
+    recordMemoryBarrier(cmd, VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                        VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT |
+                            VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT,
+                        VK_ACCESS_2_MEMORY_READ_BIT);
+    _copies.clear();
+}
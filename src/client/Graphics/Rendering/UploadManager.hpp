@@ -0,0 +1,134 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+#include "../Core/VulkanTypes.hpp"
+#include "../Memory/RingAllocator.hpp"
+
+class VulkanDevice;
+class VulkanBuffer;
+
+// Batches buffer uploads into one transfer submission per frame.
+// Data is copied into a persistently mapped staging ring right away; the copies are
+// recorded and submitted together by flush(), which signals a timeline semaphore.
+// Ring space and command buffers are reclaimed by polling that semaphore, so the CPU
+// never waits for a transfer. Frames that draw uploaded data wait on
+// getTimelineSemaphore() at getSubmittedValue(), for CONSUMER_STAGES.
+//
+// Batches go to the device's transfer queue. When that is a dedicated family, the
+// written ranges are released by the batch and acquired again on the graphics queue
+// by recordGraphicsCommands(), which also records the GPU-side copies. Frames signal
+// nextFrameSignal() so that batches overwriting live data start after those frames.
+class UploadManager {
+  public:
+    static constexpr VkDeviceSize STAGING_RING_SIZE = VkDeviceSize{64} * 1024 * 1024;
+    static constexpr VkDeviceSize STAGING_ALIGNMENT = 16;
+    // More than the frames in flight, so a batch is always retired before reuse
+    static constexpr size_t MAX_BATCHES_IN_FLIGHT = 4;
+    // Graphics-side stages that read uploaded data: the queued copies, culling and
+    // vertex fetch
+    static constexpr VkPipelineStageFlags2 CONSUMER_STAGES =
+        VK_PIPELINE_STAGE_2_COPY_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT |
+        VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT;
+
+    struct Stats {
+        VkDeviceSize bytesLastFlush = 0;
+        size_t copiesLastFlush = 0;
+        // Bytes that did not fit the ring and went through a one-off staging buffer
+        VkDeviceSize overflowBytesLastFlush = 0;
+        VkDeviceSize stagingUsed = 0;
+        VkDeviceSize stagingCapacity = STAGING_RING_SIZE;
+        // Submit to observed completion, measured on the CPU when a batch is reclaimed
+        double lastLatencyMs = 0.0;
+        double averageLatencyMs = 0.0;
+        uint64_t completedBatches = 0;
+        // Buffer ranges handed from the transfer family to the graphics family
+        size_t ownershipTransfersLastFlush = 0;
+        bool dedicatedTransferQueue = false;
+    };
+
+    UploadManager(VulkanDevice& device, VulkanBuffer& bufferManager);
+    ~UploadManager();
+
+    UploadManager(const UploadManager&) = delete;
+    UploadManager& operator=(const UploadManager&) = delete;
+    UploadManager(UploadManager&&) = delete;
+    UploadManager& operator=(UploadManager&&) = delete;
+
+    // Stages `data` and queues a copy to dst at dstOffset for the next flush().
+    // `overwritesLiveData` is set when frames already submitted may still read the
+    // range; the batch then waits for them instead of racing on the transfer queue.
+    void enqueueUpload(VkBuffer dst, VkDeviceSize dstOffset, std::span<const std::byte> data,
+                       bool overwritesLiveData = false);
+    // Queues a GPU-side copy. Recorded on the graphics queue by recordGraphicsCommands,
+    // after the uploads of the same frame, so it sees the data they wrote.
+    void enqueueCopy(VkBuffer src, VkBuffer dst, const VkBufferCopy& region);
+
+    // Reclaims batches the GPU has finished, without blocking. Call once per frame.
+    void collectCompleted();
+    // Submits every queued upload as one command buffer on the transfer queue.
+    // Must be called before the frame that draws the data is submitted.
+    void flush();
+    // Records, into the frame's command buffer, the ownership acquires matching the
+    // last flush() and the queued GPU-side copies. Call after flush(), before drawing.
+    void recordGraphicsCommands(VkCommandBuffer cmd);
+    // Signal to add to each frame submission; advances the frame counter
+    [[nodiscard]] VkSemaphoreSubmitInfo nextFrameSignal();
+
+    [[nodiscard]] VkSemaphore getTimelineSemaphore() const { return _timeline; }
+    [[nodiscard]] uint64_t getSubmittedValue() const { return _submittedValue; }
+    [[nodiscard]] const Stats& getStats() const { return _stats; }
+
+  private:
+    struct PendingCopy {
+        VkBuffer src;
+        VkBuffer dst;
+        VkBufferCopy region;
+    };
+
+    struct Batch {
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+        uint64_t timelineValue = 0; // 0 while not in flight
+        uint64_t ringMark = 0;
+        std::vector<AllocatedBuffer> overflowBuffers;
+        std::chrono::steady_clock::time_point submitTime;
+    };
+
+    void createCommandStructures();
+    void retire(Batch& batch);
+    // One barrier per destination buffer, spanning every range the batch wrote
+    [[nodiscard]] std::vector<VkBufferMemoryBarrier2> ownershipTransferBarriers() const;
+
+    VulkanDevice& _device;
+    VulkanBuffer& _bufferManager;
+
+    AllocatedBuffer _stagingBuffer{};
+    RingAllocator _ring{STAGING_RING_SIZE};
+
+    VkCommandPool _commandPool = VK_NULL_HANDLE;
+    std::array<Batch, MAX_BATCHES_IN_FLIGHT> _batches;
+    size_t _nextBatch = 0;
+
+    VkSemaphore _timeline = VK_NULL_HANDLE;
+    uint64_t _submittedValue = 0;
+    VkSemaphore _frameTimeline = VK_NULL_HANDLE;
+    uint64_t _frameValue = 0;
+
+    // Queued for the next flush
+    std::vector<PendingCopy> _uploads;
+    std::vector<PendingCopy> _copies;
+    std::vector<VkBufferMemoryBarrier2> _pendingAcquires;
+    bool _waitForFrames = false;
+    std::vector<AllocatedBuffer> _overflowBuffers;
+    VkDeviceSize _pendingBytes = 0;
+    VkDeviceSize _pendingOverflowBytes = 0;
+
+    Stats _stats;
+};
@@ -1,104 +1,153 @@
 #include "MeshBufferPool.hpp"
 
+#include <algorithm>
 #include <stdexcept>
+#include <vector>
 
+#include "../Core/DeletionQueue.hpp"
 #include "../Core/VulkanBuffer.hpp"
 #include "../Core/VulkanDevice.hpp"
+#include "../Rendering/UploadManager.hpp"
 
 // Pre-allocate enough space for many chunks
-// 256 million vertices and 512 million indices
-constexpr VkDeviceSize VERTEX_BUFFER_SIZE = 256 * 1024 * 1024 * sizeof(uint32_t);
-constexpr VkDeviceSize INDEX_BUFFER_SIZE = 512 * 1024 * 1024 * sizeof(uint32_t);
-
-MeshBufferPool::MeshBufferPool(VulkanDevice& device, VulkanBuffer& bufferManager)
-    : _device(device), _bufferManager(bufferManager) {
-
-    _vertexBuffer = _bufferManager.createBuffer(
-        VERTEX_BUFFER_SIZE, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-        VMA_MEMORY_USAGE_GPU_ONLY);
-
-    _indexBuffer = _bufferManager.createBuffer(
-        INDEX_BUFFER_SIZE, VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-        VMA_MEMORY_USAGE_GPU_ONLY);
+// 64 million quads, the geometry of 256 million vertices and 384 million indices
+constexpr uint32_t QUAD_BUFFER_ELEMENTS = 64 * 1024 * 1024;
+constexpr VkDeviceSize QUAD_BUFFER_SIZE = QUAD_BUFFER_ELEMENTS * sizeof(VoxelQuad);
+
+MeshBufferPool::MeshBufferPool(VulkanDevice& device, VulkanBuffer& bufferManager,
+                               UploadManager& uploadManager)
+    : _device(device), _bufferManager(bufferManager), _uploadManager(uploadManager),
+      _quadRanges(QUAD_BUFFER_ELEMENTS) {
+
+    // TRANSFER_SRC so compaction can copy ranges within the same buffer
+    _quadBuffer = _bufferManager.createBuffer(QUAD_BUFFER_SIZE,
+                                              VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                                                  VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+                                                  VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                              VMA_MEMORY_USAGE_GPU_ONLY);
 }
 
 MeshBufferPool::~MeshBufferPool() {
-    _bufferManager.destroyBuffer(_vertexBuffer);
-    _bufferManager.destroyBuffer(_indexBuffer);
+    _bufferManager.destroyBuffer(_quadBuffer);
 }
 
-// Simple append-only allocator
-// TODO: Implement a more sophisticated system to reclaim freed space
-MeshAllocation MeshBufferPool::uploadMesh(
-    std::span<uint32_t> indices, std::span<uint32_t> vertices,
-    const std::function<void(std::function<void(VkCommandBuffer)>&&)>& immediateSubmit) {
-    const size_t vertexSize = vertices.size_bytes();
-    const size_t indexSize = indices.size_bytes();
+MeshAllocation MeshBufferPool::uploadMesh(std::span<const VoxelQuad> quads,
+                                          const FaceQuadCounts& faceQuadCounts) {
+    const auto quadCount = static_cast<uint32_t>(quads.size());
+
+    MeshAllocation allocation;
+    allocation.quadCount = quadCount;
+    allocation.faceQuadCounts = faceQuadCounts;
+    allocation.quadCapacity = quadCount + (quadCount / HEADROOM_DIVISOR);
 
     // Check if there is enough space
-    if ((_vertexOffset * sizeof(uint32_t)) + vertexSize > VERTEX_BUFFER_SIZE ||
-        (_indexOffset * sizeof(uint32_t)) + indexSize > INDEX_BUFFER_SIZE) {
-        throw std::runtime_error("MeshBufferPool is out of memory!");
+    if (allocation.quadCapacity > 0) {
+        std::optional<uint32_t> offset = _quadRanges.allocate(allocation.quadCapacity);
+        if (!offset.has_value()) {
+            throw std::runtime_error("MeshBufferPool is out of quad memory!");
+        }
+        allocation.firstQuad = *offset;
     }
 
-    MeshAllocation allocation;
-    allocation.indexCount = static_cast<uint32_t>(indices.size());
-    allocation.firstIndex = _indexOffset;
-    allocation.vertexOffset = static_cast<int32_t>(_vertexOffset);
+    writeMesh(allocation, quads, false);
+    return allocation;
+}
 
-    // Calculate byte offsets in the mega-buffers
-    const VkDeviceSize vertexByteOffset = _vertexOffset * sizeof(uint32_t);
-    const VkDeviceSize indexByteOffset = _indexOffset * sizeof(uint32_t);
+bool MeshBufferPool::replaceMesh(MeshAllocation& allocation, std::span<const VoxelQuad> quads,
+                                 const FaceQuadCounts& faceQuadCounts,
+                                 DeletionQueue& deferredFrees) {
+    if (quads.size() > allocation.quadCapacity) {
+        // Outgrew its range: move, and release the old one once no frame draws from it
+        MeshAllocation moved = uploadMesh(quads, faceQuadCounts);
+        freeDeferred(allocation, deferredFrees);
+        allocation = moved;
+        return false;
+    }
 
-    // Create staging buffers for both vertex and index data (only if needed)
-    AllocatedBuffer stagingVertex{VK_NULL_HANDLE, VK_NULL_HANDLE, {}};
-    AllocatedBuffer stagingIndex{VK_NULL_HANDLE, VK_NULL_HANDLE, {}};
+    allocation.quadCount = static_cast<uint32_t>(quads.size());
+    allocation.faceQuadCounts = faceQuadCounts;
+    writeMesh(allocation, quads, true);
+    return true;
+}
 
-    if (!vertices.empty()) {
-        stagingVertex = _bufferManager.createStagingBuffer(vertexSize);
-        _bufferManager.uploadToBuffer(stagingVertex, vertices.data(), vertexSize);
-    }
+void MeshBufferPool::writeMesh(const MeshAllocation& allocation,
+                               std::span<const VoxelQuad> quads, bool inPlace) {
+    // Byte offset in the mega-buffer. The upload batch orders this copy after earlier
+    // frames reading the range (only possible in place), and before the frames
+    // drawing it.
+    const VkDeviceSize byteOffset = VkDeviceSize{allocation.firstQuad} * sizeof(VoxelQuad);
+    _uploadManager.enqueueUpload(_quadBuffer.buffer, byteOffset, std::as_bytes(quads), inPlace);
+}
 
-    if (!indices.empty()) {
-        stagingIndex = _bufferManager.createStagingBuffer(indexSize);
-        _bufferManager.uploadToBuffer(stagingIndex, indices.data(), indexSize);
+void MeshBufferPool::free(const MeshAllocation& allocation) {
+    if (allocation.quadCapacity > 0) {
+        _quadRanges.free(allocation.firstQuad);
     }
+}
 
-    // CRITICAL: Submit BOTH copies in a single command buffer to avoid multiple GPU stalls
-    immediateSubmit([&](VkCommandBuffer cmd) {
-        if (!vertices.empty()) {
-            VkBufferCopy vertexCopy{};
-            vertexCopy.srcOffset = 0;
-            vertexCopy.dstOffset = vertexByteOffset;
-            vertexCopy.size = vertexSize;
-            vkCmdCopyBuffer(cmd, stagingVertex.buffer, _vertexBuffer.buffer, 1, &vertexCopy);
-        }
-
-        if (!indices.empty()) {
-            VkBufferCopy indexCopy{};
-            indexCopy.srcOffset = 0;
-            indexCopy.dstOffset = indexByteOffset;
-            indexCopy.size = indexSize;
-            vkCmdCopyBuffer(cmd, stagingIndex.buffer, _indexBuffer.buffer, 1, &indexCopy);
+void MeshBufferPool::freeDeferred(const MeshAllocation& allocation, DeletionQueue& frameQueue) {
+    frameQueue.push([this, allocation, generation = _generation]() {
+        if (generation == _generation) {
+            free(allocation);
         }
     });
+}
 
-    // Clean up staging buffers after the GPU transfer is complete
-    if (stagingVertex.buffer != VK_NULL_HANDLE) {
-        _bufferManager.destroyBuffer(stagingVertex);
+size_t MeshBufferPool::compact(std::span<MeshAllocation* const> liveMeshes,
+                               VkDeviceSize maxBytes, DeletionQueue& deferredFrees) {
+    std::vector<VkBufferCopy> copies;
+    VkDeviceSize movedBytes = 0;
+
+    // Highest ranges first, so the tail of the buffer empties out. Old ranges stay
+    // reserved until the frames reading them retire, so a source never overlaps a
+    // destination of the same pass.
+    std::vector<MeshAllocation*> meshes(liveMeshes.begin(), liveMeshes.end());
+    std::sort(meshes.begin(), meshes.end(), [](const MeshAllocation* a, const MeshAllocation* b) {
+        return a->firstQuad > b->firstQuad;
+    });
+    for (MeshAllocation* mesh : meshes) {
+        const VkDeviceSize bytes = VkDeviceSize{mesh->quadCapacity} * sizeof(VoxelQuad);
+        if (mesh->quadCapacity == 0 || movedBytes + bytes > maxBytes) {
+            continue;
+        }
+        std::optional<uint32_t> newOffset =
+            _quadRanges.allocateBelow(mesh->quadCapacity, mesh->firstQuad);
+        if (!newOffset.has_value()) {
+            continue;
+        }
+        copies.push_back(VkBufferCopy{.srcOffset = mesh->firstQuad * sizeof(VoxelQuad),
+                                      .dstOffset = *newOffset * sizeof(VoxelQuad),
+                                      .size = bytes});
+        freeDeferred(*mesh, deferredFrees);
+        mesh->firstQuad = *newOffset;
+        movedBytes += bytes;
     }
-    if (stagingIndex.buffer != VK_NULL_HANDLE) {
-        _bufferManager.destroyBuffer(stagingIndex);
+
+    if (copies.empty()) {
+        return 0;
     }
 
-    // Update offsets for next allocation
-    _vertexOffset += static_cast<uint32_t>(vertices.size());
-    _indexOffset += static_cast<uint32_t>(indices.size());
+    // Recorded after this frame's uploads, so meshes rewritten this frame move intact
+    for (const VkBufferCopy& copy : copies) {
+        _uploadManager.enqueueCopy(_quadBuffer.buffer, _quadBuffer.buffer, copy);
+    }
 
-    return allocation;
+    _relocatedMeshes += copies.size();
+    _relocatedBytes += movedBytes;
+    return copies.size();
 }
 
 void MeshBufferPool::reset() {
-    _vertexOffset = 0;
-    _indexOffset = 0;
+    _quadRanges.reset();
+    _generation++;
+}
+
+MeshBufferPool::Stats MeshBufferPool::getStats() const {
+    return Stats{.quads = _quadRanges.getStats(),
+                 .relocatedMeshes = _relocatedMeshes,
+                 .relocatedBytes = _relocatedBytes};
+}
+
+VkDeviceSize MeshBufferPool::getQuadBufferSize() const {
+    return QUAD_BUFFER_SIZE;
 }
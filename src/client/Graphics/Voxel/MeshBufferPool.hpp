@@ -1,27 +1,48 @@
 #pragma once
 
-#include <functional>
 #include <span>
 #include <vector>
 
 #include <vulkan/vulkan.h>
 
 #include "../Core/VulkanTypes.hpp"
+#include "../Memory/RangeAllocator.hpp"
+#include "common/Types/RenderTypes.hpp"
 
+class DeletionQueue;
+class UploadManager;
 class VulkanDevice;
 class VulkanBuffer;
 
-// Represents a sub-allocation within a mega-buffer
+// Represents a sub-allocation within the mega-buffer
 struct MeshAllocation {
-    uint32_t indexCount = 0;
-    uint32_t firstIndex = 0;
-    int32_t vertexOffset = 0;
+    uint32_t quadCount = 0;
+    uint32_t firstQuad = 0;
+    // Reserved space, so a remesh that grows a little can still be written in place
+    uint32_t quadCapacity = 0;
+    // Quads per face direction, consecutive from firstQuad, adding up to quadCount
+    FaceQuadCounts faceQuadCounts{};
 };
 
-// Manages large buffers for storing all chunk meshes
+// Manages one large storage buffer holding the quad records of all chunk meshes,
+// which the vertex shader pulls from directly (there is no vertex or index buffer).
+// Ranges are sub-allocated with a RangeAllocator, so meshes can be freed
+// individually. Frames in flight may still read a freed range, hence
+// freeDeferred() hands the release to a frame deletion queue.
+// Writes go through the UploadManager and land with its next flush().
 class MeshBufferPool {
   public:
-    MeshBufferPool(VulkanDevice& device, VulkanBuffer& bufferManager);
+    // Extra room reserved behind each mesh, as a fraction of its size (1/4)
+    static constexpr uint32_t HEADROOM_DIVISOR = 4;
+
+    struct Stats {
+        RangeAllocator::Stats quads; // In quads
+        size_t relocatedMeshes = 0;  // Ranges moved by compaction, in total
+        VkDeviceSize relocatedBytes = 0;
+    };
+
+    MeshBufferPool(VulkanDevice& device, VulkanBuffer& bufferManager,
+                   UploadManager& uploadManager);
     ~MeshBufferPool();
 
     MeshBufferPool(const MeshBufferPool&) = delete;
@@ -29,21 +50,46 @@ class MeshBufferPool {
     MeshBufferPool(MeshBufferPool&&) = delete;
     MeshBufferPool& operator=(MeshBufferPool&&) = delete;
 
-    MeshAllocation
-    uploadMesh(std::span<uint32_t> indices, std::span<uint32_t> vertices,
-               const std::function<void(std::function<void(VkCommandBuffer)>&&)>& immediateSubmit);
+    // Quads must be grouped by face direction, faceQuadCounts giving the group sizes
+    MeshAllocation uploadMesh(std::span<const VoxelQuad> quads,
+                              const FaceQuadCounts& faceQuadCounts);
+    // Overwrites an existing mesh. Written in place when it fits the allocation's capacity,
+    // otherwise moved to a new range and the old one freed through deferredFrees.
+    // Returns true when written in place.
+    bool replaceMesh(MeshAllocation& allocation, std::span<const VoxelQuad> quads,
+                     const FaceQuadCounts& faceQuadCounts, DeletionQueue& deferredFrees);
+
+    // Releases the range right away: the GPU must no longer be reading it
+    void free(const MeshAllocation& allocation);
+    // Releases the range when `frameQueue` is flushed, i.e. once that frame retired
+    void freeDeferred(const MeshAllocation& allocation, DeletionQueue& frameQueue);
+
+    // Slides live meshes down into lower free ranges with GPU copies, moving at most
+    // maxBytes. Updates the allocations in place; their old ranges are freed through
+    // deferredFrees. Returns the number of ranges moved.
+    size_t compact(std::span<MeshAllocation* const> liveMeshes, VkDeviceSize maxBytes,
+                   DeletionQueue& deferredFrees);
+
+    // Forgets every allocation. Deferred frees issued before are ignored.
     void reset();
 
-    [[nodiscard]] VkBuffer getVertexBuffer() const { return _vertexBuffer.buffer; }
-    [[nodiscard]] VkBuffer getIndexBuffer() const { return _indexBuffer.buffer; }
+    [[nodiscard]] Stats getStats() const;
+
+    [[nodiscard]] VkBuffer getQuadBuffer() const { return _quadBuffer.buffer; }
+    [[nodiscard]] VkDeviceSize getQuadBufferSize() const;
 
   private:
+    void writeMesh(const MeshAllocation& allocation, std::span<const VoxelQuad> quads,
+                   bool inPlace);
+
     VulkanDevice& _device;
     VulkanBuffer& _bufferManager;
+    UploadManager& _uploadManager;
 
-    AllocatedBuffer _vertexBuffer;
-    AllocatedBuffer _indexBuffer;
-
-    uint32_t _vertexOffset = 0;
-    uint32_t _indexOffset = 0;
+    AllocatedBuffer _quadBuffer;
+    RangeAllocator _quadRanges;
+    // Bumped by reset() so frees queued for an older generation become no-ops
+    uint64_t _generation = 0;
+    size_t _relocatedMeshes = 0;
+    VkDeviceSize _relocatedBytes = 0;
 };
@@ -1,80 +1,32 @@
 #include "MeshManager.hpp"
 
-#include <cstring>
-
 #include "../Core/VulkanBuffer.hpp"
 #include "../Core/VulkanDevice.hpp"
+#include "../Rendering/UploadManager.hpp"
 
-MeshManager::MeshManager(VulkanDevice& device, VulkanBuffer& bufferManager)
-    : _device(device), _bufferManager(bufferManager) {}
+MeshManager::MeshManager(VulkanDevice& device, VulkanBuffer& bufferManager,
+                         UploadManager& uploadManager)
+    : _device(device), _bufferManager(bufferManager), _uploadManager(uploadManager) {}
 
 // Overload for packed uint32_t voxel vertices
-GPUMeshBuffers MeshManager::uploadMesh(
-    std::span<uint32_t> indices, std::span<uint32_t> vertices,
-    const std::function<void(std::function<void(VkCommandBuffer)>&&)>& immediateSubmit) {
-    const size_t vertexBufferSize = vertices.size() * sizeof(uint32_t);
-    const size_t indexBufferSize = indices.size() * sizeof(uint32_t);
-
-    GPUMeshBuffers newSurface{};
-
-    // Create vertex buffer
-    newSurface.vertexBuffer = _bufferManager.createBuffer(
-        vertexBufferSize,
-        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT |
-            VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-        VMA_MEMORY_USAGE_GPU_ONLY);
-
-    // Find the address of the vertex buffer
-    VkBufferDeviceAddressInfo deviceAddressInfo{.sType =
-                                                    VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
-                                                .pNext = nullptr,
-                                                .buffer = newSurface.vertexBuffer.buffer};
-    newSurface.vertexBufferAddress =
-        vkGetBufferDeviceAddress(_device.getDevice(), &deviceAddressInfo);
-
-    // Create index buffer
-    newSurface.indexBuffer = _bufferManager.createBuffer(
-        indexBufferSize, VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-        VMA_MEMORY_USAGE_GPU_ONLY);
-
-    // Create staging buffer for both vertex and index data
-    AllocatedBuffer staging =
-        _bufferManager.createStagingBuffer(vertexBufferSize + indexBufferSize);
-
-    void* data = staging.info.pMappedData;
-
-    // Copy vertex buffer
-    std::memcpy(data, vertices.data(), vertexBufferSize);
-    // Copy index buffer
-    std::memcpy(static_cast<char*>(data) + vertexBufferSize, indices.data(), indexBufferSize);
-
-    // Upload to GPU using immediate submit
-    immediateSubmit([&](VkCommandBuffer cmd) {
-        VkBufferCopy vertexCopy{.srcOffset = 0, .dstOffset = 0, .size = vertexBufferSize};
-        vkCmdCopyBuffer(cmd, staging.buffer, newSurface.vertexBuffer.buffer, 1, &vertexCopy);
-
-        VkBufferCopy indexCopy{
-            .srcOffset = vertexBufferSize, .dstOffset = 0, .size = indexBufferSize};
-        vkCmdCopyBuffer(cmd, staging.buffer, newSurface.indexBuffer.buffer, 1, &indexCopy);
-    });
-
-    _bufferManager.destroyBuffer(staging);
-
-    return newSurface;
+GPUMeshBuffers MeshManager::uploadMesh(std::span<const uint32_t> indices,
+                                       std::span<const uint32_t> vertices) {
+    return uploadMeshBytes(indices, std::as_bytes(vertices));
 }
 
 // Original overload for general Vertex struct
-GPUMeshBuffers MeshManager::uploadMesh(
-    std::span<uint32_t> indices, std::span<Vertex> vertices,
-    const std::function<void(std::function<void(VkCommandBuffer)>&&)>& immediateSubmit) {
-    const size_t vertexBufferSize = vertices.size() * sizeof(Vertex);
-    const size_t indexBufferSize = indices.size() * sizeof(uint32_t);
+GPUMeshBuffers MeshManager::uploadMesh(std::span<const uint32_t> indices,
+                                       std::span<const Vertex> vertices) {
+    return uploadMeshBytes(indices, std::as_bytes(vertices));
+}
 
+GPUMeshBuffers MeshManager::uploadMeshBytes(std::span<const uint32_t> indices,
+                                            std::span<const std::byte> vertexData) {
     GPUMeshBuffers newSurface{};
 
     // Create vertex buffer
     newSurface.vertexBuffer = _bufferManager.createBuffer(
-        vertexBufferSize,
+        vertexData.size(),
         VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT |
             VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
         VMA_MEMORY_USAGE_GPU_ONLY);
@@ -89,31 +41,12 @@ GPUMeshBuffers MeshManager::uploadMesh(
 
     // Create index buffer
     newSurface.indexBuffer = _bufferManager.createBuffer(
-        indexBufferSize, VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        indices.size_bytes(), VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
         VMA_MEMORY_USAGE_GPU_ONLY);
 
-    // Create staging buffer for both vertex and index data
-    AllocatedBuffer staging =
-        _bufferManager.createStagingBuffer(vertexBufferSize + indexBufferSize);
-
-    void* data = staging.info.pMappedData;
-
-    // Copy vertex buffer
-    std::memcpy(data, vertices.data(), vertexBufferSize);
-    // Copy index buffer
-    std::memcpy(static_cast<char*>(data) + vertexBufferSize, indices.data(), indexBufferSize);
-
-    // Upload to GPU using immediate submit
-    immediateSubmit([&](VkCommandBuffer cmd) {
-        VkBufferCopy vertexCopy{.srcOffset = 0, .dstOffset = 0, .size = vertexBufferSize};
-        vkCmdCopyBuffer(cmd, staging.buffer, newSurface.vertexBuffer.buffer, 1, &vertexCopy);
-
-        VkBufferCopy indexCopy{
-            .srcOffset = vertexBufferSize, .dstOffset = 0, .size = indexBufferSize};
-        vkCmdCopyBuffer(cmd, staging.buffer, newSurface.indexBuffer.buffer, 1, &indexCopy);
-    });
-
-    _bufferManager.destroyBuffer(staging);
+    // Staged now, copied with the rest of this frame's uploads
+    _uploadManager.enqueueUpload(newSurface.vertexBuffer.buffer, 0, vertexData);
+    _uploadManager.enqueueUpload(newSurface.indexBuffer.buffer, 0, std::as_bytes(indices));
 
     return newSurface;
 }
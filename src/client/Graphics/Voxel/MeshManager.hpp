@@ -1,6 +1,6 @@
 #pragma once
 
-#include <functional>
+#include <cstddef>
 #include <span>
 
 #include <vulkan/vulkan.h>
@@ -10,10 +10,14 @@
 
 class VulkanDevice;
 class VulkanBuffer;
+class UploadManager;
 
+// Standalone meshes with their own buffers. Contents are staged through the
+// UploadManager and land with its next flush(), so a mesh is usable from the
+// frame that flush belongs to.
 class MeshManager {
   public:
-    MeshManager(VulkanDevice& device, VulkanBuffer& bufferManager);
+    MeshManager(VulkanDevice& device, VulkanBuffer& bufferManager, UploadManager& uploadManager);
     ~MeshManager() = default;
 
     MeshManager(const MeshManager&) = delete;
@@ -22,17 +26,18 @@ class MeshManager {
     MeshManager& operator=(MeshManager&&) = delete;
 
     // Overload for packed uint32_t voxel vertices
-    GPUMeshBuffers
-    uploadMesh(std::span<uint32_t> indices, std::span<uint32_t> vertices,
-               const std::function<void(std::function<void(VkCommandBuffer)>&&)>& immediateSubmit);
+    GPUMeshBuffers uploadMesh(std::span<const uint32_t> indices,
+                              std::span<const uint32_t> vertices);
 
     // Original overload for general Vertex struct
-    GPUMeshBuffers
-    uploadMesh(std::span<uint32_t> indices, std::span<Vertex> vertices,
-               const std::function<void(std::function<void(VkCommandBuffer)>&&)>& immediateSubmit);
+    GPUMeshBuffers uploadMesh(std::span<const uint32_t> indices, std::span<const Vertex> vertices);
     void destroyMesh(const GPUMeshBuffers& mesh);
 
   private:
+    GPUMeshBuffers uploadMeshBytes(std::span<const uint32_t> indices,
+                                   std::span<const std::byte> vertexData);
+
     VulkanDevice& _device;
     VulkanBuffer& _bufferManager;
+    UploadManager& _uploadManager;
 };
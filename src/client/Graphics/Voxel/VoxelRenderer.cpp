@@ -1,35 +1,65 @@
 #include "VoxelRenderer.hpp"
 
-#include <map>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iterator>
 #include <stdexcept>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
 #include "../../Game/Camera.hpp"
+#include "../Core/DeletionQueue.hpp"
 #include "../Core/VulkanBuffer.hpp"
 #include "../Core/VulkanDevice.hpp"
 #include "../Memory/DescriptorAllocator.hpp"
+#include "../Pipeline/ComputePipelineBuilder.hpp"
 #include "../Pipeline/GraphicsPipelineBuilder.hpp"
 #include "../Rendering/CommandExecutor.hpp"
+#include "../Rendering/DepthPyramid.hpp"
+#include "../Rendering/GpuProfiler.hpp"
 #include "../Rendering/RenderContext.hpp"
+#include "../Rendering/UploadManager.hpp"
+#include "common/Util/JobSystem.hpp"
+#include "common/Util/Profiler.hpp"
 #include "common/World/Chunk.hpp"
+#include "common/World/ChunkInstanciator.hpp"
 #include "common/World/ChunkMesh.hpp"
+#include "common/World/ChunkRegion.hpp"
+#include "common/World/ChunkSnapshot.hpp"
 #include "MeshBufferPool.hpp"
 #include "MeshManager.hpp"
 
+namespace {
+// Neighbour chunk across each ChunkSnapshot::BorderSide
+const std::array<glm::ivec3, 6> NEIGHBOR_OFFSETS = {
+    glm::ivec3(1, 0, 0), glm::ivec3(-1, 0, 0), glm::ivec3(0, 1, 0),
+    glm::ivec3(0, -1, 0), glm::ivec3(0, 0, 1), glm::ivec3(0, 0, -1)};
+} // namespace
+
+struct VoxelRenderer::RegionJob {
+    MeshJob job;
+    JobSystem::Counter counter;
+};
+
 VoxelRenderer::VoxelRenderer(VulkanDevice& device, MeshManager& meshManager,
                              BlockRegistry& registry, RenderContext& context,
                              CommandExecutor& executor, VulkanBuffer& bufferManager,
-                             DescriptorAllocatorGrowable& descriptorAllocator)
+                             UploadManager& uploadManager,
+                             DescriptorAllocatorGrowable& descriptorAllocator,
+                             unsigned int meshingThreads)
     : _device(device), _meshManager(meshManager), _blockRegistry(registry), _context(context),
-      _executor(executor), _bufferManager(bufferManager),
+      _executor(executor), _bufferManager(bufferManager), _uploadManager(uploadManager),
       _descriptorAllocator(descriptorAllocator) {
     // Initialize mesh buffer pool
-    _meshPool = std::make_unique<MeshBufferPool>(_device, _bufferManager);
+    _meshPool = std::make_unique<MeshBufferPool>(_device, _bufferManager, _uploadManager);
+    _jobSystem = std::make_unique<JobSystem>(meshingThreads);
 }
 
 VoxelRenderer::~VoxelRenderer() {
+    // Background region jobs write into _regionJobs: let the running ones finish first
+    _jobSystem.reset();
     _voxelPipeline.cleanup(_device);
     _voxelWireframePipeline.cleanup(_device);
     // Clean up owned pipeline layout
@@ -37,11 +67,18 @@ VoxelRenderer::~VoxelRenderer() {
         vkDestroyPipelineLayout(_device.getDevice(), _voxelPipelineLayout, nullptr);
         _voxelPipelineLayout = VK_NULL_HANDLE;
     }
+    if (_cullPipeline.getLayout() != VK_NULL_HANDLE) {
+        vkDestroyPipelineLayout(_device.getDevice(), _cullPipeline.getLayout(), nullptr);
+    }
+    _cullPipeline.cleanup(_device);
 
-    // Clean up descriptor set layout
+    // Clean up descriptor set layouts
     if (_chunkSetLayout != VK_NULL_HANDLE) {
         vkDestroyDescriptorSetLayout(_device.getDevice(), _chunkSetLayout, nullptr);
     }
+    if (_cullSetLayout != VK_NULL_HANDLE) {
+        vkDestroyDescriptorSetLayout(_device.getDevice(), _cullSetLayout, nullptr);
+    }
 
     // Clean up MDI buffers
     if (_indirectBuffer.buffer != VK_NULL_HANDLE) {
@@ -50,18 +87,34 @@ VoxelRenderer::~VoxelRenderer() {
     if (_chunkDataBuffer.buffer != VK_NULL_HANDLE) {
         _bufferManager.destroyBuffer(_chunkDataBuffer);
     }
+    if (_cullCounterBuffer.buffer != VK_NULL_HANDLE) {
+        _bufferManager.destroyBuffer(_cullCounterBuffer);
+    }
+    if (_visibilityBuffer.buffer != VK_NULL_HANDLE) {
+        _bufferManager.destroyBuffer(_visibilityBuffer);
+    }
+    for (CullReadback& readback : _cullReadbacks) {
+        if (readback.buffer.buffer != VK_NULL_HANDLE) {
+            _bufferManager.destroyBuffer(readback.buffer);
+        }
+    }
+    if (_drawCandidateBuffer.buffer != VK_NULL_HANDLE) {
+        _bufferManager.destroyBuffer(_drawCandidateBuffer);
+    }
 }
 
 void VoxelRenderer::initPipelines() {
     // First initialize MDI resources and descriptor set layout
     initMDI();
+    initCulling();
 
     VkShaderModule voxelFragShader = Pipeline::loadShaderModule(_device, "shaders/voxel.frag.spv");
     VkShaderModule voxelVertexShader =
         Pipeline::loadShaderModule(_device, "shaders/voxel.vert.spv");
 
-    VkPushConstantRange pushConstantRange{
-        .stageFlags = VK_SHADER_STAGE_VERTEX_BIT, .offset = 0, .size = sizeof(glm::mat4)};
+    VkPushConstantRange pushConstantRange{.stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
+                                          .offset = 0,
+                                          .size = sizeof(DrawPushConstants)};
 
     // Update pipeline layout to include descriptor set for chunk data SSBO
     VkPipelineLayoutCreateInfo pipelineLayoutInfo{
@@ -79,14 +132,7 @@ void VoxelRenderer::initPipelines() {
         throw std::runtime_error("Failed to create voxel pipeline layout");
     }
 
-    // --- PACKED VERTEX FORMAT ---
-    // A single binding for our packed uint32_t vertex data
-    VkVertexInputBindingDescription binding{
-        .binding = 0, .stride = sizeof(uint32_t), .inputRate = VK_VERTEX_INPUT_RATE_VERTEX};
-
-    // A single attribute: the packed uint32_t itself
-    std::vector<VkVertexInputAttributeDescription> attributes{
-        {.location = 0, .binding = 0, .format = VK_FORMAT_R32_UINT, .offset = 0}};
+    // No vertex input state: voxel.vert pulls quad records from a storage buffer
 
     const RenderContext::AllocatedImage& drawImage = _context.getDrawImage();
     const RenderContext::AllocatedImage& depthImage = _context.getDepthImage();
@@ -103,7 +149,6 @@ void VoxelRenderer::initPipelines() {
     pipelineBuilder.enableDepthtest(true, VK_COMPARE_OP_LESS);
     pipelineBuilder.setColorAttachmentFormat(drawImage.format);
     pipelineBuilder.setDepthFormat(depthImage.format);
-    pipelineBuilder.setVertexInputState({binding}, attributes);
 
     VkPipeline voxelPipeline = pipelineBuilder.build(_device.getDevice());
     _voxelPipeline.init(voxelPipeline, _voxelPipelineLayout);
@@ -120,7 +165,6 @@ void VoxelRenderer::initPipelines() {
     pipelineBuilder.enableDepthtest(true, VK_COMPARE_OP_LESS);
     pipelineBuilder.setColorAttachmentFormat(drawImage.format);
     pipelineBuilder.setDepthFormat(depthImage.format);
-    pipelineBuilder.setVertexInputState({binding}, attributes);
 
     VkPipeline voxelWireframePipeline = pipelineBuilder.build(_device.getDevice());
     _voxelWireframePipeline.init(voxelWireframePipeline, _voxelPipelineLayout);
@@ -133,171 +177,643 @@ void VoxelRenderer::initMDI() {
     // Create descriptor set layout for chunk data SSBO
     DescriptorLayoutBuilder layoutBuilder;
     layoutBuilder.addBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+    layoutBuilder.addBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER); // Quads, pulled by index
     _chunkSetLayout = layoutBuilder.build(_device.getDevice(), VK_SHADER_STAGE_VERTEX_BIT);
 
-    // Create buffers for indirect draw commands
-    // Size for max 10000 chunks
-    constexpr uint32_t MAX_CHUNKS = 10000;
-    _indirectBuffer = _bufferManager.createBuffer(sizeof(VkDrawIndexedIndirectCommand) * MAX_CHUNKS,
-                                                  VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
-                                                      VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                                                  VMA_MEMORY_USAGE_CPU_TO_GPU);
+    // Create buffers for indirect draw commands, written by the culling passes:
+    // the early draw list, then the late one at MAX_DRAWS
+    _indirectBuffer = _bufferManager.createBuffer(
+        sizeof(VkDrawIndirectCommand) * MAX_DRAWS * CULL_PHASES,
+        VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+        VMA_MEMORY_USAGE_GPU_ONLY);
+
+    // Create buffer for per-chunk data (SSBO), in the same order as the commands
+    _chunkDataBuffer = _bufferManager.createBuffer(sizeof(GPUChunkData) * MAX_DRAWS * CULL_PHASES,
+                                                   VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                                   VMA_MEMORY_USAGE_GPU_ONLY);
+
+    // Draw counts of both lists and culling statistics, cleared every frame
+    _cullCounterBuffer = _bufferManager.createBuffer(sizeof(GPUCullCounters),
+                                                     VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+                                                         VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                                                         VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+                                                         VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                     VMA_MEMORY_USAGE_GPU_ONLY);
+    for (CullReadback& readback : _cullReadbacks) {
+        readback.buffer = _bufferManager.createBuffer(
+            sizeof(GPUCullCounters), VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_GPU_TO_CPU);
+    }
 
-    // Create buffer for per-chunk data (SSBO)
-    _chunkDataBuffer = _bufferManager.createBuffer(sizeof(GPUChunkData) * MAX_CHUNKS,
-                                                   VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
-                                                       VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                                                   VMA_MEMORY_USAGE_CPU_TO_GPU);
+    // Which candidates passed the late culling phase last frame
+    _visibilityBuffer = _bufferManager.createBuffer(sizeof(uint32_t) * MAX_CHUNKS,
+                                                    VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                                                        VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                    VMA_MEMORY_USAGE_GPU_ONLY);
+    _executor.immediateSubmit([this](VkCommandBuffer cmd) {
+        vkCmdFillBuffer(cmd, _visibilityBuffer.buffer, 0, VK_WHOLE_SIZE, 0);
+    });
+
+    // Culling input, uploaded through the UploadManager when it changes
+    _drawCandidateBuffer = _bufferManager.createBuffer(sizeof(GPUDrawCandidate) * MAX_CHUNKS,
+                                                       VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                                                           VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                       VMA_MEMORY_USAGE_GPU_ONLY);
 
     // Allocate descriptor set for chunk data SSBO
     _chunkDescriptorSet =
         _descriptorAllocator.allocate(_device.getDevice(), _chunkSetLayout, nullptr);
 
-    // Write descriptor set to bind the chunk data buffer
+    // Write descriptor set to bind the chunk data and quad buffers
     DescriptorWriter writer;
-    writer.writeBuffer(0, _chunkDataBuffer.buffer, sizeof(GPUChunkData) * MAX_CHUNKS, 0,
+    writer.writeBuffer(0, _chunkDataBuffer.buffer, sizeof(GPUChunkData) * MAX_DRAWS * CULL_PHASES,
+                       0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+    writer.writeBuffer(1, _meshPool->getQuadBuffer(), _meshPool->getQuadBufferSize(), 0,
                        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
     writer.updateSet(_device.getDevice(), _chunkDescriptorSet);
 }
 
-void VoxelRenderer::initTestChunk() {
-    // Simple struct to use as a key in our chunk map
-    struct ChunkPos {
-        int x, y, z;
-        bool operator<(const ChunkPos& other) const {
-            if (x != other.x) {
-                return x < other.x;
+void VoxelRenderer::initCulling() {
+    DescriptorLayoutBuilder layoutBuilder;
+    layoutBuilder.addBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER); // Candidates
+    layoutBuilder.addBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER); // Indirect commands
+    layoutBuilder.addBinding(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER); // Chunk data
+    layoutBuilder.addBinding(3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER); // Counters
+    layoutBuilder.addBinding(4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER); // Visibility
+    layoutBuilder.addBinding(5, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER); // Depth pyramid
+    _cullSetLayout = layoutBuilder.build(_device.getDevice(), VK_SHADER_STAGE_COMPUTE_BIT);
+
+    _cullDescriptorSet =
+        _descriptorAllocator.allocate(_device.getDevice(), _cullSetLayout, nullptr);
+
+    DescriptorWriter writer;
+    writer.writeBuffer(0, _drawCandidateBuffer.buffer, sizeof(GPUDrawCandidate) * MAX_CHUNKS, 0,
+                       VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+    writer.writeBuffer(1, _indirectBuffer.buffer,
+                       sizeof(VkDrawIndirectCommand) * MAX_DRAWS * CULL_PHASES, 0,
+                       VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+    writer.writeBuffer(2, _chunkDataBuffer.buffer, sizeof(GPUChunkData) * MAX_DRAWS * CULL_PHASES,
+                       0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+    writer.writeBuffer(3, _cullCounterBuffer.buffer, sizeof(GPUCullCounters), 0,
+                       VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+    writer.writeBuffer(4, _visibilityBuffer.buffer, sizeof(uint32_t) * MAX_CHUNKS, 0,
+                       VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+    writer.updateSet(_device.getDevice(), _cullDescriptorSet);
+    // Binding 5 is written by onDrawImagesResized, with the pyramid
+
+    ComputePipelineBuilder pipelineBuilder;
+    pipelineBuilder.setShader("shaders/chunk_cull.comp.spv");
+    pipelineBuilder.setDescriptorSetLayout(_cullSetLayout);
+    pipelineBuilder.setPushConstantRange(VkPushConstantRange{
+        .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT, .offset = 0, .size = sizeof(CullPushConstants)});
+    ComputePipelineBuilder::BuildResult result = pipelineBuilder.build(_device);
+    _cullPipeline.init(result.pipeline, result.layout, result.descriptorSetLayout);
+
+    _depthPyramid = std::make_unique<DepthPyramid>(_device, _executor);
+    onDrawImagesResized();
+}
+
+void VoxelRenderer::onDrawImagesResized() {
+    const RenderContext::AllocatedImage& depthImage = _context.getDepthImage();
+    _depthPyramid->resize({.width = depthImage.extent.width, .height = depthImage.extent.height},
+                          depthImage.imageView);
+
+    DescriptorWriter writer;
+    writer.writeImage(5, _depthPyramid->getImageView(), _depthPyramid->getSampler(),
+                      VK_IMAGE_LAYOUT_GENERAL, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
+    writer.updateSet(_device.getDevice(), _cullDescriptorSet);
+}
+
+void VoxelRenderer::runMeshJob(MeshJob& job, const BlockRegistry& registry,
+                               ChunkMesh::MeshingMode mode) {
+    const Profiler::Scope scope(job.region != nullptr ? "Mesh region" : "Mesh chunk");
+    if (job.region != nullptr) {
+        job.snapshot = std::make_unique<ChunkSnapshot>(job.region->resolve());
+        job.region.reset();
+    }
+    ChunkMesh::generateMesh(*job.snapshot, registry, job.quads, mode);
+    job.faceQuadCounts = ChunkMesh::countFaceQuads(job.quads);
+    job.snapshot.reset();
+}
+
+void VoxelRenderer::meshInParallel(std::vector<MeshJob>& jobs) {
+    JobSystem::Counter counter;
+    for (MeshJob& job : jobs) {
+        _jobSystem->submit([&job, &registry = _blockRegistry,
+                            mode = _meshingMode]() { runMeshJob(job, registry, mode); },
+                           &counter);
+    }
+    _jobSystem->wait(counter);
+}
+
+void VoxelRenderer::releaseChunkMeshes(std::span<const glm::ivec3> positions,
+                                       DeletionQueue& frameDeletionQueue) {
+    for (const glm::ivec3& pos : positions) {
+        auto it = _chunkMeshes.find(pos);
+        if (it != _chunkMeshes.end()) {
+            releaseMesh(_chunkMeshes, it, frameDeletionQueue);
+        }
+        markRegionDirty(pos);
+    }
+}
+
+std::vector<glm::ivec3> VoxelRenderer::updateLodCenter(const glm::vec3& cameraPosition,
+                                                       DeletionQueue& frameDeletionQueue) {
+    const glm::ivec3 center(glm::floor(cameraPosition / static_cast<float>(Chunk::CHUNK_SIZE)));
+    if (center == _lodCenter) {
+        return {};
+    }
+    _lodCenter = center;
+
+    std::vector<glm::ivec3> changed;
+    for (const auto& [position, draw] : _chunkMeshes) {
+        // Chunks of a merged region keep their own mesh until the region's is built
+        if (!ChunkRegion::isMerged(ChunkRegion::regionOf(position), _lodCenter) &&
+            ChunkLod::selectLevel(position, _lodCenter) == draw.level) {
+            continue;
+        }
+        changed.push_back(position);
+        // Also the ones without a mesh: a merged region rebuilds when its members are queued
+        for (const glm::ivec3& offset : NEIGHBOR_OFFSETS) {
+            changed.push_back(position + offset);
+        }
+    }
+
+    for (const auto& [region, draw] : _regionMeshes) {
+        if (ChunkRegion::isMerged(region, _lodCenter)) {
+            // Merged again before its members were all meshed: it stays as it is
+            _splittingRegions.erase(region);
+            continue;
+        }
+        if (_splittingRegions.contains(region)) {
+            continue; // Members already queued
+        }
+        // Members are meshed on their own again, and the chunks around them take their
+        // borders at the members' levels. The region stays drawn until the members are
+        // (releaseSplitRegions), like members stay drawn until their region is.
+        std::unordered_set<glm::ivec3>& pending = _splittingRegions[region];
+        const glm::ivec3 first = ChunkRegion::firstChunkOf(region);
+        for (int z = -1; z <= ChunkRegion::SIZE; z++) {
+            for (int y = -1; y <= ChunkRegion::SIZE; y++) {
+                for (int x = -1; x <= ChunkRegion::SIZE; x++) {
+                    const glm::ivec3 position = first + glm::ivec3(x, y, z);
+                    changed.push_back(position);
+                    if (ChunkRegion::regionOf(position) == region) {
+                        pending.insert(position);
+                    }
+                }
             }
-            if (y != other.y) {
-                return y < other.y;
+        }
+    }
+    return changed;
+}
+
+void VoxelRenderer::releaseMesh(ChunkMeshMap& meshes, ChunkMeshMap::iterator it,
+                                DeletionQueue& frameDeletionQueue) {
+    _meshStats.quads -= it->second.mesh.quadCount;
+    _meshStats.meshesPerLevel.at(static_cast<size_t>(it->second.level))--;
+    _meshPool->freeDeferred(it->second.mesh, frameDeletionQueue);
+    releaseCandidateSlot(it->second.candidateSlot);
+    meshes.erase(it);
+    _meshStats.residentMeshes = _chunkMeshes.size();
+    _meshStats.residentRegions = _regionMeshes.size();
+}
+
+void VoxelRenderer::markRegionDirty(const glm::ivec3& chunkPosition) {
+    const glm::ivec3 region = ChunkRegion::regionOf(chunkPosition);
+    if (ChunkRegion::isMerged(region, _lodCenter)) {
+        _dirtyRegions.insert(region);
+    }
+}
+
+void VoxelRenderer::remeshChunks(const ChunkInstanciator& world,
+                                 std::span<const glm::ivec3> positions,
+                                 DeletionQueue& frameDeletionQueue) {
+    if (positions.empty() && _dirtyRegions.empty() && _regionJobs.empty() &&
+        _splittingRegions.empty()) {
+        return;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    _remeshStats = {};
+
+    std::vector<MeshJob> jobs;
+    jobs.reserve(positions.size());
+    for (const glm::ivec3& pos : positions) {
+        const Chunk* chunk = world.findChunk(pos);
+        if (chunk == nullptr) {
+            // Unloaded, stop drawing it
+            auto it = _chunkMeshes.find(pos);
+            if (it != _chunkMeshes.end()) {
+                releaseMesh(_chunkMeshes, it, frameDeletionQueue);
             }
-            return z < other.z;
+            markRegionDirty(pos);
+            continue;
+        }
+        if (ChunkRegion::isMerged(ChunkRegion::regionOf(pos), _lodCenter)) {
+            // Drawn as part of its region, which picks the change up when rebuilt
+            markRegionDirty(pos);
+            continue;
+        }
+        // Every neighbour border at the level that neighbour is drawn at
+        std::array<const Chunk*, 6> neighbors{};
+        std::array<int, 6> neighborLevels{};
+        for (size_t side = 0; side < NEIGHBOR_OFFSETS.size(); side++) {
+            const glm::ivec3 neighbor = pos + NEIGHBOR_OFFSETS.at(side);
+            neighbors.at(side) = world.findChunk(neighbor);
+            neighborLevels.at(side) = ChunkRegion::drawnLevel(neighbor, _lodCenter);
+        }
+        const int level = ChunkLod::selectLevel(pos, _lodCenter);
+        jobs.push_back(MeshJob{.position = pos,
+                               .snapshot = std::make_unique<ChunkSnapshot>(
+                                   *chunk, level, neighbors, neighborLevels),
+                               .quads = {},
+                               .faceQuadCounts = {},
+                               .level = level,
+                               .region = nullptr});
+    }
+    const auto meshStart = std::chrono::steady_clock::now();
+    meshInParallel(jobs);
+    _meshStats.meshTimeMs += std::chrono::duration<double, std::milli>(
+                                 std::chrono::steady_clock::now() - meshStart)
+                                 .count();
+
+    // Uploads stay on this thread, GPU submission is not thread-safe
+    for (MeshJob& job : jobs) {
+        _remeshStats.remeshedChunks++;
+        _meshStats.meshedChunks++;
+        storeMesh(_chunkMeshes, job, glm::vec3(job.position * Chunk::CHUNK_SIZE), 1.0F,
+                  frameDeletionQueue);
+        auto splitting = _splittingRegions.find(ChunkRegion::regionOf(job.position));
+        if (splitting != _splittingRegions.end()) {
+            splitting->second.erase(job.position);
         }
-    };
-
-    // --- PART 1: Create all chunk data first ---
-    std::map<ChunkPos, std::unique_ptr<Chunk>> worldChunks;
-
-    _chunkPositions.clear();
-    const int renderDistance = 32; // Create a 64x64 grid of chunks
-    for (int x = -renderDistance; x < renderDistance; ++x) {
-        for (int z = -renderDistance; z < renderDistance; ++z) {
-            // All chunks are at y=0 for this test
-            ChunkPos pos = {x, 0, z};
-            _chunkPositions.push_back(
-                glm::vec3(x * Chunk::CHUNK_SIZE, 0.0F, z * Chunk::CHUNK_SIZE));
-
-            // Create a new chunk and generate its block data
-            auto chunk = std::make_unique<Chunk>();
-
-            // Fill with some blocks for testing (staircase-like pattern)
-            for (int bx = 0; bx < 32; bx++) {
-                for (int bz = 0; bz < 32; bz++) {
-                    int height = (bx + bz) / 2;
-                    for (int by = 0; by < height && by < 32; by++) {
-                        if (by < height - 5) {
-                            chunk->setBlock(bx, by, bz, 1); // stone
-                        } else if (by < height - 1) {
-                            chunk->setBlock(bx, by, bz, 2); // grass_block
-                        } else if (by < height && (bx % 3 == 0) && (bz % 3 == 0)) {
-                            chunk->setBlock(bx, by, bz, 4); // water
-                        } else if (by < height) {
-                            chunk->setBlock(bx, by, bz, 3); // oak_wood (some trees)
-                        } else {
-                            chunk->setBlock(bx, by, bz, 0); // air
+    }
+    releaseSplitRegions(world, frameDeletionQueue);
+    rebuildDirtyRegions(world, frameDeletionQueue);
+
+    _remeshStats.remeshTimeMs =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+            .count();
+}
+
+void VoxelRenderer::releaseSplitRegions(const ChunkInstanciator& world,
+                                        DeletionQueue& frameDeletionQueue) {
+    for (auto it = _splittingRegions.begin(); it != _splittingRegions.end();) {
+        // Unloaded members will not be meshed, and are not drawn by the region either
+        std::erase_if(it->second, [&](const glm::ivec3& member) {
+            return world.findChunk(member) == nullptr;
+        });
+        if (!it->second.empty()) {
+            ++it;
+            continue;
+        }
+        auto mesh = _regionMeshes.find(it->first);
+        if (mesh != _regionMeshes.end()) {
+            releaseMesh(_regionMeshes, mesh, frameDeletionQueue);
+        }
+        it = _splittingRegions.erase(it);
+    }
+}
+
+void VoxelRenderer::rebuildDirtyRegions(const ChunkInstanciator& world,
+                                        DeletionQueue& frameDeletionQueue) {
+    for (auto it = _regionJobs.begin(); it != _regionJobs.end();) {
+        if (!it->second->counter.isDone()) {
+            ++it;
+            continue;
+        }
+        MeshJob& job = it->second->job;
+        // Split while it was being built: its members are meshed on their own instead
+        if (ChunkRegion::isMerged(job.position, _lodCenter)) {
+            const glm::ivec3 first = ChunkRegion::firstChunkOf(job.position);
+            storeMesh(_regionMeshes, job, glm::vec3(first * Chunk::CHUNK_SIZE),
+                      static_cast<float>(ChunkRegion::SIZE), frameDeletionQueue);
+            // Members were left drawn on their own until now, so no gap opens meanwhile
+            for (int z = 0; z < ChunkRegion::SIZE; z++) {
+                for (int y = 0; y < ChunkRegion::SIZE; y++) {
+                    for (int x = 0; x < ChunkRegion::SIZE; x++) {
+                        auto member = _chunkMeshes.find(first + glm::ivec3(x, y, z));
+                        if (member != _chunkMeshes.end()) {
+                            releaseMesh(_chunkMeshes, member, frameDeletionQueue);
                         }
                     }
                 }
             }
-            worldChunks[pos] = std::move(chunk);
         }
+        it = _regionJobs.erase(it);
     }
 
-    // --- PART 2: Generate meshes for all chunks, now with neighbor data ---
-    _meshPool->reset(); // Reset the pool before generating new meshes
-
-    for (const auto& [pos, chunk] : worldChunks) {
-        // Find the 6 neighbors for the current chunk
-        auto findNeighbor = [&](int dx, int dy, int dz) -> const Chunk* {
-            auto it = worldChunks.find({pos.x + dx, pos.y + dy, pos.z + dz});
-            return (it != worldChunks.end()) ? it->second.get() : nullptr;
-        };
-
-        const Chunk* neighborNorth = findNeighbor(0, 0, 1);
-        const Chunk* neighborSouth = findNeighbor(0, 0, -1);
-        const Chunk* neighborEast = findNeighbor(1, 0, 0);
-        const Chunk* neighborWest = findNeighbor(-1, 0, 0);
-        const Chunk* neighborTop = findNeighbor(0, 1, 0);     // Always null in our test grid
-        const Chunk* neighborBottom = findNeighbor(0, -1, 0); // Always null in our test grid
-
-        // Generate the mesh for this specific chunk with neighbor awareness
-        std::vector<VoxelVertex> vertices;
-        std::vector<uint32_t> indices;
-        ChunkMesh::generateMesh(*chunk, _blockRegistry, vertices, indices, neighborNorth,
-                                neighborSouth, neighborEast, neighborWest, neighborTop,
-                                neighborBottom);
-
-        if (vertices.empty() || indices.empty()) {
-            continue; // Skip empty meshes
+    for (auto it = _dirtyRegions.begin();
+         it != _dirtyRegions.end() && _regionJobs.size() < MAX_REGION_JOBS_IN_FLIGHT;) {
+        const glm::ivec3 region = *it;
+        if (_regionJobs.contains(region)) {
+            ++it; // Stays dirty, rebuilt again once the current build is swapped in
+            continue;
         }
+        it = _dirtyRegions.erase(it);
+        if (!ChunkRegion::isMerged(region, _lodCenter)) {
+            continue; // The camera came back, its members are meshed on their own
+        }
+        // The snapshot copies the chunks here; the worker only reads the copy
+        auto regionJob = std::make_unique<RegionJob>();
+        regionJob->job = MeshJob{
+            .position = region,
+            .snapshot = nullptr,
+            .quads = {},
+            .faceQuadCounts = {},
+            .level = ChunkRegion::LEVEL,
+            .region = std::make_unique<RegionSnapshot>(region, world, _lodCenter)};
+        _jobSystem->submitBackground(
+            [&job = regionJob->job, &registry = _blockRegistry, mode = _meshingMode]() {
+                runMeshJob(job, registry, mode);
+            },
+            &regionJob->counter);
+        _regionJobs.emplace(region, std::move(regionJob));
+    }
+}
 
-        // Upload this chunk's mesh to the pool
-        // For this test, since all chunks have identical geometry, we only upload once
-        if (_sharedChunkMeshAllocation.indexCount == 0) {
-            _sharedChunkMeshAllocation = _meshPool->uploadMesh(
-                indices, vertices, [this](std::function<void(VkCommandBuffer)>&& func) {
-                    _executor.immediateSubmit(std::move(func));
-                });
+void VoxelRenderer::storeMesh(ChunkMeshMap& meshes, MeshJob& job, const glm::vec3& worldPosition,
+                              float voxelScale, DeletionQueue& frameDeletionQueue) {
+    auto it = meshes.find(job.position);
+    if (job.quads.empty()) {
+        // All air, fully enclosed or dug out: nothing to draw
+        if (it != meshes.end()) {
+            releaseMesh(meshes, it, frameDeletionQueue);
         }
+        return;
     }
 
-    // Safety check in case all meshes were empty
-    if (_sharedChunkMeshAllocation.indexCount == 0) {
-        throw std::runtime_error("Failed to generate chunk mesh: no vertices or indices");
+    if (it == meshes.end()) {
+        const uint32_t slot = allocateCandidateSlot();
+        if (slot == NO_CANDIDATE_SLOT) {
+            return; // Candidate table full, not drawn until its next remesh
+        }
+        it = meshes.emplace(job.position,
+                            ChunkDraw{.mesh = _meshPool->uploadMesh(job.quads,
+                                                                    job.faceQuadCounts),
+                                      .candidateSlot = slot,
+                                      .level = job.level,
+                                      .worldPosition = worldPosition,
+                                      .voxelScale = voxelScale})
+                 .first;
+        _remeshStats.reallocated++;
+    } else {
+        _meshStats.quads -= it->second.mesh.quadCount;
+        _meshStats.meshesPerLevel.at(static_cast<size_t>(it->second.level))--;
+        it->second.level = job.level;
+        if (_meshPool->replaceMesh(it->second.mesh, job.quads, job.faceQuadCounts,
+                                   frameDeletionQueue)) {
+            _remeshStats.inPlace++;
+        } else {
+            _remeshStats.reallocated++;
+        }
     }
+    // Quad counts change even when the mesh stays in place
+    writeCandidateSlot(it->second);
+    _meshStats.quads += job.quads.size();
+    _meshStats.meshesPerLevel.at(static_cast<size_t>(job.level))++;
+    _meshStats.uploadBytes += job.quads.size() * sizeof(VoxelQuad);
+    _meshStats.residentMeshes = _chunkMeshes.size();
+    _meshStats.residentRegions = _regionMeshes.size();
 }
 
-void VoxelRenderer::drawVoxels(VkCommandBuffer cmd, Camera& camera, bool wireframeMode) {
-    const RenderContext::AllocatedImage& drawImage = _context.getDrawImage();
-    const RenderContext::AllocatedImage& depthImage = _context.getDepthImage();
-    VkExtent2D drawExtent = _context.getDrawExtent();
+void VoxelRenderer::compactMeshPool(DeletionQueue& frameDeletionQueue) {
+    if (!_compactionEnabled) {
+        return;
+    }
+    const MeshBufferPool::Stats stats = _meshPool->getStats();
+    if (stats.quads.fragmentation() < COMPACTION_FRAGMENTATION_THRESHOLD) {
+        return;
+    }
+
+    std::vector<ChunkDraw*> liveDraws;
+    liveDraws.reserve(_chunkMeshes.size() + _regionMeshes.size());
+    for (ChunkMeshMap* meshes : {&_chunkMeshes, &_regionMeshes}) {
+        for (auto& [position, draw] : *meshes) {
+            liveDraws.push_back(&draw);
+        }
+    }
+    std::vector<MeshAllocation*> liveMeshes;
+    std::vector<uint32_t> previousFirstQuads;
+    liveMeshes.reserve(liveDraws.size());
+    previousFirstQuads.reserve(liveDraws.size());
+    for (ChunkDraw* draw : liveDraws) {
+        liveMeshes.push_back(&draw->mesh);
+        previousFirstQuads.push_back(draw->mesh.firstQuad);
+    }
+    if (_meshPool->compact(liveMeshes, COMPACTION_BYTES_PER_FRAME, frameDeletionQueue) == 0) {
+        return;
+    }
+
+    // Only the slots of meshes that moved are rewritten
+    for (size_t i = 0; i < liveDraws.size(); i++) {
+        if (liveDraws.at(i)->mesh.firstQuad != previousFirstQuads.at(i)) {
+            writeCandidateSlot(*liveDraws.at(i));
+        }
+    }
+}
+
+uint32_t VoxelRenderer::allocateCandidateSlot() {
+    if (!_freeCandidateSlots.empty()) {
+        const uint32_t slot = _freeCandidateSlots.top();
+        _freeCandidateSlots.pop();
+        return slot;
+    }
+    if (_candidateSlotCount == MAX_CHUNKS) {
+        return NO_CANDIDATE_SLOT;
+    }
+    _drawCandidates.emplace_back();
+    return _candidateSlotCount++;
+}
+
+void VoxelRenderer::releaseCandidateSlot(uint32_t slot) {
+    // All-zero quad counts: the culling shader skips the slot
+    _drawCandidates.at(slot) = GPUDrawCandidate{};
+    _dirtyCandidateSlots.push_back(slot);
+    _freeCandidateSlots.push(slot);
+}
+
+void VoxelRenderer::writeCandidateSlot(const ChunkDraw& draw) {
+    _drawCandidates.at(draw.candidateSlot) =
+        GPUDrawCandidate{.chunkWorldPos = draw.worldPosition,
+                         .firstQuad = draw.mesh.firstQuad,
+                         .faceQuadCounts = draw.mesh.faceQuadCounts,
+                         .voxelScale = draw.voxelScale,
+                         .padding0 = 0};
+    _dirtyCandidateSlots.push_back(draw.candidateSlot);
+}
+
+void VoxelRenderer::uploadDrawCandidates() {
+    if (_dirtyCandidateSlots.empty()) {
+        return;
+    }
+
+    // A slot written several times this frame goes out once, in its final state
+    std::sort(_dirtyCandidateSlots.begin(), _dirtyCandidateSlots.end());
+    _dirtyCandidateSlots.erase(
+        std::unique(_dirtyCandidateSlots.begin(), _dirtyCandidateSlots.end()),
+        _dirtyCandidateSlots.end());
+
+    // One copy per run of consecutive slots. Frames in flight may still be culling them.
+    const std::span<const GPUDrawCandidate> candidates(_drawCandidates);
+    size_t runStart = 0;
+    for (size_t i = 1; i <= _dirtyCandidateSlots.size(); i++) {
+        if (i < _dirtyCandidateSlots.size() &&
+            _dirtyCandidateSlots.at(i) == _dirtyCandidateSlots.at(i - 1) + 1) {
+            continue;
+        }
+        const uint32_t firstSlot = _dirtyCandidateSlots.at(runStart);
+        const uint32_t slotCount = _dirtyCandidateSlots.at(i - 1) - firstSlot + 1;
+        _uploadManager.enqueueUpload(_drawCandidateBuffer.buffer,
+                                     VkDeviceSize{firstSlot} * sizeof(GPUDrawCandidate),
+                                     std::as_bytes(candidates.subspan(firstSlot, slotCount)),
+                                     true);
+        runStart = i;
+    }
+    _dirtyCandidateSlots.clear();
+}
 
-    // --- PREPARE MDI DATA ON CPU ---
-    _indirectCommands.clear();
-    _chunkDrawData.clear();
+void VoxelRenderer::recordCullingPass(VkCommandBuffer cmd, const glm::mat4& viewProjection,
+                                      const glm::vec3& cameraPosition, uint32_t phase) {
+    const VkExtent2D pyramidExtent = _depthPyramid->getExtent();
+    CullPushConstants pushConstants{
+        .viewProjection = viewProjection,
+        .cameraPosition = cameraPosition,
+        .candidateCount = _candidateSlotCount,
+        .pyramidSize = glm::vec2(static_cast<float>(pyramidExtent.width),
+                                 static_cast<float>(pyramidExtent.height)),
+        .phase = phase,
+        .drawOffset = phase * MAX_DRAWS,
+        .occlusionEnabled = _occlusionCullingEnabled ? 1U : 0U};
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, _cullPipeline.getPipeline());
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, _cullPipeline.getLayout(), 0, 1,
+                            &_cullDescriptorSet, 0, nullptr);
+    vkCmdPushConstants(cmd, _cullPipeline.getLayout(), VK_SHADER_STAGE_COMPUTE_BIT, 0,
+                       sizeof(CullPushConstants), &pushConstants);
+    vkCmdDispatch(cmd, (_candidateSlotCount + CULL_WORKGROUP_SIZE - 1) / CULL_WORKGROUP_SIZE,
+                  1, 1);
+
+    _executor.memoryBarrier(cmd, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                            VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+                            VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT |
+                                VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT |
+                                VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT |
+                                VK_PIPELINE_STAGE_2_COPY_BIT,
+                            VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT |
+                                VK_ACCESS_2_SHADER_STORAGE_READ_BIT |
+                                VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT |
+                                VK_ACCESS_2_TRANSFER_READ_BIT);
+}
 
-    _indirectCommands.reserve(_chunkPositions.size());
-    _chunkDrawData.reserve(_chunkPositions.size());
+void VoxelRenderer::collectCullStats() {
+    // This slot was last used FRAME_OVERLAP frames ago, whose fence has been waited on
+    CullReadback& readback = _cullReadbacks.at(_cullFrame % _cullReadbacks.size());
+    if (!readback.pending) {
+        return;
+    }
+    readback.pending = false;
+
+    vmaInvalidateAllocation(_device.getAllocator(), readback.buffer.allocation, 0,
+                            VK_WHOLE_SIZE);
+    GPUCullCounters counters{};
+    std::memcpy(&counters, readback.buffer.info.pMappedData, sizeof(GPUCullCounters));
+    _cullStats = CullStats{.tested = readback.candidateCount,
+                           .frustumCulled = counters.frustumCulled,
+                           .occlusionCulled = counters.occlusionCulled,
+                           .drawnEarly = counters.earlyDrawCount,
+                           .drawnLate = counters.lateDrawCount,
+                           .backFacingSkipped = counters.backFacingSkipped};
+}
 
-    // Iterate over all chunk positions and build the command list
-    // All chunks share the same mesh geometry, but render at different positions
-    for (size_t i = 0; i < _chunkPositions.size(); ++i) {
-        // Create the indirect command. The geometry data is the same for all.
-        VkDrawIndexedIndirectCommand indirectCmd{};
-        indirectCmd.indexCount = _sharedChunkMeshAllocation.indexCount;
-        indirectCmd.instanceCount = 1; // Always 1 instance per draw command in MDI
-        indirectCmd.firstIndex = _sharedChunkMeshAllocation.firstIndex;
-        indirectCmd.vertexOffset = _sharedChunkMeshAllocation.vertexOffset;
-        indirectCmd.firstInstance = 0; // Set to 0 because we use gl_DrawID in the shader
-        _indirectCommands.push_back(indirectCmd);
+MeshBufferPool::Stats VoxelRenderer::getMeshPoolStats() const {
+    return _meshPool->getStats();
+}
 
-        // Create the per-chunk data (its world position)
-        GPUChunkData chunkData{};
-        chunkData.chunkWorldPos = _chunkPositions[i];
-        chunkData.padding = 0.0F;
-        _chunkDrawData.push_back(chunkData);
+void VoxelRenderer::setMeshingMode(ChunkMesh::MeshingMode mode) {
+    if (mode == _meshingMode) {
+        return;
     }
+    _meshingMode = mode;
+}
+
+void VoxelRenderer::drawVoxels(VkCommandBuffer cmd, Camera& camera, bool wireframeMode,
+                               GpuProfiler& gpuProfiler) {
+    VkExtent2D drawExtent = _context.getDrawExtent();
+
+    collectCullStats();
+    CullReadback& readback = _cullReadbacks.at(_cullFrame++ % _cullReadbacks.size());
 
     // Early exit if nothing to draw
-    if (_indirectCommands.empty()) {
+    if (_candidateSlotCount == 0) {
         return;
     }
 
-    // Upload data to GPU buffers
-    _bufferManager.uploadToBuffer(_indirectBuffer, _indirectCommands.data(),
-                                  _indirectCommands.size() * sizeof(VkDrawIndexedIndirectCommand));
-    _bufferManager.uploadToBuffer(_chunkDataBuffer, _chunkDrawData.data(),
-                                  _chunkDrawData.size() * sizeof(GPUChunkData));
+    // Set up view-projection matrix
+    glm::mat4 view = camera.getViewMatrix();
+
+    // Standard perspective projection for Vulkan
+    glm::mat4 projection = glm::perspective(
+        glm::radians(80.0F),
+        static_cast<float>(drawExtent.width) / static_cast<float>(drawExtent.height),
+        0.1F,    // near plane
+        10000.0F // far plane
+    );
+    projection[1][1] *= -1.0F; // Flip Y for Vulkan coordinate system
+
+    glm::mat4 viewProjection = projection * view;
+
+    // --- CULLING ON THE GPU, IN TWO PHASES ---
+    // Counters restart from zero once the previous frame is done reading them
+    _executor.memoryBarrier(cmd,
+                            VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT |
+                                VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT |
+                                VK_PIPELINE_STAGE_2_COPY_BIT,
+                            VK_ACCESS_2_NONE,
+                            VK_PIPELINE_STAGE_2_CLEAR_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                            VK_ACCESS_2_TRANSFER_WRITE_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+    vkCmdFillBuffer(cmd, _cullCounterBuffer.buffer, 0, sizeof(GPUCullCounters), 0);
+    _executor.memoryBarrier(cmd, VK_PIPELINE_STAGE_2_CLEAR_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                            VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                            VK_ACCESS_2_SHADER_STORAGE_READ_BIT |
+                                VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+
+    // Early: what was visible last frame, which is most of what is visible now
+    {
+        const GpuProfiler::Scope scope(gpuProfiler, cmd, "Cull early");
+        recordCullingPass(cmd, viewProjection, camera.getPosition(), CULL_PHASE_EARLY);
+    }
+    {
+        const GpuProfiler::Scope scope(gpuProfiler, cmd, "Draw early");
+        recordDrawPass(cmd, viewProjection, CULL_PHASE_EARLY, wireframeMode);
+    }
+
+    // Late: test everything else against the depth those draws left
+    if (_occlusionCullingEnabled) {
+        const GpuProfiler::Scope scope(gpuProfiler, cmd, "Depth pyramid");
+        _depthPyramid->build(cmd, _context.getDepthImage().image);
+    }
+    {
+        const GpuProfiler::Scope scope(gpuProfiler, cmd, "Cull late");
+        recordCullingPass(cmd, viewProjection, camera.getPosition(), CULL_PHASE_LATE);
+    }
+
+    const VkBufferCopy counterCopy{.srcOffset = 0, .dstOffset = 0, .size = sizeof(GPUCullCounters)};
+    vkCmdCopyBuffer(cmd, _cullCounterBuffer.buffer, readback.buffer.buffer, 1, &counterCopy);
+    readback.candidateCount = static_cast<uint32_t>(getDrawCandidateCount());
+    readback.pending = true;
+
+    const GpuProfiler::Scope scope(gpuProfiler, cmd, "Draw late");
+    recordDrawPass(cmd, viewProjection, CULL_PHASE_LATE, wireframeMode);
+}
+
+void VoxelRenderer::recordDrawPass(VkCommandBuffer cmd, const glm::mat4& viewProjection,
+                                   uint32_t phase, bool wireframeMode) {
+    const RenderContext::AllocatedImage& drawImage = _context.getDrawImage();
+    const RenderContext::AllocatedImage& depthImage = _context.getDepthImage();
+    VkExtent2D drawExtent = _context.getDrawExtent();
+
+    // The late pass draws on top of the early one
+    const VkAttachmentLoadOp loadOp =
+        (phase == CULL_PHASE_EARLY) ? VK_ATTACHMENT_LOAD_OP_CLEAR : VK_ATTACHMENT_LOAD_OP_LOAD;
 
     // --- BEGIN RENDERING ---
     VkRenderingAttachmentInfo colorAttachment{
@@ -308,7 +824,7 @@ void VoxelRenderer::drawVoxels(VkCommandBuffer cmd, Camera& camera, bool wirefra
         .resolveMode = VK_RESOLVE_MODE_NONE,
         .resolveImageView = VK_NULL_HANDLE,
         .resolveImageLayout = VK_IMAGE_LAYOUT_UNDEFINED,
-        .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+        .loadOp = loadOp,
         .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
         .clearValue = {.color = {.float32 = {0.1F, 0.2F, 0.3F, 1.0F}}}};
 
@@ -320,7 +836,7 @@ void VoxelRenderer::drawVoxels(VkCommandBuffer cmd, Camera& camera, bool wirefra
         .resolveMode = VK_RESOLVE_MODE_NONE,
         .resolveImageView = VK_NULL_HANDLE,
         .resolveImageLayout = VK_IMAGE_LAYOUT_UNDEFINED,
-        .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+        .loadOp = loadOp,
         .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
         .clearValue = {.depthStencil = {.depth = 1.0F, .stencil = 0}}};
 
@@ -358,35 +874,20 @@ void VoxelRenderer::drawVoxels(VkCommandBuffer cmd, Camera& camera, bool wirefra
     vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, _voxelPipeline.getLayout(), 0, 1,
                             &_chunkDescriptorSet, 0, nullptr);
 
-    // Set up view-projection matrix
-    glm::mat4 view = camera.getViewMatrix();
-
-    // Standard perspective projection for Vulkan
-    glm::mat4 projection = glm::perspective(
-        glm::radians(80.0F),
-        static_cast<float>(drawExtent.width) / static_cast<float>(drawExtent.height),
-        0.1F,    // near plane
-        10000.0F // far plane
-    );
-    projection[1][1] *= -1.0F; // Flip Y for Vulkan coordinate system
-
-    glm::mat4 viewProjection = projection * view;
-
-    // Push constants now only contain GLOBAL data (view-projection matrix)
+    // Global data: view-projection, and where this phase's chunk data starts
+    DrawPushConstants pushConstants{.viewProjection = viewProjection,
+                                    .drawOffset = phase * MAX_DRAWS};
     vkCmdPushConstants(cmd, _voxelPipeline.getLayout(), VK_SHADER_STAGE_VERTEX_BIT, 0,
-                       sizeof(glm::mat4), &viewProjection);
-
-    // These contain ALL chunk mesh data, indexed by the indirect commands
-    VkBuffer vertexBuffer = _meshPool->getVertexBuffer();
-    VkBuffer indexBuffer = _meshPool->getIndexBuffer();
-    VkDeviceSize offset = 0;
-    vkCmdBindVertexBuffers(cmd, 0, 1, &vertexBuffer, &offset);
-    vkCmdBindIndexBuffer(cmd, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
-
-    // Multi-Draw Indirect
-    vkCmdDrawIndexedIndirect(cmd, _indirectBuffer.buffer, 0,
-                             static_cast<uint32_t>(_indirectCommands.size()),
-                             sizeof(VkDrawIndexedIndirectCommand));
+                       sizeof(DrawPushConstants), &pushConstants);
+
+    // Multi-Draw Indirect, with the count the culling pass wrote. The commands'
+    // firstVertex points into the quad buffer bound with the chunk data.
+    const VkDeviceSize commandOffset =
+        VkDeviceSize{phase} * MAX_DRAWS * sizeof(VkDrawIndirectCommand);
+    const VkDeviceSize countOffset = VkDeviceSize{phase} * sizeof(uint32_t);
+    vkCmdDrawIndirectCount(cmd, _indirectBuffer.buffer, commandOffset, _cullCounterBuffer.buffer,
+                           countOffset, _candidateSlotCount * FACE_DIRECTION_COUNT,
+                           sizeof(VkDrawIndirectCommand));
 
     vkCmdEndRendering(cmd);
 }
@@ -1,15 +1,26 @@
 #pragma once
 
+#include <array>
+#include <functional>
 #include <memory>
+#include <queue>
+#include <span>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include <vulkan/vulkan.h>
 
 #include <glm/glm.hpp>
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtx/hash.hpp>
 
 #include "../Core/VulkanTypes.hpp"
 #include "../Pipeline/Pipeline.hpp"
+#include "../Rendering/FrameManager.hpp"
 #include "common/Types/RenderTypes.hpp"
+#include "common/World/ChunkLod.hpp"
+#include "common/World/ChunkMesh.hpp"
 #include "MeshBufferPool.hpp"
 
 class VulkanDevice;
@@ -21,14 +32,74 @@ class RenderContext;
 class CommandExecutor;
 class MeshBufferPool;
 class VulkanBuffer;
+class UploadManager;
 class DescriptorAllocatorGrowable;
+class DeletionQueue;
+class JobSystem;
+class ChunkInstanciator;
+class ChunkSnapshot;
+class RegionSnapshot;
+class DepthPyramid;
+class GpuProfiler;
 struct MeshAllocation;
 
 class VoxelRenderer {
   public:
+    // Chunks snapshotted and meshed per wave of parallel jobs
+    static constexpr size_t MESH_BATCH_SIZE = 256;
+    // Far regions being rebuilt at once at most. Each downsamples 64 chunks on one worker
+    // (~20 ms) as a background job, swapped in on a later frame once it is done, so the
+    // render thread never waits for one.
+    static constexpr size_t MAX_REGION_JOBS_IN_FLIGHT = 2;
+    // Capacity of the candidate table: chunks near the camera plus merged regions
+    static constexpr uint32_t MAX_CHUNKS = 16384;
+    static constexpr uint32_t NO_CANDIDATE_SLOT = UINT32_MAX;
+    // Capacity of each phase's draw list: one draw per face direction of a chunk
+    static constexpr uint32_t MAX_DRAWS = MAX_CHUNKS * FACE_DIRECTION_COUNT;
+    // Must match local_size_x and the PHASE_ constants in chunk_cull.comp
+    static constexpr uint32_t CULL_WORKGROUP_SIZE = 64;
+    static constexpr uint32_t CULL_PHASE_EARLY = 0;
+    static constexpr uint32_t CULL_PHASE_LATE = 1;
+    static constexpr uint32_t CULL_PHASES = 2; // Each has its own draw list
+    // Background compaction: runs once the free space is this fragmented,
+    // moving at most COMPACTION_BYTES_PER_FRAME of meshes per frame
+    static constexpr float COMPACTION_FRAGMENTATION_THRESHOLD = 0.25F;
+    static constexpr VkDeviceSize COMPACTION_BYTES_PER_FRAME = VkDeviceSize{4} * 1024 * 1024;
+
+    // Streamed chunk meshes, shown in the debug overlay
+    struct MeshStats {
+        size_t residentMeshes = 0;  // Chunks, without regions
+        size_t residentRegions = 0; // Counted at their level in meshesPerLevel
+        std::array<size_t, ChunkLod::MAX_LEVEL + 1> meshesPerLevel{};
+        size_t quads = 0;        // In the resident meshes
+        size_t meshedChunks = 0; // Totals since startup, for throughput
+        size_t uploadBytes = 0;
+        double meshTimeMs = 0.0;
+    };
+
+    // Last batch of incremental remeshes after block edits
+    struct RemeshStats {
+        size_t remeshedChunks = 0;
+        size_t inPlace = 0;     // Rewritten inside their existing GPU allocation
+        size_t reallocated = 0; // Outgrew it and moved to a new range
+        double remeshTimeMs = 0.0;
+    };
+
+    // GPU culling results, read back a few frames late
+    struct CullStats {
+        uint32_t tested = 0;
+        uint32_t frustumCulled = 0;
+        uint32_t occlusionCulled = 0;
+        // Draws, one per direction range that faces the camera
+        uint32_t drawnEarly = 0; // Chunks visible last frame
+        uint32_t drawnLate = 0;  // Newly visible, found by the occlusion test
+        uint32_t backFacingSkipped = 0;
+    };
+
     VoxelRenderer(VulkanDevice& device, MeshManager& meshManager, BlockRegistry& registry,
                   RenderContext& context, CommandExecutor& executor, VulkanBuffer& bufferManager,
-                  DescriptorAllocatorGrowable& descriptorAllocator);
+                  UploadManager& uploadManager, DescriptorAllocatorGrowable& descriptorAllocator,
+                  unsigned int meshingThreads = 0);
     ~VoxelRenderer();
 
     VoxelRenderer(const VoxelRenderer&) = delete;
@@ -37,11 +108,110 @@ class VoxelRenderer {
     VoxelRenderer& operator=(VoxelRenderer&&) = delete;
 
     void initPipelines();
-    void initTestChunk();
-    void drawVoxels(VkCommandBuffer cmd, Camera& camera, bool wireframeMode);
+    // Culls the chunks on the GPU, then draws the survivors. Two phases: last frame's
+    // visible set first, then whatever the depth it left does not hide. Each pass is
+    // timed on the GPU.
+    void drawVoxels(VkCommandBuffer cmd, Camera& camera, bool wireframeMode,
+                    GpuProfiler& gpuProfiler);
+    // Rebuilds the depth pyramid for RenderContext's depth image. The device must be idle.
+    void onDrawImagesResized();
+    // Uploads the candidate slots written since the last call (meshes added, moved or
+    // dropped), nothing else. Call before UploadManager::flush().
+    void uploadDrawCandidates();
+    [[nodiscard]] size_t getDrawCandidateCount() const {
+        return _candidateSlotCount - _freeCandidateSlots.size();
+    }
+    [[nodiscard]] const CullStats& getCullStats() const { return _cullStats; }
+    // Without occlusion culling only the frustum test remains
+    void setOcclusionCullingEnabled(bool enabled) { _occlusionCullingEnabled = enabled; }
+    [[nodiscard]] bool isOcclusionCullingEnabled() const { return _occlusionCullingEnabled; }
+
+    // Switches mesher for the meshes built from now on. Existing ones are only replaced
+    // when their chunks are remeshed, see Renderer::setMeshingMode.
+    void setMeshingMode(ChunkMesh::MeshingMode mode);
+    [[nodiscard]] ChunkMesh::MeshingMode getMeshingMode() const { return _meshingMode; }
+    [[nodiscard]] const MeshStats& getMeshStats() const { return _meshStats; }
+
+    // (Re)builds the meshes of the given chunks (from ChunkInstanciator::takeRemeshQueue):
+    // new chunks get a range in the mesh pool, known ones are overwritten.
+    // Ranges that are given up are released through the current frame's deletion queue.
+    // Regions marked dirty by earlier calls are rebuilt in the background, started and
+    // swapped in here.
+    void remeshChunks(const ChunkInstanciator& world, std::span<const glm::ivec3> positions,
+                      DeletionQueue& frameDeletionQueue);
+    // Moves the centre of the level-of-detail rings to the camera's chunk. Returns the
+    // meshed chunks whose level changed or that now belong to a merged region, plus their
+    // neighbours (their borders are taken at that level), to be queued for a remesh.
+    // Regions that are no longer merged have their members returned as well, and stay
+    // drawn until every member has its own mesh (or is unloaded).
+    // Empty while the camera stays in the same chunk.
+    std::vector<glm::ivec3> updateLodCenter(const glm::vec3& cameraPosition,
+                                            DeletionQueue& frameDeletionQueue);
+    // Stops drawing unloaded chunks (from ChunkInstanciator::takeUnloadedChunks)
+    void releaseChunkMeshes(std::span<const glm::ivec3> positions,
+                            DeletionQueue& frameDeletionQueue);
+    [[nodiscard]] const RemeshStats& getRemeshStats() const { return _remeshStats; }
+
+    // One budgeted step of mesh pool compaction, if enabled and fragmented enough
+    void compactMeshPool(DeletionQueue& frameDeletionQueue);
+    void setCompactionEnabled(bool enabled) { _compactionEnabled = enabled; }
+    [[nodiscard]] bool isCompactionEnabled() const { return _compactionEnabled; }
+    [[nodiscard]] MeshBufferPool::Stats getMeshPoolStats() const;
 
   private:
+    // A chunk's or a region's mesh and the candidate slot that draws it
+    struct ChunkDraw {
+        MeshAllocation mesh;
+        uint32_t candidateSlot = NO_CANDIDATE_SLOT;
+        int level = 0; // ChunkLod level the mesh was built at
+        glm::vec3 worldPosition{0.0F};
+        float voxelScale = 1.0F; // ChunkRegion::SIZE for regions
+    };
+    using ChunkMeshMap = std::unordered_map<glm::ivec3, ChunkDraw>;
+
+    struct MeshJob {
+        glm::ivec3 position;
+        std::unique_ptr<ChunkSnapshot> snapshot;
+        std::vector<VoxelQuad> quads;
+        FaceQuadCounts faceQuadCounts{};
+        int level = 0;
+        // Set for region jobs: resolved into `snapshot` on the worker
+        std::unique_ptr<RegionSnapshot> region;
+    };
+
     void initMDI();
+    void initCulling();
+    // Appends the phase's visible chunks to its draw list, counted in _cullCounterBuffer
+    void recordCullingPass(VkCommandBuffer cmd, const glm::mat4& viewProjection,
+                           const glm::vec3& cameraPosition, uint32_t phase);
+    void recordDrawPass(VkCommandBuffer cmd, const glm::mat4& viewProjection, uint32_t phase,
+                        bool wireframeMode);
+    void collectCullStats();
+    // A region mesh being built in the background (defined in the .cpp)
+    struct RegionJob;
+
+    // Resolves the job's region snapshot if any, then meshes it
+    static void runMeshJob(MeshJob& job, const BlockRegistry& registry,
+                           ChunkMesh::MeshingMode mode);
+    // Meshes every job on the job system and returns once all are done
+    void meshInParallel(std::vector<MeshJob>& jobs);
+    // Swaps in the region meshes finished since the last call, then starts background
+    // jobs for dirty regions, up to MAX_REGION_JOBS_IN_FLIGHT
+    void rebuildDirtyRegions(const ChunkInstanciator& world, DeletionQueue& frameDeletionQueue);
+    // Stops drawing the split regions whose members all have their own mesh by now
+    void releaseSplitRegions(const ChunkInstanciator& world, DeletionQueue& frameDeletionQueue);
+    // Uploads a finished job into `meshes` (or drops the entry when it came out empty)
+    void storeMesh(ChunkMeshMap& meshes, MeshJob& job, const glm::vec3& worldPosition,
+                   float voxelScale, DeletionQueue& frameDeletionQueue);
+    void releaseMesh(ChunkMeshMap& meshes, ChunkMeshMap::iterator it,
+                     DeletionQueue& frameDeletionQueue);
+    // Marks the region of a chunk for a rebuild if it is merged
+    void markRegionDirty(const glm::ivec3& chunkPosition);
+    // NO_CANDIDATE_SLOT when the table is full
+    uint32_t allocateCandidateSlot();
+    void releaseCandidateSlot(uint32_t slot);
+    // Marks the slot for the next uploadDrawCandidates()
+    void writeCandidateSlot(const ChunkDraw& draw);
 
     VulkanDevice& _device;
     MeshManager& _meshManager;
@@ -49,31 +219,71 @@ class VoxelRenderer {
     RenderContext& _context;
     CommandExecutor& _executor;
     VulkanBuffer& _bufferManager;
+    UploadManager& _uploadManager;
     DescriptorAllocatorGrowable& _descriptorAllocator;
 
     Pipeline _voxelPipeline;
     Pipeline _voxelWireframePipeline;
+    Pipeline _cullPipeline;
 
     VkPipelineLayout _voxelPipelineLayout = VK_NULL_HANDLE;
 
-    std::unique_ptr<Chunk> _testChunk;
+    ChunkMesh::MeshingMode _meshingMode = ChunkMesh::MeshingMode::Binary;
+    std::unique_ptr<JobSystem> _jobSystem;
+    MeshStats _meshStats;
+    RemeshStats _remeshStats;
 
     // --- MDI Resources ---
     std::unique_ptr<MeshBufferPool> _meshPool;
+    bool _compactionEnabled = true;
 
-    // This mesh data will be shared by all chunk instances
-    MeshAllocation _sharedChunkMeshAllocation;
-
-    // A list of world positions for each chunk instance we want to draw
-    std::vector<glm::vec3> _chunkPositions;
+    // Mesh of every loaded chunk that has faces, keyed by chunk coordinate. Chunks in
+    // merged regions have none: they are drawn by their region's mesh instead.
+    ChunkMeshMap _chunkMeshes;
+    // Merged region meshes, keyed by region coordinate
+    ChunkMeshMap _regionMeshes;
+    // Merged regions whose members changed, rebuilt lazily by remeshChunks()
+    std::unordered_set<glm::ivec3> _dirtyRegions;
+    // Region meshes being built, keyed by region coordinate
+    std::unordered_map<glm::ivec3, std::unique_ptr<RegionJob>> _regionJobs;
+    // Regions no longer merged but still drawn, with the members not meshed on their own
+    // yet. The region mesh goes once the set is empty, so splitting opens no gap.
+    std::unordered_map<glm::ivec3, std::unordered_set<glm::ivec3>> _splittingRegions;
+    // Camera chunk the level of each mesh is selected from
+    glm::ivec3 _lodCenter{0, 0, 0};
 
+    // Written by the culling passes every frame, one compacted list per phase
     AllocatedBuffer _indirectBuffer;
     AllocatedBuffer _chunkDataBuffer;
+    AllocatedBuffer _cullCounterBuffer; // GPUCullCounters
+    AllocatedBuffer _visibilityBuffer;  // Per candidate, carried over to the next frame
+    std::unique_ptr<DepthPyramid> _depthPyramid;
+    bool _occlusionCullingEnabled = true;
+
+    // Counters copied out each frame, read once that frame's fence has signalled
+    struct CullReadback {
+        AllocatedBuffer buffer{};
+        uint32_t candidateCount = 0;
+        bool pending = false;
+    };
+    std::array<CullReadback, FrameManager::FRAME_OVERLAP> _cullReadbacks;
+    uint64_t _cullFrame = 0;
+    CullStats _cullStats;
 
-    std::vector<VkDrawIndexedIndirectCommand> _indirectCommands;
-    std::vector<GPUChunkData> _chunkDrawData;
+    // Persistent candidate table, one slot per chunk mesh. Adding, moving or dropping a
+    // mesh rewrites its slot only, so the per-frame upload scales with the changes.
+    AllocatedBuffer _drawCandidateBuffer;
+    std::vector<GPUDrawCandidate> _drawCandidates; // CPU copy of the slots handed out
+    // Lowest first, so live slots stay packed at the front of the dispatch range
+    std::priority_queue<uint32_t, std::vector<uint32_t>, std::greater<>> _freeCandidateSlots;
+    std::vector<uint32_t> _dirtyCandidateSlots;
+    uint32_t _candidateSlotCount = 0; // Slots ever handed out, the culling dispatch size
 
-    // Descriptor set for chunk data SSBO
+    // Descriptor set for the chunk data and quad SSBOs
     VkDescriptorSetLayout _chunkSetLayout = VK_NULL_HANDLE;
     VkDescriptorSet _chunkDescriptorSet = VK_NULL_HANDLE;
+
+    // Culling pass: candidates in, indirect commands, chunk data and count out
+    VkDescriptorSetLayout _cullSetLayout = VK_NULL_HANDLE;
+    VkDescriptorSet _cullDescriptorSet = VK_NULL_HANDLE;
 };
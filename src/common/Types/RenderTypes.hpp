@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
 
 #include <glm/glm.hpp>
@@ -13,9 +14,21 @@ struct Vertex {
     glm::vec4 color;
 };
 
-// --- PACKED VERTEX DATA ---
-// Bit layout: [X:6][Y:6][Z:6][Normal:3][UV:2][Texture:7][Spare:2]
-using VoxelVertex = uint32_t;
+// --- PACKED QUAD DATA ---
+// One record per face rectangle. There are no vertex or index buffers: voxel.vert reads
+// the record of quad gl_VertexIndex / 6 and builds that vertex of its two triangles.
+// Draw commands are only written by chunk_cull.comp, which owns the 6 vertices per quad.
+// geometry bit layout: [X:5][Y:5][Z:5][Normal:3][Width-1:5][Height-1:5][Spare:4]
+// texture bit layout:  [Texture:7][Spare:25]
+struct VoxelQuad {
+    uint32_t geometry;
+    uint32_t texture;
+};
+
+// Face directions, indexed by a quad's Normal ID: +X, -X, +Y, -Y, +Z, -Z.
+// Chunk meshes keep their quads grouped in that order, one range per direction.
+constexpr uint32_t FACE_DIRECTION_COUNT = 6;
+using FaceQuadCounts = std::array<uint32_t, FACE_DIRECTION_COUNT>;
 
 // Push constants for chunk/voxel rendering
 struct ChunkPushConstants {
@@ -28,5 +41,42 @@ struct ChunkPushConstants {
 // This will be stored in an SSBO and indexed by gl_DrawID
 struct GPUChunkData {
     glm::vec3 chunkWorldPos;
-    float padding; // Align to 16 bytes
+    float voxelScale; // World size of a mesh voxel: 1 for chunks, more for merged regions
+};
+
+// One chunk mesh the culling compute shader may draw (std430, see chunk_cull.comp).
+// Each non-empty direction range of a visible candidate that faces the camera becomes
+// a VkDrawIndirectCommand plus a GPUChunkData entry.
+struct GPUDrawCandidate {
+    glm::vec3 chunkWorldPos;
+    uint32_t firstQuad;
+    FaceQuadCounts faceQuadCounts; // Consecutive ranges from firstQuad
+    float voxelScale;              // The mesh covers CHUNK_SIZE * voxelScale per axis
+    uint32_t padding0;
+};
+
+// Push constants for voxel.vert
+struct DrawPushConstants {
+    glm::mat4 viewProjection;
+    uint32_t drawOffset; // First GPUChunkData entry of this draw list
+};
+
+// Push constants for the culling compute shader
+struct CullPushConstants {
+    glm::mat4 viewProjection;
+    glm::vec3 cameraPosition;
+    uint32_t candidateCount;
+    glm::vec2 pyramidSize;
+    uint32_t phase; // 0: last frame's visible set, 1: occlusion test against the pyramid
+    uint32_t drawOffset;
+    uint32_t occlusionEnabled;
+};
+
+// Counters written by the culling shader, in its CounterBuffer layout
+struct GPUCullCounters {
+    uint32_t earlyDrawCount;
+    uint32_t lateDrawCount;
+    uint32_t frustumCulled;
+    uint32_t occlusionCulled;
+    uint32_t backFacingSkipped; // Direction ranges of drawn chunks facing away
 };
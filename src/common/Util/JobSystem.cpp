@@ -0,0 +1,144 @@
+#include "JobSystem.hpp"
+
+#include <algorithm>
+
+namespace {
+// Queue owned by the current thread, set only on worker threads
+thread_local const JobSystem* currentSystem = nullptr;
+thread_local size_t currentQueue = 0;
+} // namespace
+
+JobSystem::JobSystem(unsigned int threadCount) {
+    if (threadCount == 0) {
+        unsigned int hardwareThreads = std::thread::hardware_concurrency();
+        threadCount = std::max(1U, hardwareThreads > 1 ? hardwareThreads - 1 : 1U);
+    }
+
+    _queues.reserve(threadCount);
+    for (unsigned int i = 0; i < threadCount; i++) {
+        _queues.push_back(std::make_unique<WorkQueue>());
+    }
+    _threads.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; i++) {
+        _threads.emplace_back([this, i]() { workerLoop(i); });
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _stopping = true;
+    }
+    _wakeUp.notify_all();
+
+    // Running jobs finish, jobs that never started are dropped with the queues
+    for (auto& thread : _threads) {
+        thread.join();
+    }
+}
+
+void JobSystem::submit(Job job, Counter* counter) {
+    if (counter != nullptr) {
+        counter->_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Jobs spawned by a worker stay local, the others are spread round-robin
+    const size_t queueIndex = currentSystem == this
+                                  ? currentQueue
+                                  : _nextQueue.fetch_add(1, std::memory_order_relaxed) %
+                                        _queues.size();
+    countQueuedJob();
+    {
+        WorkQueue& queue = *_queues[queueIndex];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(QueuedJob{.job = std::move(job), .counter = counter});
+    }
+    _wakeUp.notify_one();
+}
+
+void JobSystem::submitBackground(Job job, Counter* counter) {
+    if (counter != nullptr) {
+        counter->_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+    countQueuedJob();
+    {
+        std::lock_guard<std::mutex> lock(_backgroundQueue.mutex);
+        _backgroundQueue.jobs.push_back(QueuedJob{.job = std::move(job), .counter = counter});
+    }
+    _wakeUp.notify_one();
+}
+
+void JobSystem::countQueuedJob() {
+    // Counted before the push so the count never dips below the real number of jobs,
+    // and under the sleep mutex so a worker cannot miss the wake-up
+    std::lock_guard<std::mutex> lock(_sleepMutex);
+    _queuedJobs.fetch_add(1, std::memory_order_release);
+}
+
+bool JobSystem::tryRunJob(size_t ownQueue, bool allowBackground) {
+    QueuedJob job;
+    bool found = false;
+
+    for (size_t attempt = 0; attempt < _queues.size() && !found; attempt++) {
+        const size_t index = (ownQueue + attempt) % _queues.size();
+        WorkQueue& queue = *_queues[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.jobs.empty()) {
+            continue;
+        }
+        if (attempt == 0) {
+            job = std::move(queue.jobs.back()); // Own queue: newest first
+            queue.jobs.pop_back();
+        } else {
+            job = std::move(queue.jobs.front()); // Steal the oldest
+            queue.jobs.pop_front();
+        }
+        found = true;
+    }
+    if (!found && allowBackground) {
+        std::lock_guard<std::mutex> lock(_backgroundQueue.mutex);
+        if (!_backgroundQueue.jobs.empty()) {
+            job = std::move(_backgroundQueue.jobs.front());
+            _backgroundQueue.jobs.pop_front();
+            found = true;
+        }
+    }
+    if (!found) {
+        return false;
+    }
+
+    _queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+    job.job();
+    if (job.counter != nullptr) {
+        job.counter->_pending.fetch_sub(1, std::memory_order_release);
+    }
+    return true;
+}
+
+void JobSystem::wait(const Counter& counter) {
+    const size_t ownQueue = currentSystem == this ? currentQueue : 0;
+    while (!counter.isDone()) {
+        if (!tryRunJob(ownQueue, false)) {
+            // Remaining jobs of the batch are running on other threads
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::workerLoop(size_t index) {
+    currentSystem = this;
+    currentQueue = index;
+
+    while (true) {
+        if (tryRunJob(index, true)) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        _wakeUp.wait(lock, [this]() {
+            return _stopping || _queuedJobs.load(std::memory_order_acquire) > 0;
+        });
+        if (_stopping) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing job system for short, CPU-bound jobs (e.g. meshing).
+// Each worker owns a deque: jobs it spawns go to the back and it pops from the
+// back (most recent first, warm caches); idle workers steal from the front of
+// the other deques. Jobs submitted from outside the pool are spread round-robin.
+// Batches are tracked with a Counter, and wait() keeps running queued jobs on
+// the calling thread until its batch is done instead of blocking.
+// Long jobs that nobody waits on right away go through submitBackground(): only
+// workers run them, after every regular job, so wait() never ends up stuck in one.
+class JobSystem {
+  public:
+    using Job = std::function<void()>;
+
+    // Number of jobs of a batch that have not finished yet
+    class Counter {
+      public:
+        [[nodiscard]] bool isDone() const { return _pending.load(std::memory_order_acquire) == 0; }
+
+      private:
+        friend class JobSystem;
+        std::atomic<size_t> _pending{0};
+    };
+
+    // threadCount == 0 picks hardware_concurrency() - 1 (at least 1), the caller of
+    // wait() being the extra thread. That assumes no other pool runs alongside: the
+    // client splits the cores with the chunk generation ThreadPool instead.
+    explicit JobSystem(unsigned int threadCount = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+    JobSystem(JobSystem&&) = delete;
+    JobSystem& operator=(JobSystem&&) = delete;
+
+    // The counter, if any, must outlive the job
+    void submit(Job job, Counter* counter = nullptr);
+    // Same, but the job is only picked up by workers with nothing else queued, and never
+    // by wait(). Poll the counter instead of waiting on it.
+    void submitBackground(Job job, Counter* counter = nullptr);
+    // Helps running jobs until every job tracked by the counter has finished
+    void wait(const Counter& counter);
+
+    [[nodiscard]] unsigned int getThreadCount() const {
+        return static_cast<unsigned int>(_threads.size());
+    }
+
+  private:
+    struct QueuedJob {
+        Job job;
+        Counter* counter = nullptr;
+    };
+
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<QueuedJob> jobs;
+    };
+
+    // Pops from the back of our own queue, otherwise steals from the front of another,
+    // otherwise takes the oldest background job if allowed
+    bool tryRunJob(size_t ownQueue, bool allowBackground);
+    // Queued jobs wake the workers; counted under the sleep mutex
+    void countQueuedJob();
+    void workerLoop(size_t index);
+
+    std::vector<std::unique_ptr<WorkQueue>> _queues;
+    WorkQueue _backgroundQueue; // FIFO
+    std::vector<std::thread> _threads;
+    std::atomic<size_t> _nextQueue{0};
+    std::atomic<size_t> _queuedJobs{0};
+
+    std::mutex _sleepMutex;
+    std::condition_variable _wakeUp;
+    bool _stopping = false;
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <optional>
+#include <utility>
+
+// Lock-free unbounded multi-producer / single-consumer queue (Vyukov style).
+// Any thread may push(); only one thread at a time may call tryPop().
+template <typename T> class MPSCQueue {
+  public:
+    MPSCQueue() : _head(new Node()), _tail(_head.load(std::memory_order_relaxed)) {}
+
+    ~MPSCQueue() {
+        while (tryPop().has_value()) {
+        }
+        delete _tail;
+    }
+
+    MPSCQueue(const MPSCQueue&) = delete;
+    MPSCQueue& operator=(const MPSCQueue&) = delete;
+    MPSCQueue(MPSCQueue&&) = delete;
+    MPSCQueue& operator=(MPSCQueue&&) = delete;
+
+    void push(T value) {
+        Node* node = new Node();
+        node->value.emplace(std::move(value));
+        Node* previous = _head.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+
+    // Returns std::nullopt when the queue is empty (or a producer is mid-push)
+    std::optional<T> tryPop() {
+        Node* next = _tail->next.load(std::memory_order_acquire);
+        if (next == nullptr) {
+            return std::nullopt;
+        }
+        std::optional<T> result(std::move(next->value));
+        next->value.reset();
+        delete _tail;
+        _tail = next; // 'next' becomes the new stub node
+        return result;
+    }
+
+  private:
+    struct Node {
+        std::atomic<Node*> next{nullptr};
+        std::optional<T> value;
+    };
+
+    std::atomic<Node*> _head; // Last pushed node, shared by producers
+    Node* _tail;              // Stub node, owned by the consumer
+};
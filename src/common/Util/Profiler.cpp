@@ -0,0 +1,182 @@
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+
+#include <nlohmann/json.hpp>
+
+namespace {
+struct FrameSample {
+    float cpuMs = 0.0F;
+    float gpuMs = 0.0F;
+};
+
+struct State {
+    std::atomic<bool> enabled{false};
+    std::atomic<uint32_t> nextTrack{Profiler::GPU_TRACK + 1};
+    const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+    std::mutex mutex; // Guards everything below
+    std::vector<Profiler::Event> frameEvents;
+    std::deque<std::vector<Profiler::Event>> traceFrames;
+    std::vector<Profiler::ScopeTotal> lastFrame;
+    std::deque<FrameSample> history;
+    int64_t frameStartUs = 0;
+};
+
+State& state() {
+    static State instance;
+    return instance;
+}
+
+uint32_t currentTrack() {
+    thread_local const uint32_t track =
+        state().nextTrack.fetch_add(1, std::memory_order_relaxed);
+    return track;
+}
+
+void addEvent(const Profiler::Event& event) {
+    State& s = state();
+    const std::lock_guard lock(s.mutex);
+    s.frameEvents.push_back(event);
+}
+} // namespace
+
+Profiler::Scope::Scope(const char* name) : _name(name) {
+    if (isEnabled()) {
+        _startUs = now();
+    }
+}
+
+Profiler::Scope::~Scope() {
+    if (_startUs >= 0) {
+        addEvent(Event{.name = _name,
+                       .track = currentTrack(),
+                       .startUs = _startUs,
+                       .durationUs = now() - _startUs});
+    }
+}
+
+void Profiler::setEnabled(bool enabled) {
+    state().enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool Profiler::isEnabled() { return state().enabled.load(std::memory_order_relaxed); }
+
+int64_t Profiler::now() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now() - state().epoch)
+        .count();
+}
+
+void Profiler::recordGpu(const char* name, int64_t startUs, int64_t durationUs) {
+    if (isEnabled()) {
+        addEvent(Event{
+            .name = name, .track = GPU_TRACK, .startUs = startUs, .durationUs = durationUs});
+    }
+}
+
+void Profiler::endFrame() {
+    State& s = state();
+    const int64_t frameEndUs = now();
+    const std::lock_guard lock(s.mutex);
+
+    FrameSample sample{.cpuMs = static_cast<float>(frameEndUs - s.frameStartUs) / 1000.0F};
+    s.lastFrame.clear();
+    for (const Event& event : s.frameEvents) {
+        const bool gpu = event.track == GPU_TRACK;
+        // Names are literals, but the same text may sit at several addresses
+        auto it = std::find_if(s.lastFrame.begin(), s.lastFrame.end(), [&](const auto& total) {
+            return total.gpu == gpu && std::strcmp(total.name, event.name) == 0;
+        });
+        if (it == s.lastFrame.end()) {
+            it = s.lastFrame.insert(s.lastFrame.end(), ScopeTotal{.name = event.name, .gpu = gpu});
+        }
+        const double ms = static_cast<double>(event.durationUs) / 1000.0;
+        it->ms += ms;
+        it->calls++;
+        if (gpu) {
+            sample.gpuMs += static_cast<float>(ms);
+        }
+    }
+    s.frameStartUs = frameEndUs;
+
+    s.history.push_back(sample);
+    if (s.history.size() > HISTORY_FRAMES) {
+        s.history.pop_front();
+    }
+    if (!s.frameEvents.empty()) {
+        s.traceFrames.push_back(std::move(s.frameEvents));
+        s.frameEvents.clear();
+        if (s.traceFrames.size() > TRACE_FRAMES) {
+            s.traceFrames.pop_front();
+        }
+    }
+}
+
+std::vector<Profiler::ScopeTotal> Profiler::getLastFrame() {
+    State& s = state();
+    const std::lock_guard lock(s.mutex);
+    return s.lastFrame;
+}
+
+Profiler::History Profiler::getHistory() {
+    State& s = state();
+    const std::lock_guard lock(s.mutex);
+    History history;
+    history.cpuMs.reserve(s.history.size());
+    history.gpuMs.reserve(s.history.size());
+    for (const FrameSample& sample : s.history) {
+        history.cpuMs.push_back(sample.cpuMs);
+        history.gpuMs.push_back(sample.gpuMs);
+    }
+    return history;
+}
+
+size_t Profiler::writeChromeTrace(const std::string& path) {
+    nlohmann::json events = nlohmann::json::array();
+    uint32_t lastTrack = GPU_TRACK;
+    {
+        State& s = state();
+        const std::lock_guard lock(s.mutex);
+        for (const std::vector<Event>& frame : s.traceFrames) {
+            for (const Event& event : frame) {
+                events.push_back({{"name", event.name},
+                                  {"cat", event.track == GPU_TRACK ? "gpu" : "cpu"},
+                                  {"ph", "X"},
+                                  {"ts", event.startUs},
+                                  {"dur", event.durationUs},
+                                  {"pid", 1},
+                                  {"tid", event.track}});
+                lastTrack = std::max(lastTrack, event.track);
+            }
+        }
+    }
+    const size_t eventCount = events.size();
+
+    // Track names, shown instead of the bare ids
+    for (uint32_t track = GPU_TRACK; track <= lastTrack; track++) {
+        const std::string name = track == GPU_TRACK ? "GPU" : "Thread " + std::to_string(track);
+        events.push_back({{"name", "thread_name"},
+                          {"ph", "M"},
+                          {"pid", 1},
+                          {"tid", track},
+                          {"args", {{"name", name}}}});
+    }
+
+    std::ofstream file(path);
+    if (!file) {
+        throw std::runtime_error("Failed to open trace file: " + path);
+    }
+    file << nlohmann::json{{"traceEvents", events}, {"displayTimeUnit", "ms"}};
+    if (!file) {
+        throw std::runtime_error("Failed to write trace file: " + path);
+    }
+    return eventCount;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Frame profiler shared by every thread. CPU code marks its hot paths with Scope, the
+// renderer adds GPU pass timings with recordGpu(), and endFrame() closes each frame:
+// per-scope totals for the overlay, a rolling history of frame times, and the events of
+// the last TRACE_FRAMES frames for writeChromeTrace() (chrome://tracing, Perfetto).
+// Disabled scopes cost one relaxed atomic load.
+class Profiler {
+  public:
+    static constexpr size_t HISTORY_FRAMES = 240;
+    static constexpr size_t TRACE_FRAMES = 300;
+    // Trace track of the GPU events, CPU threads are numbered from 1
+    static constexpr uint32_t GPU_TRACK = 0;
+
+    struct Event {
+        const char* name; // Must outlive the profiler: string literals only
+        uint32_t track;
+        int64_t startUs; // Since the profiler started
+        int64_t durationUs;
+    };
+
+    // One name's time over the last finished frame. Scopes on worker threads add up,
+    // so a total can exceed the frame time.
+    struct ScopeTotal {
+        const char* name;
+        double ms = 0.0;
+        uint32_t calls = 0;
+        bool gpu = false;
+    };
+
+    // Frame times, oldest first
+    struct History {
+        std::vector<float> cpuMs; // Between two endFrame() calls
+        std::vector<float> gpuMs; // Sum of the GPU passes read back that frame
+    };
+
+    // Times its own lifetime on the calling thread
+    class Scope {
+      public:
+        explicit Scope(const char* name);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+        Scope(Scope&&) = delete;
+        Scope& operator=(Scope&&) = delete;
+
+      private:
+        const char* _name;
+        int64_t _startUs = -1; // Negative when the profiler was disabled at construction
+    };
+
+    static void setEnabled(bool enabled);
+    [[nodiscard]] static bool isEnabled();
+    // Microseconds since the profiler started, the clock of every event
+    [[nodiscard]] static int64_t now();
+
+    // A GPU pass of `durationUs`, placed on the GPU track at `startUs`
+    static void recordGpu(const char* name, int64_t startUs, int64_t durationUs);
+    // Call once per frame, from the main thread
+    static void endFrame();
+
+    [[nodiscard]] static std::vector<ScopeTotal> getLastFrame();
+    [[nodiscard]] static History getHistory();
+    // Writes the kept frames in the Chrome trace event format and returns the number of
+    // events written. Throws std::runtime_error when the file cannot be written.
+    static size_t writeChromeTrace(const std::string& path);
+};
@@ -0,0 +1,58 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(unsigned int threadCount) {
+    if (threadCount == 0) {
+        unsigned int hardwareThreads = std::thread::hardware_concurrency();
+        threadCount = std::max(1U, hardwareThreads > 1 ? hardwareThreads - 1 : 1U);
+    }
+
+    _workers.reserve(threadCount);
+    for (unsigned int i = 0; i < threadCount; i++) {
+        _workers.emplace_back([this]() { workerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+        // Drop work that never started, running tasks are allowed to finish
+        std::queue<Task>().swap(_tasks);
+    }
+    _condition.notify_all();
+
+    for (auto& worker : _workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(Task task) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _tasks.push(std::move(task));
+    }
+    _condition.notify_one();
+}
+
+size_t ThreadPool::getQueuedCount() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _tasks.size();
+}
+
+void ThreadPool::workerLoop() {
+    while (true) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _condition.wait(lock, [this]() { return _stopping || !_tasks.empty(); });
+            if (_stopping) {
+                return;
+            }
+            task = std::move(_tasks.front());
+            _tasks.pop();
+        }
+        task();
+    }
+}
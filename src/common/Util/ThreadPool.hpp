@@ -0,0 +1,43 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// Fixed-size pool of worker threads consuming a FIFO task queue.
+// Ordering policy (e.g. distance-based priorities) is left to the caller, which
+// decides what to submit and when.
+class ThreadPool {
+  public:
+    using Task = std::function<void()>;
+
+    // threadCount == 0 picks hardware_concurrency() - 1 (at least 1), for a pool that has
+    // the machine to itself
+    explicit ThreadPool(unsigned int threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ThreadPool(ThreadPool&&) = delete;
+    ThreadPool& operator=(ThreadPool&&) = delete;
+
+    void submit(Task task);
+
+    [[nodiscard]] unsigned int getThreadCount() const {
+        return static_cast<unsigned int>(_workers.size());
+    }
+    [[nodiscard]] size_t getQueuedCount() const;
+
+  private:
+    void workerLoop();
+
+    std::vector<std::thread> _workers;
+    std::queue<Task> _tasks;
+    mutable std::mutex _mutex;
+    std::condition_variable _condition;
+    bool _stopping = false;
+};
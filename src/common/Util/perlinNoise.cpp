@@ -1,58 +1,334 @@
 #include "perlinNoise.hpp"
 
+#include <array>
 #include <cmath>
+#include <cstdint>
 #include <numbers>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__AVX2__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
 
 namespace {
-// Génère un vecteur gradient pseudo-aléatoire basé sur les coordonnées
-glm::vec2 randomGradient(int ix, int iy, unsigned int seed) {
-    unsigned int h = (ix * 374761393) + (iy * 668265263);
-    h ^= (seed * 0x27d4eb2d); // multiplier la seed pour la disperser
-    h = (h ^ (h >> 13)) * 1274126177;
-    float angle = static_cast<float>(h & 0xFFFFFFU) / static_cast<float>(0xFFFFFFU) * 2.0F *
-                  std::numbers::pi_v<float>;
-    return glm::vec2(std::cos(angle), std::sin(angle));
-}
-// Produit le produit scalaire distance * gradient
-float dotGridGradient(int ix, int iy, float x, float y, long int seed) {
-    glm::vec2 gradient = randomGradient(ix, iy, seed);
-    float dx = x - (float)ix;
-    float dy = y - (float)iy;
-    return (dx * gradient[0]) + (dy * gradient[1]);
-}
-
-// Fonction fade pour interpolation
+// A lattice corner's hash is ix * HASH_X + iy * HASH_Y (+ iz * HASH_Z), mixed with the seed
+constexpr uint32_t HASH_X = 374761393U;
+constexpr uint32_t HASH_Y = 668265263U;
+constexpr uint32_t HASH_Z = 3266489917U;
+constexpr uint32_t HASH_SEED = 0x27d4eb2dU;
+constexpr uint32_t HASH_SEED_HIGH = 2246822519U;
+constexpr uint32_t HASH_FINAL = 1274126177U;
+
+// The seed's contribution to every corner hash. Seeds outside the 32-bit range fold
+// their upper part in too, so they do not alias the seed of their low 32 bits; the
+// others hash as they always did.
+uint32_t mixSeed(long int seed) {
+    const auto wide = static_cast<int64_t>(seed);
+    const auto low = static_cast<int32_t>(wide); // Modular since C++20
+    const auto high = static_cast<uint32_t>(static_cast<uint64_t>(wide - low) >> 32);
+    return (static_cast<uint32_t>(low) ^ (high * HASH_SEED_HIGH)) * HASH_SEED;
+}
+
+// The hash's low 24 bits are the gradient's angle, rounded to the nearest table entry
+constexpr int GRADIENT_BITS = 10;
+constexpr int GRADIENT_COUNT = 1 << GRADIENT_BITS;
+constexpr uint32_t ANGLE_MASK = 0xFFFFFFU;
+constexpr int GRADIENT_SHIFT = 24 - GRADIENT_BITS;
+constexpr uint32_t GRADIENT_ROUNDING = 1U << (GRADIENT_SHIFT - 1);
+
+// cos and sin of an angle in [0, pi/2] from their Taylor series, with a fixed order of
+// operations. std::cos and std::sin may round differently from one C library to the
+// next, and the table must be bit-identical everywhere for chunks to be.
+std::pair<double, double> quarterCosSin(double angle) {
+    constexpr int TERMS = 16; // Up to angle^33, far below double precision on [0, pi/2]
+    const double squared = angle * angle;
+    double cosTerm = 1.0;
+    double sinTerm = angle;
+    double cosSum = 0.0;
+    double sinSum = 0.0;
+    for (int n = 0; n < TERMS; n++) {
+        cosSum += cosTerm;
+        sinSum += sinTerm;
+        cosTerm *= -squared / static_cast<double>(((2 * n) + 1) * ((2 * n) + 2));
+        sinTerm *= -squared / static_cast<double>(((2 * n) + 2) * ((2 * n) + 3));
+    }
+    return {cosSum, sinSum};
+}
+
+struct GradientTable {
+    alignas(32) std::array<float, GRADIENT_COUNT> x{};
+    alignas(32) std::array<float, GRADIENT_COUNT> y{};
+
+    GradientTable() {
+        // First quadrant from the series, the others by exact quarter turns
+        constexpr int QUARTER = GRADIENT_COUNT / 4;
+        for (int i = 0; i < GRADIENT_COUNT; i++) {
+            const double angle = static_cast<double>(i % QUARTER) *
+                                 (2.0 * std::numbers::pi / static_cast<double>(GRADIENT_COUNT));
+            const auto [cosine, sine] = quarterCosSin(angle);
+            const std::array<double, 4> xs = {cosine, -sine, -cosine, sine};
+            const std::array<double, 4> ys = {sine, cosine, -sine, -cosine};
+            x.at(i) = static_cast<float>(xs.at(i / QUARTER));
+            y.at(i) = static_cast<float>(ys.at(i / QUARTER));
+        }
+    }
+};
+
+const GradientTable& gradientTable() {
+    static const GradientTable table;
+    return table;
+}
+
+// Per call constants, the octave loop's frequencies and amplitudes unrolled
+struct Octaves {
+    static constexpr int MAX_OCTAVES = 16;
+    int count = 0;
+    std::array<float, MAX_OCTAVES> frequencies{};
+    std::array<float, MAX_OCTAVES> amplitudes{};
+    float maxValue = 0.0F; // Sum of the amplitudes, for normalisation
+    uint32_t seedMix = 0;
+};
+
+// Row constants of one octave: the row's lattice cell and its weight along y
+struct OctaveRow {
+    uint32_t hashY0 = 0; // y0 * HASH_Y
+    uint32_t hashY1 = 0; // (y0 + 1) * HASH_Y
+    float sy = 0.0F;     // Offset in the cell
+    float fadeY = 0.0F;
+};
+
 float fade(float t) {
     return t * t * t * (t * (t * 6 - 15) + 10);
 }
 
-// Interpolation lissée
 float interpolate(float a0, float a1, float w) {
-    return a0 + (fade(w) * (a1 - a0));
+    return a0 + (w * (a1 - a0));
 }
 
-// Valeur de Perlin à une position
-// Peut etre move out of namespace si besoin
-float perlinValue(float x, float y, long int seed) {
-    int x0 = static_cast<int>(floorf(x));
-    int x1 = x0 + 1;
-    int y0 = static_cast<int>(floorf(y));
-    int y1 = y0 + 1;
+uint32_t finishHash(uint32_t h, uint32_t seedMix) {
+    h ^= seedMix;
+    return (h ^ (h >> 13)) * HASH_FINAL;
+}
+
+uint32_t gradientIndex(uint32_t hash) {
+    return (((hash & ANGLE_MASK) + GRADIENT_ROUNDING) >> GRADIENT_SHIFT) & (GRADIENT_COUNT - 1);
+}
+
+// Distance to the corner dotted with the corner's gradient
+float dotGradient(uint32_t hash, float dx, float dy, const GradientTable& table) {
+    const uint32_t index = gradientIndex(hash);
+    return (dx * table.x[index]) + (dy * table.y[index]);
+}
+
+OctaveRow octaveRow(float y, float frequency) {
+    const float cellY = std::floor(y * frequency);
+    const auto y0 = static_cast<uint32_t>(static_cast<int32_t>(cellY));
+    const float sy = (y * frequency) - cellY;
+    return {.hashY0 = y0 * HASH_Y, .hashY1 = (y0 + 1) * HASH_Y, .sy = sy, .fadeY = fade(sy)};
+}
+
+// One sample, every octave
+float fractalSample(float x, const std::array<OctaveRow, Octaves::MAX_OCTAVES>& rows,
+                    const Octaves& octaves, const GradientTable& table) {
+    float noiseValue = 0.0F;
+    for (int o = 0; o < octaves.count; o++) {
+        const OctaveRow& row = rows[o];
+        const float fx = x * octaves.frequencies[o];
+        const float cellX = std::floor(fx);
+        const auto x0 = static_cast<uint32_t>(static_cast<int32_t>(cellX));
+        const float sx = fx - cellX;
+        const uint32_t hashX0 = x0 * HASH_X;
+        const uint32_t hashX1 = hashX0 + HASH_X;
 
-    float sx = x - (float)x0;
-    float sy = y - (float)y0;
+        const float n00 = dotGradient(finishHash(hashX0 + row.hashY0, octaves.seedMix), sx,
+                                      row.sy, table);
+        const float n10 = dotGradient(finishHash(hashX1 + row.hashY0, octaves.seedMix),
+                                      sx - 1.0F, row.sy, table);
+        const float n01 = dotGradient(finishHash(hashX0 + row.hashY1, octaves.seedMix), sx,
+                                      row.sy - 1.0F, table);
+        const float n11 = dotGradient(finishHash(hashX1 + row.hashY1, octaves.seedMix),
+                                      sx - 1.0F, row.sy - 1.0F, table);
+        const float fadeX = fade(sx);
+        const float value = interpolate(interpolate(n00, n10, fadeX),
+                                        interpolate(n01, n11, fadeX), row.fadeY);
+        noiseValue += value * octaves.amplitudes[o];
+    }
+    return noiseValue / octaves.maxValue;
+}
 
-    float n0 = dotGridGradient(x0, y0, x, y, seed);
-    float n1 = dotGridGradient(x1, y0, x, y, seed);
-    float ix0 = interpolate(n0, n1, sx);
+// Cube edge directions, four of them twice to fill the 16 slots the hash's top bits pick
+const std::array<glm::vec3, 16> EDGE_GRADIENTS = {
+    glm::vec3(1, 1, 0),  glm::vec3(-1, 1, 0), glm::vec3(1, -1, 0), glm::vec3(-1, -1, 0),
+    glm::vec3(1, 0, 1),  glm::vec3(-1, 0, 1), glm::vec3(1, 0, -1), glm::vec3(-1, 0, -1),
+    glm::vec3(0, 1, 1),  glm::vec3(0, -1, 1), glm::vec3(0, 1, -1), glm::vec3(0, -1, -1),
+    glm::vec3(1, 1, 0),  glm::vec3(-1, 1, 0), glm::vec3(0, -1, 1), glm::vec3(0, -1, -1)};
+
+float dotEdgeGradient(uint32_t hash, float dx, float dy, float dz) {
+    const glm::vec3& gradient = EDGE_GRADIENTS[hash >> 28];
+    return (dx * gradient.x) + (dy * gradient.y) + (dz * gradient.z);
+}
 
-    n0 = dotGridGradient(x0, y1, x, y, seed);
-    n1 = dotGridGradient(x1, y1, x, y, seed);
-    float ix1 = interpolate(n0, n1, sx);
+float perlinValue3D(float x, float y, float z, uint32_t seedMix) {
+    const float cellX = std::floor(x);
+    const float cellY = std::floor(y);
+    const float cellZ = std::floor(z);
+    const float sx = x - cellX;
+    const float sy = y - cellY;
+    const float sz = z - cellZ;
+    const uint32_t hashX0 = static_cast<uint32_t>(static_cast<int32_t>(cellX)) * HASH_X;
+    const uint32_t hashY0 = static_cast<uint32_t>(static_cast<int32_t>(cellY)) * HASH_Y;
+    const uint32_t hashZ0 = static_cast<uint32_t>(static_cast<int32_t>(cellZ)) * HASH_Z;
 
-    float value = interpolate(ix0, ix1, sy);
-    return value;
+    // Corner (i, j, k) of the cell, bit 0 along x, bit 1 along y, bit 2 along z
+    std::array<float, 8> corners{};
+    for (uint32_t corner = 0; corner < 8; corner++) {
+        const uint32_t i = corner & 1U;
+        const uint32_t j = (corner >> 1) & 1U;
+        const uint32_t k = corner >> 2;
+        const uint32_t hash =
+            finishHash(hashX0 + (i * HASH_X) + hashY0 + (j * HASH_Y) + hashZ0 + (k * HASH_Z),
+                       seedMix);
+        corners[corner] =
+            dotEdgeGradient(hash, sx - static_cast<float>(i), sy - static_cast<float>(j),
+                            sz - static_cast<float>(k));
+    }
+    const float fadeX = fade(sx);
+    const float fadeY = fade(sy);
+    const float x00 = interpolate(corners[0], corners[1], fadeX);
+    const float x10 = interpolate(corners[2], corners[3], fadeX);
+    const float x01 = interpolate(corners[4], corners[5], fadeX);
+    const float x11 = interpolate(corners[6], corners[7], fadeX);
+    return interpolate(interpolate(x00, x10, fadeY), interpolate(x01, x11, fadeY), fade(sz));
 }
+
+#if defined(__AVX2__)
+// Thin wrappers so that one kernel serves both instruction sets
+struct Simd {
+    using Float = __m256;
+    using Int = __m256i;
+    static constexpr int WIDTH = 8;
+    static constexpr const char* NAME = "AVX2";
+
+    static Float set(float value) { return _mm256_set1_ps(value); }
+    static Int set(uint32_t value) { return _mm256_set1_epi32(static_cast<int>(value)); }
+    static Int lanes() { return _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7); }
+    static Float add(Float a, Float b) { return _mm256_add_ps(a, b); }
+    static Float sub(Float a, Float b) { return _mm256_sub_ps(a, b); }
+    static Float mul(Float a, Float b) { return _mm256_mul_ps(a, b); }
+    static Float div(Float a, Float b) { return _mm256_div_ps(a, b); }
+    static Float floor(Float a) { return _mm256_floor_ps(a); }
+    static Float toFloat(Int a) { return _mm256_cvtepi32_ps(a); }
+    static Int toInt(Float a) { return _mm256_cvttps_epi32(a); }
+    static Int add(Int a, Int b) { return _mm256_add_epi32(a, b); }
+    static Int mul(Int a, Int b) { return _mm256_mullo_epi32(a, b); }
+    static Int bitXor(Int a, Int b) { return _mm256_xor_si256(a, b); }
+    static Int bitAnd(Int a, Int b) { return _mm256_and_si256(a, b); }
+    static Int shiftRight(Int a, int bits) { return _mm256_srli_epi32(a, bits); }
+    static Float gather(const float* table, Int index) {
+        return _mm256_i32gather_ps(table, index, sizeof(float));
+    }
+    static void store(float* out, Float a) { _mm256_storeu_ps(out, a); }
+};
+#elif defined(__SSE4_1__)
+struct Simd {
+    using Float = __m128;
+    using Int = __m128i;
+    static constexpr int WIDTH = 4;
+    static constexpr const char* NAME = "SSE4.1";
+
+    static Float set(float value) { return _mm_set1_ps(value); }
+    static Int set(uint32_t value) { return _mm_set1_epi32(static_cast<int>(value)); }
+    static Int lanes() { return _mm_setr_epi32(0, 1, 2, 3); }
+    static Float add(Float a, Float b) { return _mm_add_ps(a, b); }
+    static Float sub(Float a, Float b) { return _mm_sub_ps(a, b); }
+    static Float mul(Float a, Float b) { return _mm_mul_ps(a, b); }
+    static Float div(Float a, Float b) { return _mm_div_ps(a, b); }
+    static Float floor(Float a) { return _mm_floor_ps(a); }
+    static Float toFloat(Int a) { return _mm_cvtepi32_ps(a); }
+    static Int toInt(Float a) { return _mm_cvttps_epi32(a); }
+    static Int add(Int a, Int b) { return _mm_add_epi32(a, b); }
+    static Int mul(Int a, Int b) { return _mm_mullo_epi32(a, b); }
+    static Int bitXor(Int a, Int b) { return _mm_xor_si128(a, b); }
+    static Int bitAnd(Int a, Int b) { return _mm_and_si128(a, b); }
+    static Int shiftRight(Int a, int bits) { return _mm_srli_epi32(a, bits); }
+    // No gather before AVX2
+    static Float gather(const float* table, Int index) {
+        alignas(16) std::array<uint32_t, 4> indices{};
+        _mm_store_si128(reinterpret_cast<__m128i*>(indices.data()), index);
+        return _mm_setr_ps(table[indices[0]], table[indices[1]], table[indices[2]],
+                           table[indices[3]]);
+    }
+    static void store(float* out, Float a) { _mm_storeu_ps(out, a); }
+};
+#endif
+
+#if defined(__AVX2__) || defined(__SSE4_1__)
+// fractalSample on Simd::WIDTH consecutive samples of a row
+struct SimdKernel {
+    using Float = Simd::Float;
+    using Int = Simd::Int;
+
+    static Float fade(Float t) {
+        const Float inner = Simd::add(
+            Simd::mul(t, Simd::sub(Simd::mul(t, Simd::set(6.0F)), Simd::set(15.0F))),
+            Simd::set(10.0F));
+        return Simd::mul(Simd::mul(Simd::mul(t, t), t), inner);
+    }
+
+    static Float interpolate(Float a0, Float a1, Float w) {
+        return Simd::add(a0, Simd::mul(w, Simd::sub(a1, a0)));
+    }
+
+    static Float dotGradient(Int hash, Float dx, Float dy, Int seedMix,
+                             const GradientTable& table) {
+        Int h = Simd::bitXor(hash, seedMix);
+        h = Simd::mul(Simd::bitXor(h, Simd::shiftRight(h, 13)), Simd::set(HASH_FINAL));
+        Int index = Simd::add(Simd::bitAnd(h, Simd::set(ANGLE_MASK)),
+                              Simd::set(GRADIENT_ROUNDING));
+        index = Simd::bitAnd(Simd::shiftRight(index, GRADIENT_SHIFT),
+                             Simd::set(static_cast<uint32_t>(GRADIENT_COUNT - 1)));
+        return Simd::add(Simd::mul(dx, Simd::gather(table.x.data(), index)),
+                         Simd::mul(dy, Simd::gather(table.y.data(), index)));
+    }
+
+    static void samples(float* out, int firstX,
+                        const std::array<OctaveRow, Octaves::MAX_OCTAVES>& rows,
+                        const Octaves& octaves, const GradientTable& table) {
+        const Float x = Simd::toFloat(Simd::add(Simd::set(static_cast<uint32_t>(firstX)),
+                                                Simd::lanes()));
+        const Int seedMix = Simd::set(octaves.seedMix);
+        const Float one = Simd::set(1.0F);
+        Float noiseValue = Simd::set(0.0F);
+        for (int o = 0; o < octaves.count; o++) {
+            const OctaveRow& row = rows[o];
+            const Float fx = Simd::mul(x, Simd::set(octaves.frequencies[o]));
+            const Float cellX = Simd::floor(fx);
+            const Float sx = Simd::sub(fx, cellX);
+            const Float sy = Simd::set(row.sy);
+            const Int hashX0 = Simd::mul(Simd::toInt(cellX), Simd::set(HASH_X));
+            const Int hashX1 = Simd::add(hashX0, Simd::set(HASH_X));
+            const Int hashY0 = Simd::set(row.hashY0);
+            const Int hashY1 = Simd::set(row.hashY1);
+
+            const Float n00 =
+                dotGradient(Simd::add(hashX0, hashY0), sx, sy, seedMix, table);
+            const Float n10 = dotGradient(Simd::add(hashX1, hashY0), Simd::sub(sx, one), sy,
+                                          seedMix, table);
+            const Float n01 = dotGradient(Simd::add(hashX0, hashY1), sx, Simd::sub(sy, one),
+                                          seedMix, table);
+            const Float n11 = dotGradient(Simd::add(hashX1, hashY1), Simd::sub(sx, one),
+                                          Simd::sub(sy, one), seedMix, table);
+            const Float fadeX = fade(sx);
+            const Float value = interpolate(interpolate(n00, n10, fadeX),
+                                            interpolate(n01, n11, fadeX), Simd::set(row.fadeY));
+            noiseValue = Simd::add(noiseValue,
+                                   Simd::mul(value, Simd::set(octaves.amplitudes[o])));
+        }
+        Simd::store(out, Simd::div(noiseValue, Simd::set(octaves.maxValue)));
+    }
+};
+#endif
 } // namespace
 
 // Génère une matrice 2D de Perlin noise
@@ -60,26 +336,80 @@ float perlinValue(float x, float y, long int seed) {
 // persistence : entre 0 et 1
 std::vector<std::vector<float>> perlinNoise(int width, int height, float baseFrequency,
                                             long int seed, int octaves, float persistence) {
-    std::vector<std::vector<float>> perlin(height, std::vector<float>(width));
+    std::vector<float> flat(static_cast<size_t>(width) * height);
+    perlinNoiseBatch(flat, 0, 0, width, height, baseFrequency, seed, octaves, persistence);
 
+    std::vector<std::vector<float>> perlin(height);
     for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            float amplitude = 1.0F;
-            float frequency = baseFrequency;
-            float noiseValue = 0.0F;
-            float maxValue = 0.0F; // Pour normalisation
-
-            for (int o = 0; o < octaves; ++o) {
-                noiseValue += perlinValue(static_cast<float>(x) * frequency,
-                                          static_cast<float>(y) * frequency, seed) *
-                              amplitude;
-                maxValue += amplitude;
-                amplitude *= persistence;
-                frequency *= 2.0F;
-            }
-
-            perlin[y][x] = noiseValue / maxValue; // Normalisation à [-1,1] approximatif
-        }
+        perlin[y].assign(flat.begin() + (static_cast<ptrdiff_t>(y) * width),
+                         flat.begin() + (static_cast<ptrdiff_t>(y + 1) * width));
     }
     return perlin;
-}
\ No newline at end of file
+}
+
+void perlinNoiseBatch(std::span<float> out, int originX, int originY, int width, int height,
+                      float baseFrequency, long int seed, int octaves, float persistence) {
+    if (width < 0 || height < 0 || out.size() != static_cast<size_t>(width) * height) {
+        throw std::runtime_error("perlinNoiseBatch: output does not match the footprint");
+    }
+    if (octaves < 1 || octaves > Octaves::MAX_OCTAVES) {
+        throw std::runtime_error("perlinNoiseBatch: octave count out of range");
+    }
+
+    Octaves params;
+    params.count = octaves;
+    params.seedMix = mixSeed(seed);
+    float amplitude = 1.0F;
+    float frequency = baseFrequency;
+    for (int o = 0; o < octaves; o++) {
+        params.frequencies[o] = frequency;
+        params.amplitudes[o] = amplitude;
+        params.maxValue += amplitude;
+        amplitude *= persistence;
+        frequency *= 2.0F;
+    }
+    const GradientTable& table = gradientTable();
+
+    std::array<OctaveRow, Octaves::MAX_OCTAVES> rows{};
+    for (int y = 0; y < height; y++) {
+        const auto sampleY = static_cast<float>(originY + y);
+        for (int o = 0; o < octaves; o++) {
+            rows[o] = octaveRow(sampleY, params.frequencies[o]);
+        }
+        float* row = out.data() + (static_cast<size_t>(y) * width);
+        int x = 0;
+#if defined(__AVX2__) || defined(__SSE4_1__)
+        for (; x + Simd::WIDTH <= width; x += Simd::WIDTH) {
+            SimdKernel::samples(row + x, originX + x, rows, params, table);
+        }
+#endif
+        for (; x < width; x++) {
+            row[x] = fractalSample(static_cast<float>(originX + x), rows, params, table);
+        }
+    }
+}
+
+float perlinNoise3D(float x, float y, float z, float baseFrequency, long int seed,
+                    int octaves, float persistence) {
+    const uint32_t seedMix = mixSeed(seed);
+    float amplitude = 1.0F;
+    float frequency = baseFrequency;
+    float noiseValue = 0.0F;
+    float maxValue = 0.0F;
+    for (int o = 0; o < octaves; o++) {
+        noiseValue +=
+            perlinValue3D(x * frequency, y * frequency, z * frequency, seedMix) * amplitude;
+        maxValue += amplitude;
+        amplitude *= persistence;
+        frequency *= 2.0F;
+    }
+    return noiseValue / maxValue;
+}
+
+const char* perlinNoiseBackend() {
+#if defined(__AVX2__) || defined(__SSE4_1__)
+    return Simd::NAME;
+#else
+    return "scalar";
+#endif
+}
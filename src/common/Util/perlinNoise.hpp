@@ -1,7 +1,32 @@
 #pragma once
 
+#include <span>
 #include <vector>
 
 #include <glm/glm.hpp>
+
+// Fractal 2D Perlin noise, height rows of width samples. Wraps perlinNoiseBatch.
 std::vector<std::vector<float>> perlinNoise(int width, int height, float baseFrequency,
                                             long int seed, int octaves, float persistence);
+
+// Largest difference allowed between perlinNoiseBatch and noise with the hash's exact
+// gradient angle (7.5e-4 measured by the world benchmark, which fails above this)
+inline constexpr float PERLIN_BATCH_TOLERANCE = 1e-3F;
+
+// Fractal 2D Perlin noise of the width x height footprint whose first sample is at
+// (originX, originY), written row-major to `out` (width * height floats, throws
+// otherwise). Every octave of a sample is summed in one pass, eight or four samples at
+// a time with AVX2 or SSE4.1 when the build targets them, one at a time otherwise. The
+// paths give bit-identical results as long as the compiler does not fuse multiply-adds
+// (-ffp-contract=off, set in CMakeLists.txt). Gradients come from a table of 1024
+// directions rather than from the hash's exact angle, within PERLIN_BATCH_TOLERANCE.
+void perlinNoiseBatch(std::span<float> out, int originX, int originY, int width, int height,
+                      float baseFrequency, long int seed, int octaves, float persistence);
+
+// Fractal 3D gradient noise at (x, y, z), normalised like perlinNoise to about [-1, 1].
+// Gradients are the twelve cube edge directions, picked by the lattice corner's hash.
+[[nodiscard]] float perlinNoise3D(float x, float y, float z, float baseFrequency,
+                                  long int seed, int octaves, float persistence);
+
+// "AVX2", "SSE4.1" or "scalar", the path perlinNoiseBatch was compiled with
+[[nodiscard]] const char* perlinNoiseBackend();
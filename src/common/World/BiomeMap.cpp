@@ -0,0 +1,198 @@
+#include "BiomeMap.hpp"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+#include "ChunkRegion.hpp"
+#include "TerrainGenerator.hpp"
+#include "common/Util/perlinNoise.hpp"
+
+static_assert(BiomeMap::REGION_CHUNKS == ChunkRegion::SIZE);
+
+namespace {
+// Relief left on the lowest ground, as a fraction of HEIGHT_AMPLITUDE
+constexpr float MIN_RELIEF = 0.25F;
+// Low-octave noise mostly stays within +-0.5, stretched to use the whole [-1, 1]
+constexpr float CLIMATE_CONTRAST = 2.0F;
+
+// Climate thresholds, checked in this order
+constexpr float TUNDRA_TEMPERATURE = -0.3F;   // Colder is tundra
+constexpr float BADLANDS_TEMPERATURE = 0.25F; // Warmer and drier is badlands
+constexpr float BADLANDS_HUMIDITY = -0.25F;
+constexpr float PLAINS_CONTINENTALNESS = -0.2F; // Below is lowlands
+constexpr float HILLS_CONTINENTALNESS = 0.2F;
+constexpr float MOUNTAINS_CONTINENTALNESS = 0.45F;
+
+float clampUnit(float value) {
+    return std::clamp(value, -1.0F, 1.0F);
+}
+
+long int offsetSeed(long int seed, unsigned long offset) {
+    return static_cast<long int>(static_cast<unsigned long>(seed) + offset);
+}
+
+Biome classify(float temperature, float humidity, float continentalness) {
+    if (temperature < TUNDRA_TEMPERATURE) {
+        return Biome::Tundra;
+    }
+    if (temperature > BADLANDS_TEMPERATURE && humidity < BADLANDS_HUMIDITY) {
+        return Biome::Badlands;
+    }
+    if (continentalness < PLAINS_CONTINENTALNESS) {
+        return Biome::Lowlands;
+    }
+    if (continentalness < HILLS_CONTINENTALNESS) {
+        return Biome::Plains;
+    }
+    return continentalness < MOUNTAINS_CONTINENTALNESS ? Biome::Hills : Biome::Mountains;
+}
+
+// The surface is continuous in continentalness, so it has no seams at biome borders.
+// It stays in BASE_HEIGHT +- (CONTINENT_RISE + HEIGHT_AMPLITUDE).
+BiomeMap::Column shapeColumn(float heightNoise, float temperature, float humidity,
+                             float continentalness) {
+    BiomeMap::Column column{.temperature = clampUnit(temperature * CLIMATE_CONTRAST),
+                            .humidity = clampUnit(humidity * CLIMATE_CONTRAST),
+                            .continentalness = clampUnit(continentalness * CLIMATE_CONTRAST)};
+    const float relief =
+        MIN_RELIEF + ((1.0F - MIN_RELIEF) * (column.continentalness + 1.0F) * 0.5F);
+    column.surface =
+        static_cast<float>(TerrainGenerator::BASE_HEIGHT) +
+        (column.continentalness * static_cast<float>(TerrainGenerator::CONTINENT_RISE)) +
+        (clampUnit(heightNoise) * static_cast<float>(TerrainGenerator::HEIGHT_AMPLITUDE) *
+         relief);
+    column.biome = classify(column.temperature, column.humidity, column.continentalness);
+    return column;
+}
+
+int floorDiv(int value, int divisor) {
+    int quotient = value / divisor;
+    return (value % divisor < 0) ? quotient - 1 : quotient;
+}
+} // namespace
+
+BiomeMap::BiomeMap(long int seed, size_t capacity)
+    : _heightSeed(seed), _temperatureSeed(offsetSeed(seed, 2)),
+      _humiditySeed(offsetSeed(seed, 3)), _continentalnessSeed(offsetSeed(seed, 4)),
+      _capacity(capacity) {
+    if (capacity == 0) {
+        throw std::runtime_error("BiomeMap: the cache must hold at least one region");
+    }
+}
+
+glm::ivec2 BiomeMap::regionOf(int chunkX, int chunkZ) {
+    return {floorDiv(chunkX, REGION_CHUNKS), floorDiv(chunkZ, REGION_CHUNKS)};
+}
+
+std::shared_ptr<const BiomeMap::RegionLayers> BiomeMap::getRegion(
+    const glm::ivec2& region) const {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _regions.find(region);
+        if (it != _regions.end()) {
+            it->second.lastUsedTick = ++_tick;
+            _hits++;
+            return it->second.layers;
+        }
+        _misses++;
+    }
+
+    // Computed outside the lock, so other threads' hits do not wait for it
+    std::shared_ptr<const RegionLayers> layers = computeRegion(region);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto [it, inserted] = _regions.try_emplace(region, CacheEntry{.layers = std::move(layers)});
+    it->second.lastUsedTick = ++_tick;
+    std::shared_ptr<const RegionLayers> result = it->second.layers;
+    // The region just used has the newest tick, so it is never the one evicted
+    while (_regions.size() > _capacity) {
+        auto oldest = std::min_element(_regions.begin(), _regions.end(),
+                                       [](const auto& a, const auto& b) {
+                                           return a.second.lastUsedTick < b.second.lastUsedTick;
+                                       });
+        _regions.erase(oldest);
+        _evictions++;
+    }
+    return result;
+}
+
+std::shared_ptr<const BiomeMap::RegionLayers> BiomeMap::computeRegion(
+    const glm::ivec2& region) const {
+    auto layers = std::make_shared<RegionLayers>();
+    layers->surface.resize(REGION_COLUMNS);
+    layers->temperature.resize(REGION_COLUMNS);
+    layers->humidity.resize(REGION_COLUMNS);
+    layers->continentalness.resize(REGION_COLUMNS);
+    layers->biome.resize(REGION_COLUMNS);
+
+    // Raw noise first, each layer in one batch over the whole region
+    const glm::ivec2 origin = region * REGION_SIZE;
+    perlinNoiseBatch(layers->surface, origin.x, origin.y, REGION_SIZE, REGION_SIZE,
+                     TerrainGenerator::HEIGHT_FREQUENCY, _heightSeed,
+                     TerrainGenerator::HEIGHT_OCTAVES, TerrainGenerator::PERSISTENCE);
+    perlinNoiseBatch(layers->temperature, origin.x, origin.y, REGION_SIZE, REGION_SIZE,
+                     TEMPERATURE_FREQUENCY, _temperatureSeed, CLIMATE_OCTAVES,
+                     TerrainGenerator::PERSISTENCE);
+    perlinNoiseBatch(layers->humidity, origin.x, origin.y, REGION_SIZE, REGION_SIZE,
+                     HUMIDITY_FREQUENCY, _humiditySeed, CLIMATE_OCTAVES,
+                     TerrainGenerator::PERSISTENCE);
+    perlinNoiseBatch(layers->continentalness, origin.x, origin.y, REGION_SIZE, REGION_SIZE,
+                     CONTINENTALNESS_FREQUENCY, _continentalnessSeed, CLIMATE_OCTAVES,
+                     TerrainGenerator::PERSISTENCE);
+
+    for (size_t i = 0; i < REGION_COLUMNS; i++) {
+        const Column column = shapeColumn(layers->surface[i], layers->temperature[i],
+                                          layers->humidity[i], layers->continentalness[i]);
+        layers->surface[i] = column.surface;
+        layers->temperature[i] = column.temperature;
+        layers->humidity[i] = column.humidity;
+        layers->continentalness[i] = column.continentalness;
+        layers->biome[i] = column.biome;
+    }
+    return layers;
+}
+
+BiomeMap::Column BiomeMap::sampleColumn(int worldX, int worldZ) const {
+    std::array<float, 1> height{};
+    std::array<float, 1> temperature{};
+    std::array<float, 1> humidity{};
+    std::array<float, 1> continentalness{};
+    perlinNoiseBatch(height, worldX, worldZ, 1, 1, TerrainGenerator::HEIGHT_FREQUENCY,
+                     _heightSeed, TerrainGenerator::HEIGHT_OCTAVES,
+                     TerrainGenerator::PERSISTENCE);
+    perlinNoiseBatch(temperature, worldX, worldZ, 1, 1, TEMPERATURE_FREQUENCY,
+                     _temperatureSeed, CLIMATE_OCTAVES, TerrainGenerator::PERSISTENCE);
+    perlinNoiseBatch(humidity, worldX, worldZ, 1, 1, HUMIDITY_FREQUENCY, _humiditySeed,
+                     CLIMATE_OCTAVES, TerrainGenerator::PERSISTENCE);
+    perlinNoiseBatch(continentalness, worldX, worldZ, 1, 1, CONTINENTALNESS_FREQUENCY,
+                     _continentalnessSeed, CLIMATE_OCTAVES, TerrainGenerator::PERSISTENCE);
+    return shapeColumn(height[0], temperature[0], humidity[0], continentalness[0]);
+}
+
+BiomeMap::CacheStats BiomeMap::getCacheStats() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return {.residentRegions = _regions.size(),
+            .capacity = _capacity,
+            .hits = _hits,
+            .misses = _misses,
+            .evictions = _evictions};
+}
+
+const char* BiomeMap::getBiomeName(Biome biome) {
+    switch (biome) {
+    case Biome::Lowlands:
+        return "Lowlands";
+    case Biome::Plains:
+        return "Plains";
+    case Biome::Hills:
+        return "Hills";
+    case Biome::Mountains:
+        return "Mountains";
+    case Biome::Tundra:
+        return "Tundra";
+    case Biome::Badlands:
+        return "Badlands";
+    }
+    return "Unknown";
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Chunk.hpp"
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtx/hash.hpp>
+
+enum class Biome : uint8_t { Lowlands, Plains, Hills, Mountains, Tundra, Badlands };
+
+// The 2D fields of the world: low-frequency climate noise (temperature, humidity,
+// continentalness), the biome they select, and the surface height, which continentalness
+// raises and roughens. They do not depend on y, so they are computed for a whole region
+// column at once (REGION_CHUNKS x REGION_CHUNKS chunk columns, the footprint of a
+// ChunkRegion) and kept in a bounded LRU cache: every chunk stacked in the column, and
+// every chunk generated there again after being unloaded, reuses them.
+// getRegion() is const and safe to call from several threads at once. Two threads
+// missing the same region both compute it and the first one stored is kept; the layers
+// only depend on the seed and the position, so either would do.
+class BiomeMap {
+  public:
+    static constexpr int REGION_CHUNKS = 4;
+    static constexpr int REGION_SIZE = REGION_CHUNKS * Chunk::CHUNK_SIZE; // Voxels per side
+    static constexpr size_t REGION_COLUMNS = static_cast<size_t>(REGION_SIZE) * REGION_SIZE;
+    // Regions in view at the client's load distance, plus the unload margin
+    static constexpr size_t DEFAULT_CAPACITY = 96;
+
+    static constexpr float TEMPERATURE_FREQUENCY = 0.0015F;
+    static constexpr float HUMIDITY_FREQUENCY = 0.0015F;
+    static constexpr float CONTINENTALNESS_FREQUENCY = 0.001F;
+    static constexpr int CLIMATE_OCTAVES = 3;
+
+    // Everything known about one world column. Climate values are clamped to [-1, 1].
+    struct Column {
+        float surface = 0.0F;
+        float temperature = 0.0F;
+        float humidity = 0.0F;
+        float continentalness = 0.0F;
+        Biome biome = Biome::Plains;
+    };
+
+    // The layers of one region column, at localX + localZ * REGION_SIZE
+    struct RegionLayers {
+        std::vector<float> surface;
+        std::vector<float> temperature;
+        std::vector<float> humidity;
+        std::vector<float> continentalness;
+        std::vector<Biome> biome;
+
+        [[nodiscard]] static size_t indexOf(int localX, int localZ) {
+            return static_cast<size_t>(localX) + (static_cast<size_t>(localZ) * REGION_SIZE);
+        }
+    };
+
+    struct CacheStats {
+        size_t residentRegions = 0;
+        size_t capacity = 0;
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t evictions = 0;
+    };
+
+    // capacity is the number of regions kept, at least 1 (throws otherwise)
+    explicit BiomeMap(long int seed, size_t capacity = DEFAULT_CAPACITY);
+    ~BiomeMap() = default;
+
+    BiomeMap(const BiomeMap&) = delete;
+    BiomeMap& operator=(const BiomeMap&) = delete;
+    BiomeMap(BiomeMap&&) = delete;
+    BiomeMap& operator=(BiomeMap&&) = delete;
+
+    // Region column (x, z) holding the chunk column at chunk coordinates (chunkX, chunkZ)
+    [[nodiscard]] static glm::ivec2 regionOf(int chunkX, int chunkZ);
+
+    // The layers of a region column, from the cache or computed and cached. The pointer
+    // stays valid after the region is evicted.
+    [[nodiscard]] std::shared_ptr<const RegionLayers> getRegion(const glm::ivec2& region) const;
+
+    // One column computed on its own, bypassing the cache (and its counters). Equal to
+    // the column's entry in getRegion().
+    [[nodiscard]] Column sampleColumn(int worldX, int worldZ) const;
+
+    [[nodiscard]] CacheStats getCacheStats() const;
+
+    [[nodiscard]] static const char* getBiomeName(Biome biome);
+
+  private:
+    struct CacheEntry {
+        std::shared_ptr<const RegionLayers> layers;
+        uint64_t lastUsedTick = 0;
+    };
+
+    [[nodiscard]] std::shared_ptr<const RegionLayers> computeRegion(
+        const glm::ivec2& region) const;
+
+    long int _heightSeed;
+    long int _temperatureSeed;
+    long int _humiditySeed;
+    long int _continentalnessSeed;
+    size_t _capacity;
+
+    mutable std::mutex _mutex; // Guards everything below
+    mutable std::unordered_map<glm::ivec2, CacheEntry> _regions;
+    mutable uint64_t _tick = 0;
+    mutable size_t _hits = 0;
+    mutable size_t _misses = 0;
+    mutable size_t _evictions = 0;
+};
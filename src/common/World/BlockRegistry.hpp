@@ -1,3 +1,5 @@
+#pragma once
+
 #include <array>
 #include <cstdio>
 #include <fstream>
@@ -22,7 +24,7 @@ struct BlockData {
 static void printBlockDataVector(const std::vector<BlockData>& vec) {
     auto block = vec.begin();
     for (int i = 0; i < MAX_BLOCKS; i++) {
-        std::cout << "Block ID: " << i << ", Name: " << block->name << "\n";
+        std::clog << "Block ID: " << i << ", Name: " << block->name << "\n";
         block++;
     }
 }
@@ -5,49 +5,49 @@
 #include <glm/glm.hpp>
 #define RENDER_DISTANCE 32
 
-Chunk::Chunk(int x, int y, int z) : _blocks{} {
-    _blocks.fill(AIR_BLOCK_ID);
+Chunk::Chunk() : _blocks(VOLUME, AIR_BLOCK_ID) {}
 
-    // All chunks are at y=0 for this test
-    std::tuple<int, int, int> pos = {x, 0, z};
+Chunk::Chunk(int x, int y, int z) : position(x, y, z), _blocks(VOLUME, AIR_BLOCK_ID) {}
 
-    // Create a new chunk and generate its block data
-    // Fill with some blocks for testing (staircase-like pattern)
-    for (int bx = 0; bx < 32; bx++) {
-        for (int bz = 0; bz < 32; bz++) {
-            int height = (bx + bz) / 2;
-            for (int by = 0; by < height && by < 32; by++) {
-                if (by < height - 5) {
-                    setBlock(bx, by, bz, 1); // stone
-                } else if (by < height - 1) {
-                    setBlock(bx, by, bz, 2); // grass_block
-                } else if (by < height && (bx % 3 == 0) && (bz % 3 == 0)) {
-                    setBlock(bx, by, bz, 4); // water
-                } else if (by < height) {
-                    setBlock(bx, by, bz, 3); // oak_wood (some trees)
-                } else {
-                    setBlock(bx, by, bz, 0); // air
-                }
-            }
-        }
-    }
+void Chunk::assignBlocks(std::span<const uint8_t, VOLUME> blocks) {
+    _blocks.assign(blocks);
+    _isEmpty = _blocks.isUniform() && _blocks.get(0) == AIR_BLOCK_ID;
+}
+
+void Chunk::fill(uint8_t blockId) {
+    _blocks.fill(blockId);
+    _isEmpty = blockId == AIR_BLOCK_ID;
 }
 
 uint8_t Chunk::getBlock(int x, int y, int z) const {
     if (!isInBounds(x, y, z)) {
         return AIR_BLOCK_ID;
     }
-    return _blocks.at(static_cast<decltype(_blocks)::size_type>(getIndex(x, y, z)));
+    return _blocks.get(static_cast<size_t>(getIndex(x, y, z)));
 }
 
 void Chunk::setBlock(int x, int y, int z, uint8_t blockId) {
     if (!isInBounds(x, y, z)) {
         return;
     }
-    _blocks.at(static_cast<decltype(_blocks)::size_type>(getIndex(x, y, z))) = blockId;
+    const auto index = static_cast<size_t>(getIndex(x, y, z));
+    if (_blocks.get(index) == blockId) {
+        return; // No change, nothing to remesh
+    }
+    _blocks.set(index, blockId);
     if (blockId != AIR_BLOCK_ID) {
         _isEmpty = false;
     }
+
+    // Faces on a border are also meshed by the neighbour sharing it
+    _isDirty = true;
+    constexpr int LAST = CHUNK_SIZE - 1;
+    _dirtyBorders |= static_cast<uint8_t>(((x == LAST) ? 1U << BORDER_EAST : 0U) |
+                                          ((x == 0) ? 1U << BORDER_WEST : 0U) |
+                                          ((y == LAST) ? 1U << BORDER_TOP : 0U) |
+                                          ((y == 0) ? 1U << BORDER_BOTTOM : 0U) |
+                                          ((z == LAST) ? 1U << BORDER_NORTH : 0U) |
+                                          ((z == 0) ? 1U << BORDER_SOUTH : 0U));
 }
 
 bool Chunk::isBlockSolid(int x, int y, int z) const {
@@ -64,31 +64,3 @@ bool Chunk::isInBounds(int x, int y, int z) const {
 int Chunk::getIndex(int x, int y, int z) const {
     return x + (y * CHUNK_SIZE) + (z * CHUNK_SIZE * CHUNK_SIZE);
 }
-
-void ChunkInstanciator::loadChunkAt(int x, int y, int z) {
-    decltype(_loadedChunks)::key_type key = decltype(_loadedChunks)::key_type(x, y, z);
-    if (_loadedChunks.contains(key)) {
-        return; // Chunk already loaded
-    }
-    _loadedChunks[key] = std::make_unique<Chunk>(x, y, z);
-}
-// void ChunkInstanciator::unloadChunkAt(int x, int y, int z) {}
-
-void ChunkInstanciator::updateChunksAroundPlayer(float playerX, float playerY, float playerZ,
-                                                 float viewDistance) {
-    int cxmin = static_cast<int>(std::floor((playerX - viewDistance) / Chunk::CHUNK_SIZE));
-    int cxmax = static_cast<int>(std::floor((playerX + viewDistance) / Chunk::CHUNK_SIZE));
-    int cymin = static_cast<int>(std::floor((playerY - viewDistance) / Chunk::CHUNK_SIZE));
-    int cymax = static_cast<int>(std::floor((playerY + viewDistance) / Chunk::CHUNK_SIZE));
-    int czmin = static_cast<int>(std::floor((playerZ - viewDistance) / Chunk::CHUNK_SIZE));
-    int czmax = static_cast<int>(std::floor((playerZ + viewDistance) / Chunk::CHUNK_SIZE));
-    for (int x = cxmin; x <= cxmax; x++) {
-        for (int y = cymin; y <= cymax; y++) {
-            for (int z = czmin; z <= czmax; z++) {
-                loadChunkAt(x, y, z);
-            }
-        }
-    }
-}
-
-// hecks which chunks need to be loaded/unloaded based on player position
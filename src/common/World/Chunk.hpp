@@ -1,22 +1,20 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <map>
 #include <memory>
-#include <unordered_map>
+#include <span>
+#include <tuple>
 #include <utility>
 
 #include <glm/glm.hpp>
 
 #include "glm/fwd.hpp"
-#define GLM_ENABLE_EXPERIMENTAL
-#include <glm/gtx/hash.hpp>
+#include "PalettedBlockStorage.hpp"
 #define RENDER_DISTANCE_IN_CHUNKS 4
 
-class Chunk;
-using chunkMap = std::unordered_map<glm::ivec3, std::unique_ptr<Chunk>>;
-
 /*
     // Simple struct to use as a key in our chunk map
     struct ChunkPos {
@@ -80,8 +78,19 @@ class Chunk {
     static constexpr int VOLUME = CHUNK_SIZE * CHUNK_SIZE * CHUNK_SIZE;
     static constexpr uint8_t AIR_BLOCK_ID = 0;
 
+    // Chunk faces, in the same order as ChunkSnapshot::BorderSide (+X, -X, +Y, -Y, +Z, -Z)
+    enum Border : uint8_t {
+        BORDER_EAST,
+        BORDER_WEST,
+        BORDER_TOP,
+        BORDER_BOTTOM,
+        BORDER_NORTH,
+        BORDER_SOUTH
+    };
+
+    // An all-air chunk at chunk coordinates (x, y, z), filled by TerrainGenerator
     Chunk(int x, int y, int z);
-    Chunk() = default;
+    Chunk();
     ~Chunk() = default;
 
     Chunk(const Chunk&) = delete;
@@ -97,33 +106,41 @@ class Chunk {
     [[nodiscard]] bool isBlockSolid(int x, int y, int z) const;
     [[nodiscard]] bool isInBounds(int x, int y, int z) const;
     [[nodiscard]] int getIndex(int x, int y, int z) const;
+    // Decodes all voxels (x-major, then y, then z) for bulk readers such as meshers
+    void copyBlocks(std::span<uint8_t, VOLUME> out) const { _blocks.copyTo(out); }
+    // Shrinks the palette after bulk edits (e.g. generation)
+    void compactStorage() { _blocks.compact(); }
+    // Bulk writes for generation, not edits: the chunk is not marked dirty.
+    // assignBlocks takes the layout of copyBlocks.
+    void assignBlocks(std::span<const uint8_t, VOLUME> blocks);
+    void fill(uint8_t blockId);
 
     // Chunk state
     [[nodiscard]] bool isEmpty() const { return _isEmpty; }
     void setEmpty(bool empty) { _isEmpty = empty; }
+    [[nodiscard]] bool isUniform() const { return _blocks.isUniform(); }
+
+    // Remesh tracking: setBlock marks the chunk dirty when a block actually changes,
+    // and sets bit (1 << Border) for every border the edit touched so the owner
+    // can remesh the neighbours sharing those faces too.
+    [[nodiscard]] bool isDirty() const { return _isDirty; }
+    [[nodiscard]] uint8_t getDirtyBorders() const { return _dirtyBorders; }
+    void clearDirty() {
+        _isDirty = false;
+        _dirtyBorders = 0;
+    }
+
+    [[nodiscard]] const PalettedBlockStorage& getStorage() const { return _blocks; }
+    // Heap + inline bytes owned by this chunk, used for residency accounting
+    [[nodiscard]] size_t getMemoryUsage() const {
+        return sizeof(Chunk) + _blocks.getHeapUsage();
+    }
     std::tuple<int, int, int> getPosition() const { return position; }
 
   private:
     std::tuple<int, int, int> position;
-    std::array<uint8_t, VOLUME> _blocks;
+    PalettedBlockStorage _blocks;
     bool _isEmpty = true;
-};
-
-class ChunkInstanciator {
-  public:
-    ChunkInstanciator() = default;
-    ~ChunkInstanciator() = default;
-    ChunkInstanciator(const ChunkInstanciator&) = delete;
-    ChunkInstanciator& operator=(const ChunkInstanciator&) = delete;
-    ChunkInstanciator(ChunkInstanciator&&) = default;
-    ChunkInstanciator& operator=(ChunkInstanciator&&) = default;
-    // hecks which chunks need to be loaded/unloaded based on player position
-
-    void updateChunksAroundPlayer(float playerX, float playerY, float playerZ, float viewDistance);
-
-  private:
-    void loadChunkAt(int x, int y, int z);
-    void unloadChunkAt(int x, int y, int z);
-    // some data structures to hold loaded chunks
-    chunkMap _loadedChunks;
+    bool _isDirty = false;
+    uint8_t _dirtyBorders = 0;
 };
@@ -0,0 +1,307 @@
+#include "ChunkInstanciator.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <utility>
+
+#include "Chunk.hpp"
+#include "common/Util/Profiler.hpp"
+
+namespace {
+// Rounds towards negative infinity, so world -1 lands in chunk -1
+int floorDiv(int value, int divisor) {
+    int quotient = value / divisor;
+    return (value % divisor < 0) ? quotient - 1 : quotient;
+}
+
+// Neighbour offset across each Chunk::Border
+const std::array<glm::ivec3, 6> BORDER_OFFSETS = {
+    glm::ivec3(1, 0, 0), glm::ivec3(-1, 0, 0), glm::ivec3(0, 1, 0),
+    glm::ivec3(0, -1, 0), glm::ivec3(0, 0, 1), glm::ivec3(0, 0, -1)};
+} // namespace
+
+ChunkInstanciator::ChunkInstanciator(long int worldSeed, unsigned int workerCount)
+    : _generator(worldSeed), _workers(std::make_unique<ThreadPool>(workerCount)) {
+    _maxInFlight = _workers->getThreadCount() * JOBS_IN_FLIGHT_PER_WORKER;
+}
+
+ChunkInstanciator::~ChunkInstanciator() {
+    // Join the workers before the completion queue and chunk map go away
+    _workers.reset();
+}
+
+void ChunkInstanciator::requestChunkAt(const glm::ivec3& position) {
+    if (_loadedChunks.contains(position) || _requested.contains(position)) {
+        return; // Chunk already loaded or on its way
+    }
+    _requested.insert(position);
+    _requestQueue.push_back(position);
+    _requestsDirty = true;
+}
+
+ChunkInstanciator::ChunkBox ChunkInstanciator::computeChunkBox(float playerX, float playerY,
+                                                               float playerZ, float distance) {
+    ChunkBox box;
+    box.min.x = static_cast<int>(std::floor((playerX - distance) / Chunk::CHUNK_SIZE));
+    box.max.x = static_cast<int>(std::floor((playerX + distance) / Chunk::CHUNK_SIZE));
+    box.min.y = static_cast<int>(std::floor((playerY - distance) / Chunk::CHUNK_SIZE));
+    box.max.y = static_cast<int>(std::floor((playerY + distance) / Chunk::CHUNK_SIZE));
+    box.min.z = static_cast<int>(std::floor((playerZ - distance) / Chunk::CHUNK_SIZE));
+    box.max.z = static_cast<int>(std::floor((playerZ + distance) / Chunk::CHUNK_SIZE));
+    return box;
+}
+
+void ChunkInstanciator::updateChunksAroundPlayer(float playerX, float playerY, float playerZ,
+                                                 float loadDistance, float unloadDistance) {
+    _tick++;
+    const ChunkBox loadBox = computeChunkBox(playerX, playerY, playerZ, loadDistance);
+    _unloadBox =
+        computeChunkBox(playerX, playerY, playerZ, std::max(loadDistance, unloadDistance));
+
+    glm::ivec3 playerChunk(static_cast<int>(std::floor(playerX / Chunk::CHUNK_SIZE)),
+                           static_cast<int>(std::floor(playerY / Chunk::CHUNK_SIZE)),
+                           static_cast<int>(std::floor(playerZ / Chunk::CHUNK_SIZE)));
+    if (playerChunk != _playerChunk) {
+        _playerChunk = playerChunk;
+        _requestsDirty = true;
+    }
+
+    // Forget queued requests that left the view box before a worker picked them up
+    std::erase_if(_requestQueue, [&](const glm::ivec3& pos) {
+        bool outside = !loadBox.contains(pos);
+        if (outside) {
+            _requested.erase(pos);
+        }
+        return outside;
+    });
+
+    for (int x = loadBox.min.x; x <= loadBox.max.x; x++) {
+        for (int y = loadBox.min.y; y <= loadBox.max.y; y++) {
+            for (int z = loadBox.min.z; z <= loadBox.max.z; z++) {
+                glm::ivec3 position(x, y, z);
+                auto tick = _lastUsedTick.find(position);
+                if (tick != _lastUsedTick.end()) {
+                    tick->second = _tick; // Still wanted, refresh its LRU stamp
+                } else {
+                    requestChunkAt(position);
+                }
+            }
+        }
+    }
+
+    unloadOutsideBox();
+    if (_stats.residentBytes > _stats.maxResidentBytes) {
+        evictLeastRecentlyUsed();
+    }
+
+    if (_requestsDirty) {
+        sortRequestsByDistance();
+        _requestsDirty = false;
+    }
+    dispatchRequests();
+}
+
+void ChunkInstanciator::unloadChunkAt(const glm::ivec3& position) {
+    auto it = _loadedChunks.find(position);
+    if (it == _loadedChunks.end()) {
+        return;
+    }
+    _stats.residentBytes -= std::min(_stats.residentBytes, it->second->getMemoryUsage());
+    _loadedChunks.erase(it);
+    _lastUsedTick.erase(position);
+    _unloadedQueue.push_back(position);
+}
+
+void ChunkInstanciator::unloadOutsideBox() {
+    size_t residentBytes = 0;
+    for (auto it = _loadedChunks.begin(); it != _loadedChunks.end();) {
+        if (!_unloadBox.contains(it->first)) {
+            _lastUsedTick.erase(it->first);
+            _unloadedQueue.push_back(it->first);
+            it = _loadedChunks.erase(it);
+            _stats.unloadedChunks++;
+            continue;
+        }
+        // Recomputed every pass since edits can change a chunk's footprint
+        residentBytes += it->second->getMemoryUsage();
+        ++it;
+    }
+    _stats.residentBytes = residentBytes;
+    _stats.residentChunks = _loadedChunks.size();
+}
+
+void ChunkInstanciator::evictLeastRecentlyUsed() {
+    // Only chunks the current view no longer asks for are candidates, otherwise they
+    // would be requested again next frame. The cap is then enforced by dispatch.
+    std::vector<std::pair<uint64_t, glm::ivec3>> candidates;
+    for (const auto& [position, tick] : _lastUsedTick) {
+        if (tick != _tick) {
+            candidates.emplace_back(tick, position);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    for (const auto& [tick, position] : candidates) {
+        if (_stats.residentBytes <= _stats.maxResidentBytes) {
+            break;
+        }
+        unloadChunkAt(position);
+        _stats.evictedChunks++;
+    }
+    _stats.residentChunks = _loadedChunks.size();
+}
+
+bool ChunkInstanciator::hasMemoryForAnotherChunk() const {
+    // Chunks being generated will land soon, so count them against the cap too
+    size_t averageChunkBytes = _loadedChunks.empty()
+                                   ? sizeof(Chunk)
+                                   : _stats.residentBytes / _loadedChunks.size();
+    return _stats.residentBytes + ((_inFlight + 1) * averageChunkBytes) <=
+           _stats.maxResidentBytes;
+}
+
+void ChunkInstanciator::sortRequestsByDistance() {
+    auto distanceSq = [this](const glm::ivec3& pos) {
+        glm::ivec3 d = pos - _playerChunk;
+        return (d.x * d.x) + (d.y * d.y) + (d.z * d.z);
+    };
+    // Farthest first: dispatch pops the nearest request from the back
+    std::sort(_requestQueue.begin(), _requestQueue.end(),
+              [&](const glm::ivec3& a, const glm::ivec3& b) {
+                  return distanceSq(a) > distanceSq(b);
+              });
+}
+
+void ChunkInstanciator::dispatchRequests() {
+    while (_inFlight < _maxInFlight && !_requestQueue.empty() && hasMemoryForAnotherChunk()) {
+        glm::ivec3 position = _requestQueue.back();
+        _requestQueue.pop_back();
+        _inFlight++;
+
+        _workers->submit([completed = &_completed, generator = &_generator, position]() {
+            const Profiler::Scope scope("Generate chunk");
+            auto chunk = generator->generate(position);
+            completed->push(GeneratedChunk{.position = position, .chunk = std::move(chunk)});
+        });
+    }
+}
+
+size_t ChunkInstanciator::processGeneratedChunks(std::chrono::microseconds budget) {
+    const auto start = std::chrono::steady_clock::now();
+    size_t integrated = 0;
+
+    while (std::chrono::steady_clock::now() - start < budget) {
+        std::optional<GeneratedChunk> generated = _completed.tryPop();
+        if (!generated.has_value()) {
+            break;
+        }
+        _inFlight--;
+        _requested.erase(generated->position);
+        if (!_unloadBox.contains(generated->position)) {
+            continue; // The player moved away while this chunk was being built
+        }
+        // Generation is not an edit, but the chunk still needs its first mesh
+        generated->chunk->clearDirty();
+        _stats.residentBytes += generated->chunk->getMemoryUsage();
+        _lastUsedTick[generated->position] = _tick;
+        _loadedChunks[generated->position] = std::move(generated->chunk);
+        _remeshQueue.insert(generated->position);
+        // Loaded neighbours drew their faces against the gap this chunk now fills
+        for (const glm::ivec3& offset : BORDER_OFFSETS) {
+            if (_loadedChunks.contains(generated->position + offset)) {
+                _remeshQueue.insert(generated->position + offset);
+            }
+        }
+        integrated++;
+    }
+    _stats.residentChunks = _loadedChunks.size();
+
+    // Refill the workers with whatever finished this frame
+    dispatchRequests();
+    return integrated;
+}
+
+const Chunk* ChunkInstanciator::findChunk(const glm::ivec3& position) const {
+    auto it = _loadedChunks.find(position);
+    return it != _loadedChunks.end() ? it->second.get() : nullptr;
+}
+
+bool ChunkInstanciator::setBlock(int worldX, int worldY, int worldZ, uint8_t blockId) {
+    const glm::ivec3 position(floorDiv(worldX, Chunk::CHUNK_SIZE),
+                              floorDiv(worldY, Chunk::CHUNK_SIZE),
+                              floorDiv(worldZ, Chunk::CHUNK_SIZE));
+    auto it = _loadedChunks.find(position);
+    if (it == _loadedChunks.end()) {
+        return false;
+    }
+
+    Chunk& chunk = *it->second;
+    chunk.setBlock(worldX - (position.x * Chunk::CHUNK_SIZE),
+                   worldY - (position.y * Chunk::CHUNK_SIZE),
+                   worldZ - (position.z * Chunk::CHUNK_SIZE), blockId);
+    if (chunk.isDirty()) {
+        _remeshQueue.insert(position);
+    }
+    return true;
+}
+
+std::vector<glm::ivec3> ChunkInstanciator::takeRemeshQueue(size_t maxChunks) {
+    std::unordered_set<glm::ivec3> toRemesh;
+    for (const glm::ivec3& position : _remeshQueue) {
+        auto it = _loadedChunks.find(position);
+        if (it == _loadedChunks.end()) {
+            continue; // Unloaded since the edit
+        }
+        Chunk& chunk = *it->second;
+        toRemesh.insert(position);
+
+        // Accumulated over every edit since the last remesh
+        const uint8_t borders = chunk.getDirtyBorders();
+        for (size_t border = 0; border < BORDER_OFFSETS.size(); border++) {
+            const glm::ivec3 neighbor = position + BORDER_OFFSETS.at(border);
+            if ((borders & (1U << border)) != 0 && _loadedChunks.contains(neighbor)) {
+                toRemesh.insert(neighbor);
+            }
+        }
+        chunk.clearDirty();
+    }
+    _remeshQueue.clear();
+
+    std::vector<glm::ivec3> positions(toRemesh.begin(), toRemesh.end());
+    auto distanceSq = [this](const glm::ivec3& pos) {
+        glm::ivec3 d = pos - _playerChunk;
+        return (d.x * d.x) + (d.y * d.y) + (d.z * d.z);
+    };
+    std::sort(positions.begin(), positions.end(),
+              [&](const glm::ivec3& a, const glm::ivec3& b) {
+                  return distanceSq(a) < distanceSq(b);
+              });
+
+    // Left for the next call, the nearest chunks get their meshes first
+    if (positions.size() > maxChunks) {
+        _remeshQueue.insert(positions.begin() + static_cast<std::ptrdiff_t>(maxChunks),
+                            positions.end());
+        positions.resize(maxChunks);
+    }
+    return positions;
+}
+
+std::vector<glm::ivec3> ChunkInstanciator::takeUnloadedChunks() {
+    return std::exchange(_unloadedQueue, {});
+}
+
+void ChunkInstanciator::requestRemesh(std::span<const glm::ivec3> positions) {
+    for (const glm::ivec3& position : positions) {
+        if (_loadedChunks.contains(position)) {
+            _remeshQueue.insert(position);
+        }
+    }
+}
+
+void ChunkInstanciator::requestRemeshAll() {
+    for (const auto& [position, chunk] : _loadedChunks) {
+        _remeshQueue.insert(position);
+    }
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "common/Util/MPSCQueue.hpp"
+#include "common/Util/ThreadPool.hpp"
+#include "TerrainGenerator.hpp"
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtx/hash.hpp>
+
+class Chunk;
+using chunkMap = std::unordered_map<glm::ivec3, std::unique_ptr<Chunk>>;
+
+// Streams chunks around the player.
+// The render thread only decides *which* chunks are needed (nearest first);
+// block data is built by the TerrainGenerator on worker threads and handed back
+// through a lock-free completion queue that is drained under a per-frame time budget.
+// Chunks are unloaded once they leave a wider unload box (hysteresis), and the
+// least recently used ones are evicted whenever residency exceeds the memory cap.
+class ChunkInstanciator {
+  public:
+    // Jobs kept in flight per worker so threads never starve between frames
+    static constexpr size_t JOBS_IN_FLIGHT_PER_WORKER = 2;
+    static constexpr size_t DEFAULT_MAX_RESIDENT_BYTES = size_t{512} * 1024 * 1024;
+
+    struct ResidencyStats {
+        size_t residentChunks = 0;
+        size_t residentBytes = 0;
+        size_t maxResidentBytes = 0;
+        size_t unloadedChunks = 0; // Total left the unload box
+        size_t evictedChunks = 0;  // Total dropped to honour the memory cap
+    };
+
+    // Every chunk depends only on worldSeed and its position, never on the order or the
+    // thread it was generated on
+    explicit ChunkInstanciator(long int worldSeed = TerrainGenerator::DEFAULT_SEED,
+                               unsigned int workerCount = 0);
+    ~ChunkInstanciator();
+    ChunkInstanciator(const ChunkInstanciator&) = delete;
+    ChunkInstanciator& operator=(const ChunkInstanciator&) = delete;
+    ChunkInstanciator(ChunkInstanciator&&) = delete;
+    ChunkInstanciator& operator=(ChunkInstanciator&&) = delete;
+
+    // Checks which chunks need to be loaded/unloaded based on player position.
+    // Chunks are requested inside loadDistance and only dropped beyond unloadDistance,
+    // so walking back and forth across a chunk border does not thrash.
+    void updateChunksAroundPlayer(float playerX, float playerY, float playerZ, float loadDistance,
+                                  float unloadDistance);
+
+    // Moves finished chunks into the loaded set until the budget is spent.
+    // Returns the number of chunks integrated this call.
+    size_t processGeneratedChunks(std::chrono::microseconds budget);
+
+    // Edits a block in world coordinates. Returns false when its chunk is not loaded.
+    bool setBlock(int worldX, int worldY, int worldZ, uint8_t blockId);
+    // Chunks that need a (new) mesh: edited or newly loaded ones, each listed once however
+    // many edits it got, plus the loaded neighbours of edited borders and of new chunks.
+    // Nearest to the player first, at most maxChunks; the rest stays queued.
+    std::vector<glm::ivec3> takeRemeshQueue(size_t maxChunks);
+    // Chunks unloaded or evicted since the last call, whose meshes can be released
+    std::vector<glm::ivec3> takeUnloadedChunks();
+    // Queues the given loaded chunks for a remesh, e.g. after their level of detail changed
+    void requestRemesh(std::span<const glm::ivec3> positions);
+    // Queues every loaded chunk for a remesh, e.g. after switching mesher
+    void requestRemeshAll();
+
+    [[nodiscard]] const Chunk* findChunk(const glm::ivec3& position) const;
+    [[nodiscard]] const chunkMap& getLoadedChunks() const { return _loadedChunks; }
+    [[nodiscard]] size_t getQueuedCount() const { return _requestQueue.size(); }
+    [[nodiscard]] size_t getInFlightCount() const { return _inFlight; }
+    [[nodiscard]] const ResidencyStats& getResidencyStats() const { return _stats; }
+    [[nodiscard]] const TerrainGenerator& getGenerator() const { return _generator; }
+
+    void setMaxResidentBytes(size_t bytes) { _stats.maxResidentBytes = bytes; }
+
+  private:
+    struct GeneratedChunk {
+        glm::ivec3 position;
+        std::unique_ptr<Chunk> chunk;
+    };
+
+    struct ChunkBox {
+        glm::ivec3 min{0, 0, 0};
+        glm::ivec3 max{-1, -1, -1};
+
+        [[nodiscard]] bool contains(const glm::ivec3& pos) const {
+            return pos.x >= min.x && pos.x <= max.x && pos.y >= min.y && pos.y <= max.y &&
+                   pos.z >= min.z && pos.z <= max.z;
+        }
+    };
+
+    static ChunkBox computeChunkBox(float playerX, float playerY, float playerZ, float distance);
+
+    void requestChunkAt(const glm::ivec3& position);
+    void sortRequestsByDistance();
+    void dispatchRequests();
+    void unloadChunkAt(const glm::ivec3& position);
+    void unloadOutsideBox();
+    void evictLeastRecentlyUsed();
+    [[nodiscard]] bool hasMemoryForAnotherChunk() const;
+
+    chunkMap _loadedChunks;
+    // Tick of the last update that wanted each loaded chunk (LRU order)
+    std::unordered_map<glm::ivec3, uint64_t> _lastUsedTick;
+    uint64_t _tick = 0;
+    ChunkBox _unloadBox;
+    ResidencyStats _stats{.maxResidentBytes = DEFAULT_MAX_RESIDENT_BYTES};
+
+    // Pending coordinates, sorted farthest-first so the nearest one is at the back
+    std::vector<glm::ivec3> _requestQueue;
+    // Every coordinate that is queued or currently being generated
+    std::unordered_set<glm::ivec3> _requested;
+    size_t _inFlight = 0;
+    size_t _maxInFlight = 0;
+
+    // Chunks waiting for takeRemeshQueue(), a set so repeated edits coalesce
+    std::unordered_set<glm::ivec3> _remeshQueue;
+    // Chunks dropped since the last takeUnloadedChunks()
+    std::vector<glm::ivec3> _unloadedQueue;
+
+    glm::ivec3 _playerChunk{0, 0, 0};
+    bool _requestsDirty = false;
+
+    MPSCQueue<GeneratedChunk> _completed;
+    TerrainGenerator _generator;
+    // Declared last: joined before the completion queue and generator it uses are destroyed
+    std::unique_ptr<ThreadPool> _workers;
+};
@@ -0,0 +1,125 @@
+#include "ChunkLod.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+namespace {
+constexpr int SIZE = Chunk::CHUNK_SIZE;
+
+size_t voxelIndex(int x, int y, int z) {
+    return static_cast<size_t>(x + (y * SIZE) + (z * SIZE * SIZE));
+}
+} // namespace
+
+glm::ivec3 ChunkLod::slicePosition(int axis, int layer, int u, int v) {
+    switch (axis) {
+    case 0:
+        return {layer, v, u};
+    case 1:
+        return {u, layer, v};
+    default:
+        return {u, v, layer};
+    }
+}
+
+int ChunkLod::selectLevel(const glm::ivec3& chunkPosition, const glm::ivec3& cameraChunk) {
+    const glm::ivec3 d = chunkPosition - cameraChunk;
+    const int distance = std::max({std::abs(d.x), std::abs(d.y), std::abs(d.z)});
+    for (int level = 0; level < MAX_LEVEL; level++) {
+        if (distance <= LEVEL_DISTANCES.at(static_cast<size_t>(level))) {
+            return level;
+        }
+    }
+    return MAX_LEVEL;
+}
+
+void ChunkLod::downsample(std::span<uint8_t, Chunk::VOLUME> blocks, int level) {
+    const int cell = getCellSize(level);
+    if (cell == 1) {
+        return;
+    }
+    const int cellVolume = cell * cell * cell;
+    // (block, count) pairs: cells rarely hold more than a handful of block types
+    std::vector<std::pair<uint8_t, int>> counts;
+
+    for (int cz = 0; cz < SIZE; cz += cell) {
+        for (int cy = 0; cy < SIZE; cy += cell) {
+            for (int cx = 0; cx < SIZE; cx += cell) {
+                counts.clear();
+                int solid = 0;
+                for (int z = cz; z < cz + cell; z++) {
+                    for (int y = cy; y < cy + cell; y++) {
+                        for (int x = cx; x < cx + cell; x++) {
+                            const uint8_t block = blocks[voxelIndex(x, y, z)];
+                            if (block == Chunk::AIR_BLOCK_ID) {
+                                continue;
+                            }
+                            solid++;
+                            auto it =
+                                std::find_if(counts.begin(), counts.end(),
+                                             [&](const auto& c) { return c.first == block; });
+                            if (it == counts.end()) {
+                                counts.emplace_back(block, 1);
+                            } else {
+                                it->second++;
+                            }
+                        }
+                    }
+                }
+
+                uint8_t value = Chunk::AIR_BLOCK_ID;
+                if (solid * 2 >= cellVolume) {
+                    value = std::max_element(counts.begin(), counts.end(),
+                                             [](const auto& a, const auto& b) {
+                                                 return a.second < b.second;
+                                             })
+                                ->first;
+                }
+                for (int z = cz; z < cz + cell; z++) {
+                    for (int y = cy; y < cy + cell; y++) {
+                        std::fill_n(blocks.begin() + static_cast<std::ptrdiff_t>(
+                                                         voxelIndex(cx, y, z)),
+                                    cell, value);
+                    }
+                }
+            }
+        }
+    }
+}
+
+std::bitset<ChunkLod::FACE_AREA> ChunkLod::sliceSolidity(const PalettedBlockStorage& blocks,
+                                                         int level, int axis, int layer) {
+    std::bitset<FACE_AREA> solidity;
+    const int cell = getCellSize(level);
+    const int cellVolume = cell * cell * cell;
+    // First voxel of the cells touching the slice along the axis
+    const int cellLayer = layer - (layer % cell);
+
+    // One majority vote per cell, shared by the cell x cell slots it covers
+    for (int cv = 0; cv < SIZE; cv += cell) {
+        for (int cu = 0; cu < SIZE; cu += cell) {
+            int solid = 0;
+            for (int w = cellLayer; w < cellLayer + cell; w++) {
+                for (int v = cv; v < cv + cell; v++) {
+                    for (int u = cu; u < cu + cell; u++) {
+                        const glm::ivec3 p = slicePosition(axis, w, u, v);
+                        if (blocks.get(voxelIndex(p.x, p.y, p.z)) != Chunk::AIR_BLOCK_ID) {
+                            solid++;
+                        }
+                    }
+                }
+            }
+            if (solid * 2 < cellVolume) {
+                continue;
+            }
+            for (int v = cv; v < cv + cell; v++) {
+                for (int u = cu; u < cu + cell; u++) {
+                    solidity.set(static_cast<size_t>(u + (v * SIZE)));
+                }
+            }
+        }
+    }
+    return solidity;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include <glm/glm.hpp>
+
+#include "Chunk.hpp"
+
+// Levels of detail for distant chunk meshes. At level n every cell of 2^n x 2^n x 2^n
+// voxels is merged into one block, but the chunk keeps its 32^3 layout (each voxel takes
+// its cell's value), so the regular meshers apply unchanged and the greedy ones merge
+// each cell face into a single quad.
+class ChunkLod {
+  public:
+    // 4x4x4 voxels per cell. Past LEVEL_DISTANCES.back() chunks are drawn as merged
+    // ChunkRegions, already at this level, and every chunk more than 16 chunks away is
+    // in a merged region, so an 8x8x8 level would never be meshed at any load distance.
+    // Coarser far terrain would have to come from coarser regions.
+    static constexpr int MAX_LEVEL = 2;
+    // Chebyshev distance in chunks up to which each level is used, MAX_LEVEL beyond.
+    // Doubling rings keep cells at roughly the same size on screen.
+    static constexpr std::array<int, MAX_LEVEL> LEVEL_DISTANCES = {4, 8};
+    static constexpr size_t FACE_AREA = static_cast<size_t>(Chunk::CHUNK_SIZE) * Chunk::CHUNK_SIZE;
+
+    [[nodiscard]] static constexpr int getCellSize(int level) { return 1 << level; }
+    [[nodiscard]] static int selectLevel(const glm::ivec3& chunkPosition,
+                                         const glm::ivec3& cameraChunk);
+
+    // Replaces every cell of `level` with its dominant block, in place (layout of
+    // Chunk::copyBlocks). A cell is solid when at least half of its voxels are, and then
+    // takes its most common solid block.
+    static void downsample(std::span<uint8_t, Chunk::VOLUME> blocks, int level);
+
+    // Solidity of one boundary slice of a chunk's blocks as seen at `level`: voxels at
+    // `layer` along `axis`, slot u + v * CHUNK_SIZE in the face axes of ChunkSnapshot's
+    // borders (X: z, y; Y: x, z; Z: x, y)
+    [[nodiscard]] static std::bitset<FACE_AREA>
+    sliceSolidity(const PalettedBlockStorage& blocks, int level, int axis, int layer);
+    // Coordinates of slot (u, v) of the slice at `layer` along `axis`
+    [[nodiscard]] static glm::ivec3 slicePosition(int axis, int layer, int u, int v);
+};
@@ -1,196 +1,514 @@
 #include "ChunkMesh.hpp"
 
+#include <algorithm>
+#include <array>
+#include <bit>
+
+#include "ChunkLod.hpp"
+
 namespace {
-// Helper function to pack a vertex's data into a uint32_t
-// Bit layout: [X:6][Y:6][Z:6][Normal:3][UV:2][Texture:7][Spare:2]
-uint32_t packVertex(uint32_t x, uint32_t y, uint32_t z, uint32_t normalId, uint32_t uvId,
-                    uint32_t textureId) {
-    uint32_t packedData = 0;
+// Helper function to pack a face rectangle into a quad record (see VoxelQuad)
+VoxelQuad packQuad(uint32_t x, uint32_t y, uint32_t z, uint32_t normalId, uint32_t width,
+                   uint32_t height, uint32_t textureId) {
+    uint32_t geometry = 0;
 
-    // 6 bits for X, 6 for Y, 6 for Z
-    packedData |= (x & 0x3F);         // X in bits 0-5
-    packedData |= ((y & 0x3F) << 6);  // Y in bits 6-11
-    packedData |= ((z & 0x3F) << 12); // Z in bits 12-17
+    // 5 bits for X, 5 for Y, 5 for Z: the voxel the face belongs to
+    geometry |= (x & 0x1F);         // X in bits 0-4
+    geometry |= ((y & 0x1F) << 5);  // Y in bits 5-9
+    geometry |= ((z & 0x1F) << 10); // Z in bits 10-14
 
     // 3 bits for Normal ID
-    packedData |= ((normalId & 0x7) << 18); // Normal ID in bits 18-20
+    geometry |= ((normalId & 0x7) << 15); // Normal ID in bits 15-17
+
+    // 5 bits each for the size minus one, 1 to 32 voxels
+    geometry |= (((width - 1) & 0x1F) << 18);  // Width in bits 18-22
+    geometry |= (((height - 1) & 0x1F) << 23); // Height in bits 23-27
+
+    // The remaining 4 bits (28-31) are spare
 
-    // 2 bits for UV Corner ID
-    packedData |= ((uvId & 0x3) << 21); // UV ID in bits 21-22
+    return VoxelQuad{.geometry = geometry, .texture = textureId & 0x7F};
+}
+
+uint32_t unpackNormalId(const VoxelQuad& quad) {
+    return (quad.geometry >> 15) & 0x7;
+}
 
-    // 7 bits for Texture ID
-    packedData |= ((textureId & 0x7F) << 23); // Texture ID in bits 23-29
+using DisplayableTable = std::array<bool, 256>;
+using BitMatrix32 = std::array<uint32_t, 32>;
 
-    // The remaining 2 bits (30-31) are spare
+// In-place transpose of a 32x32 bit matrix: bit c of row r swaps with bit r of row c
+void transposeBitMatrix(BitMatrix32& rows) {
+    uint32_t mask = 0x0000FFFFU;
+    for (size_t j = 16; j != 0; j >>= 1, mask ^= mask << j) {
+        for (size_t k = 0; k < 32; k = (k + j + 1) & ~j) {
+            const uint32_t t = ((rows[k] >> j) ^ rows[k + j]) & mask;
+            rows[k] ^= t << j;
+            rows[k + j] ^= t;
+        }
+    }
+}
 
-    return packedData;
+DisplayableTable buildDisplayableTable(const BlockRegistry& registry) {
+    DisplayableTable table{};
+    for (int id = 0; id < MAX_BLOCKS; id++) {
+        table.at(static_cast<size_t>(id)) = registry.isDisplayable(id);
+    }
+    return table;
 }
+
+// Dense copy of a snapshot, so bulk meshers never go through per-voxel bounds
+// checks, palette lookups or neighbour pointers.
+class MeshInput {
+  public:
+    static constexpr int SIZE = Chunk::CHUNK_SIZE;
+
+    explicit MeshInput(const ChunkSnapshot& snapshot) : _snapshot(snapshot) {
+        snapshot.getBlocks().copyTo(_blocks);
+        ChunkLod::downsample(_blocks, snapshot.getLevel());
+    }
+
+    // index = x + y * SIZE + z * SIZE * SIZE, same as Chunk
+    [[nodiscard]] uint8_t getBlock(size_t index) const { return _blocks[index]; }
+    [[nodiscard]] uint8_t getBlock(int x, int y, int z) const {
+        return _blocks[static_cast<size_t>(x + (y * SIZE) + (z * SIZE * SIZE))];
+    }
+    [[nodiscard]] bool isBorderSolid(size_t side, size_t slot) const {
+        return _snapshot.isBorderSolid(side, slot);
+    }
+
+    // Accepts coordinates at most one voxel outside the chunk, on a single axis
+    [[nodiscard]] bool isSolid(int x, int y, int z) const {
+        if (x == SIZE || x < 0) {
+            return isBorderSolid(x < 0 ? ChunkSnapshot::WEST : ChunkSnapshot::EAST,
+                                 static_cast<size_t>(z + (y * SIZE)));
+        }
+        if (y == SIZE || y < 0) {
+            return isBorderSolid(y < 0 ? ChunkSnapshot::BOTTOM : ChunkSnapshot::TOP,
+                                 static_cast<size_t>(x + (z * SIZE)));
+        }
+        if (z == SIZE || z < 0) {
+            return isBorderSolid(z < 0 ? ChunkSnapshot::SOUTH : ChunkSnapshot::NORTH,
+                                 static_cast<size_t>(x + (y * SIZE)));
+        }
+        return getBlock(x, y, z) != Chunk::AIR_BLOCK_ID;
+    }
+
+  private:
+    const ChunkSnapshot& _snapshot;
+    std::array<uint8_t, Chunk::VOLUME> _blocks{};
+};
 } // anonymous namespace
 
+ChunkMesh::FaceAxes ChunkMesh::getFaceAxes(FaceDirection direction) {
+    // Must match the width/height conventions of addQuad
+    switch (direction) {
+    case FaceDirection::East:
+        return {.normalAxis = 0, .uAxis = 2, .vAxis = 1, .normalSign = 1};
+    case FaceDirection::West:
+        return {.normalAxis = 0, .uAxis = 2, .vAxis = 1, .normalSign = -1};
+    case FaceDirection::Top:
+        return {.normalAxis = 1, .uAxis = 0, .vAxis = 2, .normalSign = 1};
+    case FaceDirection::Bottom:
+        return {.normalAxis = 1, .uAxis = 0, .vAxis = 2, .normalSign = -1};
+    case FaceDirection::North:
+        return {.normalAxis = 2, .uAxis = 0, .vAxis = 1, .normalSign = 1};
+    case FaceDirection::South:
+        return {.normalAxis = 2, .uAxis = 0, .vAxis = 1, .normalSign = -1};
+    }
+    return {};
+}
+
 void ChunkMesh::generateMesh(const Chunk& mainChunk, const BlockRegistry& registry,
-                             std::vector<VoxelVertex>& vertices, std::vector<uint32_t>& indices,
-                             const Chunk* neighborNorth, const Chunk* neighborSouth,
-                             const Chunk* neighborEast, const Chunk* neighborWest,
-                             const Chunk* neighborTop, const Chunk* neighborBottom) {
-    vertices.clear();
-    indices.clear();
-
-    if (mainChunk.isEmpty()) {
+                             std::vector<VoxelQuad>& quads, const Chunk* neighborNorth,
+                             const Chunk* neighborSouth, const Chunk* neighborEast,
+                             const Chunk* neighborWest, const Chunk* neighborTop,
+                             const Chunk* neighborBottom, MeshingMode mode) {
+    const ChunkSnapshot snapshot(mainChunk, neighborNorth, neighborSouth, neighborEast,
+                                 neighborWest, neighborTop, neighborBottom);
+    generateMesh(snapshot, registry, quads, mode);
+}
+
+void ChunkMesh::generateMesh(const ChunkSnapshot& snapshot, const BlockRegistry& registry,
+                             std::vector<VoxelQuad>& quads, MeshingMode mode) {
+    quads.clear();
+
+    if (snapshot.isEmpty()) {
         return;
     }
 
+    switch (mode) {
+    case MeshingMode::PerFace:
+        generatePerFace(snapshot, registry, quads);
+        break;
+    case MeshingMode::Greedy:
+        generateGreedy(snapshot, registry, quads);
+        break;
+    case MeshingMode::Binary:
+        generateBinary(snapshot, registry, quads);
+        break;
+    }
+    groupByDirection(quads);
+}
+
+const char* ChunkMesh::getMeshingModeName(MeshingMode mode) {
+    switch (mode) {
+    case MeshingMode::PerFace:
+        return "Per-face";
+    case MeshingMode::Greedy:
+        return "Greedy";
+    case MeshingMode::Binary:
+        return "Binary";
+    }
+    return "Unknown";
+}
+
+FaceQuadCounts ChunkMesh::countFaceQuads(std::span<const VoxelQuad> quads) {
+    FaceQuadCounts counts{};
+    for (const VoxelQuad& quad : quads) {
+        counts.at(unpackNormalId(quad))++;
+    }
+    return counts;
+}
+
+void ChunkMesh::groupByDirection(std::vector<VoxelQuad>& quads) {
+    auto byDirection = [](const VoxelQuad& a, const VoxelQuad& b) {
+        return unpackNormalId(a) < unpackNormalId(b);
+    };
+    if (std::is_sorted(quads.begin(), quads.end(), byDirection)) {
+        return;
+    }
+
+    // Counting sort: each direction's range starts after the ranges before it
+    const FaceQuadCounts counts = countFaceQuads(quads);
+    FaceQuadCounts next{};
+    for (size_t direction = 1; direction < FACE_DIRECTION_COUNT; direction++) {
+        next.at(direction) = next.at(direction - 1) + counts.at(direction - 1);
+    }
+    std::vector<VoxelQuad> sorted(quads.size());
+    for (const VoxelQuad& quad : quads) {
+        sorted[next.at(unpackNormalId(quad))++] = quad;
+    }
+    quads = std::move(sorted);
+}
+
+void ChunkMesh::generatePerFace(const ChunkSnapshot& snapshot, const BlockRegistry& registry,
+                                std::vector<VoxelQuad>& quads) {
+    const MeshInput input(snapshot);
+
     for (int x = 0; x < Chunk::CHUNK_SIZE; x++) {
         for (int y = 0; y < Chunk::CHUNK_SIZE; y++) {
             for (int z = 0; z < Chunk::CHUNK_SIZE; z++) {
-                int blockId = static_cast<int>(mainChunk.getBlock(x, y, z));
+                int blockId = static_cast<int>(input.getBlock(x, y, z));
 
                 // Skip air blocks or non-displayable blocks
                 if (blockId == Chunk::AIR_BLOCK_ID || !registry.isDisplayable(blockId)) {
                     continue;
                 }
 
-                // North (+Z)
-                bool isNorthSolid =
-                    (z == Chunk::CHUNK_SIZE - 1)
-                        ? (neighborNorth != nullptr && neighborNorth->isBlockSolid(x, y, 0))
-                        : mainChunk.isBlockSolid(x, y, z + 1);
-                if (!isNorthSolid) {
-                    addFace(FaceDirection::North, x, y, z, blockId, vertices, indices);
+                // A face is visible when the voxel next to it is not solid.
+                // Out-of-chunk coordinates read the neighbour border slices.
+                if (!input.isSolid(x, y, z + 1)) {
+                    addFace(FaceDirection::North, x, y, z, blockId, quads);
                 }
-
-                // South (-Z)
-                bool isSouthSolid = (z == 0)
-                                        ? (neighborSouth != nullptr &&
-                                           neighborSouth->isBlockSolid(x, y, Chunk::CHUNK_SIZE - 1))
-                                        : mainChunk.isBlockSolid(x, y, z - 1);
-                if (!isSouthSolid) {
-                    addFace(FaceDirection::South, x, y, z, blockId, vertices, indices);
+                if (!input.isSolid(x, y, z - 1)) {
+                    addFace(FaceDirection::South, x, y, z, blockId, quads);
+                }
+                if (!input.isSolid(x + 1, y, z)) {
+                    addFace(FaceDirection::East, x, y, z, blockId, quads);
+                }
+                if (!input.isSolid(x - 1, y, z)) {
+                    addFace(FaceDirection::West, x, y, z, blockId, quads);
+                }
+                if (!input.isSolid(x, y + 1, z)) {
+                    addFace(FaceDirection::Top, x, y, z, blockId, quads);
+                }
+                if (!input.isSolid(x, y - 1, z)) {
+                    addFace(FaceDirection::Bottom, x, y, z, blockId, quads);
                 }
+            }
+        }
+    }
+
+    // Mesh generation complete
+}
+
+void ChunkMesh::generateGreedy(const ChunkSnapshot& snapshot, const BlockRegistry& registry,
+                               std::vector<VoxelQuad>& quads) {
+    constexpr int SIZE = Chunk::CHUNK_SIZE;
+    const MeshInput input(snapshot);
+    const DisplayableTable displayable = buildDisplayableTable(registry);
 
-                // East (+X)
-                bool isEastSolid =
-                    (x == Chunk::CHUNK_SIZE - 1)
-                        ? (neighborEast != nullptr && neighborEast->isBlockSolid(0, y, z))
-                        : mainChunk.isBlockSolid(x + 1, y, z);
-                if (!isEastSolid) {
-                    addFace(FaceDirection::East, x, y, z, blockId, vertices, indices);
+    // One slice of visible faces at a time, 0 = no face, otherwise the block ID.
+    // The mask is laid out [v][u] where (u, v) are the quad's width/height axes.
+    std::array<uint8_t, static_cast<size_t>(SIZE * SIZE)> mask{};
+
+    // Flat index stride of each axis (X, Y, Z)
+    constexpr std::array<int, 3> STRIDES = {1, SIZE, SIZE * SIZE};
+
+    for (size_t side = 0; side < ALL_DIRECTIONS.size(); side++) {
+        const FaceDirection direction = ALL_DIRECTIONS.at(side);
+        const FaceAxes axes = getFaceAxes(direction);
+        const int normalStride = STRIDES.at(axes.normalAxis);
+        const int uStride = STRIDES.at(axes.uAxis);
+        const int vStride = STRIDES.at(axes.vAxis);
+
+        for (int slice = 0; slice < SIZE; slice++) {
+            // The slice next to this one across the face, or the neighbour chunk's border
+            const int adjacent = slice + axes.normalSign;
+            const bool adjacentIsBorder = adjacent < 0 || adjacent >= SIZE;
+            const int adjacentOffset = axes.normalSign * normalStride;
+
+            // --- Build the visibility mask for this slice ---
+            for (int v = 0; v < SIZE; v++) {
+                for (int u = 0; u < SIZE; u++) {
+                    const int index = (slice * normalStride) + (u * uStride) + (v * vStride);
+                    const auto slot = static_cast<size_t>((v * SIZE) + u);
+
+                    uint8_t blockId = input.getBlock(static_cast<size_t>(index));
+                    bool visible = blockId != Chunk::AIR_BLOCK_ID && displayable[blockId];
+                    if (visible && adjacentIsBorder) {
+                        visible = !input.isBorderSolid(side, slot);
+                    } else if (visible) {
+                        auto adjacentIndex = static_cast<size_t>(index + adjacentOffset);
+                        visible = input.getBlock(adjacentIndex) == Chunk::AIR_BLOCK_ID;
+                    }
+                    mask[slot] = visible ? blockId : Chunk::AIR_BLOCK_ID;
                 }
+            }
+
+            // --- Merge the mask into maximal rectangles of identical blocks ---
+            for (int v = 0; v < SIZE; v++) {
+                for (int u = 0; u < SIZE;) {
+                    uint8_t blockId = mask[static_cast<size_t>((v * SIZE) + u)];
+                    if (blockId == Chunk::AIR_BLOCK_ID) {
+                        u++;
+                        continue;
+                    }
 
-                // West (-X)
-                bool isWestSolid = (x == 0)
-                                       ? (neighborWest != nullptr &&
-                                          neighborWest->isBlockSolid(Chunk::CHUNK_SIZE - 1, y, z))
-                                       : mainChunk.isBlockSolid(x - 1, y, z);
-                if (!isWestSolid) {
-                    addFace(FaceDirection::West, x, y, z, blockId, vertices, indices);
+                    // Grow along u while the block matches
+                    int width = 1;
+                    while (u + width < SIZE &&
+                           mask[static_cast<size_t>((v * SIZE) + u + width)] == blockId) {
+                        width++;
+                    }
+
+                    // Grow along v while the whole row [u, u + width) matches
+                    int height = 1;
+                    bool rowMatches = true;
+                    while (v + height < SIZE && rowMatches) {
+                        for (int k = 0; k < width; k++) {
+                            if (mask[static_cast<size_t>(((v + height) * SIZE) + u + k)] !=
+                                blockId) {
+                                rowMatches = false;
+                                break;
+                            }
+                        }
+                        if (rowMatches) {
+                            height++;
+                        }
+                    }
+
+                    // Consume the merged area so it is not emitted twice
+                    for (int dv = 0; dv < height; dv++) {
+                        for (int du = 0; du < width; du++) {
+                            mask[static_cast<size_t>(((v + dv) * SIZE) + u + du)] =
+                                Chunk::AIR_BLOCK_ID;
+                        }
+                    }
+
+                    glm::ivec3 origin(0, 0, 0);
+                    origin[axes.normalAxis] = slice;
+                    origin[axes.uAxis] = u;
+                    origin[axes.vAxis] = v;
+                    addQuad(direction, origin.x, origin.y, origin.z, width, height, blockId,
+                            quads);
+
+                    u += width;
                 }
+            }
+        }
+    }
+}
+
+void ChunkMesh::generateBinary(const ChunkSnapshot& snapshot, const BlockRegistry& registry,
+                               std::vector<VoxelQuad>& quads) {
+    constexpr int SIZE = Chunk::CHUNK_SIZE;
+    static_assert(SIZE == 32, "Binary meshing packs one chunk row into a 32-bit mask");
+    constexpr size_t PLANE = static_cast<size_t>(SIZE) * SIZE;
+    constexpr std::array<int, 3> STRIDES = {1, SIZE, SIZE * SIZE};
+    const MeshInput input(snapshot);
+    const DisplayableTable displayable = buildDisplayableTable(registry);
 
-                // Top (+Y)
-                bool isTopSolid =
-                    (y == Chunk::CHUNK_SIZE - 1)
-                        ? (neighborTop != nullptr && neighborTop->isBlockSolid(x, 0, z))
-                        : mainChunk.isBlockSolid(x, y + 1, z);
-                if (!isTopSolid) {
-                    addFace(FaceDirection::Top, x, y, z, blockId, vertices, indices);
+    // --- Occupancy columns ---
+    // One 64-bit column per (u, v) of each axis, indexed like MeshInput's borders.
+    // Bit i + 1 is voxel i along the axis, bit 0 and bit SIZE + 1 are the neighbours.
+    // X columns come straight from the x rows, Y and Z columns are bit transposes of them.
+    std::array<std::array<uint64_t, PLANE>, 3> columns{};
+    BitMatrix32 rowsByY{};
+    BitMatrix32 rowsByZ{};
+    std::array<BitMatrix32, SIZE> rowsByZPerY{};
+    for (int z = 0; z < SIZE; z++) {
+        for (int y = 0; y < SIZE; y++) {
+            const auto base = static_cast<size_t>((y * SIZE) + (z * SIZE * SIZE));
+            uint32_t row = 0;
+            for (int x = 0; x < SIZE; x++) {
+                row |= static_cast<uint32_t>(input.getBlock(base + static_cast<size_t>(x)) !=
+                                             Chunk::AIR_BLOCK_ID)
+                       << x;
+            }
+            columns[0][static_cast<size_t>(z + (y * SIZE))] = static_cast<uint64_t>(row) << 1;
+            rowsByY[static_cast<size_t>(y)] = row;
+            rowsByZPerY[static_cast<size_t>(y)][static_cast<size_t>(z)] = row;
+        }
+        transposeBitMatrix(rowsByY); // Now indexed by x, bits along y
+        for (int x = 0; x < SIZE; x++) {
+            columns[1][static_cast<size_t>(x + (z * SIZE))] =
+                static_cast<uint64_t>(rowsByY[static_cast<size_t>(x)]) << 1;
+        }
+    }
+    for (int y = 0; y < SIZE; y++) {
+        rowsByZ = rowsByZPerY[static_cast<size_t>(y)];
+        transposeBitMatrix(rowsByZ); // Now indexed by x, bits along z
+        for (int x = 0; x < SIZE; x++) {
+            columns[2][static_cast<size_t>(x + (y * SIZE))] =
+                static_cast<uint64_t>(rowsByZ[static_cast<size_t>(x)]) << 1;
+        }
+    }
+    constexpr uint64_t HIGH_BORDER = uint64_t{1} << (SIZE + 1);
+    for (size_t slot = 0; slot < PLANE; slot++) {
+        for (size_t axis = 0; axis < 3; axis++) {
+            // Borders come in (positive, negative) pairs in ALL_DIRECTIONS order
+            if (input.isBorderSolid(axis * 2, slot)) {
+                columns[axis][slot] |= HIGH_BORDER;
+            }
+            if (input.isBorderSolid((axis * 2) + 1, slot)) {
+                columns[axis][slot] |= 1;
+            }
+        }
+    }
+
+    // Visible faces of one direction, as rows of u bits: planes[slice][v]
+    std::array<std::array<uint32_t, SIZE>, SIZE> planes{};
+
+    for (size_t side = 0; side < ALL_DIRECTIONS.size(); side++) {
+        const FaceDirection direction = ALL_DIRECTIONS.at(side);
+        const FaceAxes axes = getFaceAxes(direction);
+        const auto& axisColumns = columns.at(static_cast<size_t>(axes.normalAxis));
+        const int normalStride = STRIDES.at(axes.normalAxis);
+        const int uStride = STRIDES.at(axes.uAxis);
+        const int vStride = STRIDES.at(axes.vAxis);
+
+        // --- Face culling, a whole column per step ---
+        // A voxel shows a face when it is solid and the next one along the normal is not
+        planes = {};
+        for (int v = 0; v < SIZE; v++) {
+            for (int u = 0; u < SIZE; u++) {
+                const uint64_t column = axisColumns[static_cast<size_t>(u + (v * SIZE))];
+                uint64_t faces = axes.normalSign > 0 ? column & ~(column >> 1)
+                                                     : column & ~(column << 1);
+                faces = (faces >> 1) & 0xFFFFFFFFU; // Drop the border bits
+
+                while (faces != 0) {
+                    const int slice = std::countr_zero(faces);
+                    planes[static_cast<size_t>(slice)][static_cast<size_t>(v)] |= 1U << u;
+                    faces &= faces - 1;
                 }
+            }
+        }
+
+        // --- Greedy merge, same scan order as generateGreedy ---
+        for (int slice = 0; slice < SIZE; slice++) {
+            auto& rows = planes[static_cast<size_t>(slice)];
+            auto blockAt = [&](int u, int v) {
+                return input.getBlock(
+                    static_cast<size_t>((slice * normalStride) + (u * uStride) + (v * vStride)));
+            };
+
+            for (int v = 0; v < SIZE; v++) {
+                while (rows[static_cast<size_t>(v)] != 0) {
+                    const int u = std::countr_zero(rows[static_cast<size_t>(v)]);
+                    const uint8_t blockId = blockAt(u, v);
+                    if (!displayable[blockId]) {
+                        rows[static_cast<size_t>(v)] &= ~(1U << u);
+                        continue;
+                    }
+
+                    // Longest run of set bits from u, cut at the first different block
+                    const auto row = static_cast<uint64_t>(rows[static_cast<size_t>(v)]);
+                    const int run = std::countr_zero(~(row >> u));
+                    int width = 1;
+                    while (width < run && blockAt(u + width, v) == blockId) {
+                        width++;
+                    }
+                    const auto widthMask =
+                        static_cast<uint32_t>(((uint64_t{1} << width) - 1) << u);
 
-                // Bottom (-Y)
-                bool isBottomSolid =
-                    (y == 0) ? (neighborBottom != nullptr &&
-                                neighborBottom->isBlockSolid(x, Chunk::CHUNK_SIZE - 1, z))
-                             : mainChunk.isBlockSolid(x, y - 1, z);
-                if (!isBottomSolid) {
-                    addFace(FaceDirection::Bottom, x, y, z, blockId, vertices, indices);
+                    int height = 1;
+                    while (v + height < SIZE) {
+                        if ((rows[static_cast<size_t>(v + height)] & widthMask) != widthMask) {
+                            break;
+                        }
+                        bool sameBlock = true;
+                        for (int k = 0; k < width && sameBlock; k++) {
+                            sameBlock = blockAt(u + k, v + height) == blockId;
+                        }
+                        if (!sameBlock) {
+                            break;
+                        }
+                        height++;
+                    }
+
+                    for (int dv = 0; dv < height; dv++) {
+                        rows[static_cast<size_t>(v + dv)] &= ~widthMask;
+                    }
+
+                    std::array<int, 3> origin{};
+                    origin.at(static_cast<size_t>(axes.normalAxis)) = slice;
+                    origin.at(static_cast<size_t>(axes.uAxis)) = u;
+                    origin.at(static_cast<size_t>(axes.vAxis)) = v;
+                    addQuad(direction, origin[0], origin[1], origin[2], width, height, blockId,
+                            quads);
                 }
             }
         }
     }
-
-    // Mesh generation complete
 }
 
 void ChunkMesh::addFace(FaceDirection direction, int x, int y, int z, int blockId,
-                        std::vector<VoxelVertex>& vertices, std::vector<uint32_t>& indices) {
-    // For now, use blockId as textureId. Later this will be a lookup.
-    uint32_t textureId = static_cast<uint32_t>(blockId);
-
-    // Get the base index for the new vertices
-    auto baseIndex = static_cast<uint32_t>(vertices.size());
+                        std::vector<VoxelQuad>& quads) {
+    addQuad(direction, x, y, z, 1, 1, blockId, quads);
+}
 
-    uint32_t px = static_cast<uint32_t>(x);
-    uint32_t py = static_cast<uint32_t>(y);
-    uint32_t pz = static_cast<uint32_t>(z);
+void ChunkMesh::addQuad(FaceDirection direction, int x, int y, int z, int width, int height,
+                        int blockId, std::vector<VoxelQuad>& quads) {
+    // For now, use blockId as textureId. Later this will be a lookup.
+    auto textureId = static_cast<uint32_t>(blockId);
 
+    // Normal IDs follow ALL_DIRECTIONS. The corners are built by voxel.vert, which
+    // must stay in sync with getFaceAxes for the width and height axes.
     uint32_t normalId = 0;
-    uint32_t v0 = 0;
-    uint32_t v1 = 0;
-    uint32_t v2 = 0;
-    uint32_t v3 = 0;
-
-    // Define the 4 vertices of the quad based on face direction
-    // All vertex definitions are consistently Counter-Clockwise when viewed from outside.
     switch (direction) {
-    case FaceDirection::East: // +X
+    case FaceDirection::East: // +X, width along Z, height along Y
         normalId = 0;
-        v0 = packVertex(px + 1, py, pz, normalId, 0, textureId);         // Bottom-left
-        v1 = packVertex(px + 1, py, pz + 1, normalId, 1, textureId);     // Bottom-right
-        v2 = packVertex(px + 1, py + 1, pz + 1, normalId, 2, textureId); // Top-right
-        v3 = packVertex(px + 1, py + 1, pz, normalId, 3, textureId);     // Top-left
         break;
-    case FaceDirection::West: // -X
+    case FaceDirection::West: // -X, width along Z, height along Y
         normalId = 1;
-        v0 = packVertex(px, py, pz + 1, normalId, 0, textureId);
-        v1 = packVertex(px, py, pz, normalId, 1, textureId);
-        v2 = packVertex(px, py + 1, pz, normalId, 2, textureId);
-        v3 = packVertex(px, py + 1, pz + 1, normalId, 3, textureId);
         break;
-    case FaceDirection::Top: // +Y
+    case FaceDirection::Top: // +Y, width along X, height along Z
         normalId = 2;
-        v0 = packVertex(px, py + 1, pz, normalId, 0, textureId);
-        v1 = packVertex(px + 1, py + 1, pz, normalId, 1, textureId);
-        v2 = packVertex(px + 1, py + 1, pz + 1, normalId, 2, textureId);
-        v3 = packVertex(px, py + 1, pz + 1, normalId, 3, textureId);
         break;
-    case FaceDirection::Bottom: // -Y
+    case FaceDirection::Bottom: // -Y, width along X, height along Z
         normalId = 3;
-        v0 = packVertex(px, py, pz + 1, normalId, 0, textureId);
-        v1 = packVertex(px + 1, py, pz + 1, normalId, 1, textureId);
-        v2 = packVertex(px + 1, py, pz, normalId, 2, textureId);
-        v3 = packVertex(px, py, pz, normalId, 3, textureId);
         break;
-    case FaceDirection::North: // +Z
+    case FaceDirection::North: // +Z, width along X, height along Y
         normalId = 4;
-        v0 = packVertex(px + 1, py, pz + 1, normalId, 0, textureId);
-        v1 = packVertex(px, py, pz + 1, normalId, 1, textureId);
-        v2 = packVertex(px, py + 1, pz + 1, normalId, 2, textureId);
-        v3 = packVertex(px + 1, py + 1, pz + 1, normalId, 3, textureId);
         break;
-    case FaceDirection::South: // -Z
+    case FaceDirection::South: // -Z, width along X, height along Y
         normalId = 5;
-        v0 = packVertex(px, py, pz, normalId, 0, textureId);
-        v1 = packVertex(px + 1, py, pz, normalId, 1, textureId);
-        v2 = packVertex(px + 1, py + 1, pz, normalId, 2, textureId);
-        v3 = packVertex(px, py + 1, pz, normalId, 3, textureId);
         break;
     }
 
-    // Should never reach here, all enum values are covered
-    if (normalId == 0 && v0 == 0) {
-        return; // Defensive programming
-    }
-
-    vertices.push_back(v0);
-    vertices.push_back(v1);
-    vertices.push_back(v2);
-    vertices.push_back(v3);
-
-    // Add indices with reversed winding for CCW from outside
-    indices.push_back(baseIndex + 0);
-    indices.push_back(baseIndex + 2);
-    indices.push_back(baseIndex + 1);
-
-    // Triangle 2: v0, v3, v2
-    indices.push_back(baseIndex + 0);
-    indices.push_back(baseIndex + 3);
-    indices.push_back(baseIndex + 2);
+    quads.push_back(packQuad(static_cast<uint32_t>(x), static_cast<uint32_t>(y),
+                             static_cast<uint32_t>(z), normalId, static_cast<uint32_t>(width),
+                             static_cast<uint32_t>(height), textureId));
 }
@@ -1,15 +1,24 @@
 #pragma once
 
+#include <array>
+#include <span>
 #include <vector>
 
 #include <glm/glm.hpp>
 
 #include "BlockRegistry.hpp"
 #include "Chunk.hpp"
+#include "ChunkSnapshot.hpp"
 #include "common/Types/RenderTypes.hpp"
 
 class ChunkMesh {
   public:
+    // PerFace: one quad per exposed voxel face (reference mesher)
+    // Greedy: coplanar faces of the same block are merged into larger rectangles
+    // Binary: same output as Greedy, but faces are culled 32 voxels at a time with
+    //         per-column occupancy bitmasks and merged with bit scans
+    enum class MeshingMode { PerFace, Greedy, Binary };
+
     ChunkMesh() = default;
     ~ChunkMesh() = default;
 
@@ -18,21 +27,60 @@ class ChunkMesh {
     ChunkMesh(ChunkMesh&&) = default;
     ChunkMesh& operator=(ChunkMesh&&) = default;
 
-    // Generate mesh from chunk data with neighbor awareness
+    // Both overloads leave the quads grouped by face direction (see FaceQuadCounts)
+    // Generate mesh from chunk data with neighbor awareness (snapshots them first)
     static void generateMesh(const Chunk& mainChunk, const BlockRegistry& registry,
-                             std::vector<VoxelVertex>& vertices, std::vector<uint32_t>& indices,
+                             std::vector<VoxelQuad>& quads,
                              const Chunk* neighborNorth, // +Z
                              const Chunk* neighborSouth, // -Z
                              const Chunk* neighborEast,  // +X
                              const Chunk* neighborWest,  // -X
                              const Chunk* neighborTop,   // +Y
-                             const Chunk* neighborBottom // -Y
-    );
+                             const Chunk* neighborBottom, // -Y
+                             MeshingMode mode = MeshingMode::PerFace);
+    // Generate mesh from an immutable snapshot, safe to call from any thread
+    static void generateMesh(const ChunkSnapshot& snapshot, const BlockRegistry& registry,
+                             std::vector<VoxelQuad>& quads,
+                             MeshingMode mode = MeshingMode::PerFace);
+
+    static const char* getMeshingModeName(MeshingMode mode);
+
+    // Size of each direction range of a mesh from generateMesh
+    static FaceQuadCounts countFaceQuads(std::span<const VoxelQuad> quads);
 
   private:
     enum class FaceDirection { North, South, East, West, Top, Bottom };
 
+    // Also the order of ChunkSnapshot's border sides and of normal IDs
+    static constexpr std::array<FaceDirection, 6> ALL_DIRECTIONS = {
+        FaceDirection::East, FaceDirection::West,  FaceDirection::Top,
+        FaceDirection::Bottom, FaceDirection::North, FaceDirection::South};
+
+    // Axis indices (0 = X, 1 = Y, 2 = Z) of a face: its normal and the in-plane
+    // axes that addQuad's width (u) and height (v) extend along
+    struct FaceAxes {
+        int normalAxis = 0;
+        int uAxis = 0;
+        int vAxis = 0;
+        int normalSign = 0;
+    };
+    static FaceAxes getFaceAxes(FaceDirection direction);
+
+    static void generatePerFace(const ChunkSnapshot& snapshot, const BlockRegistry& registry,
+                                std::vector<VoxelQuad>& quads);
+    static void generateGreedy(const ChunkSnapshot& snapshot, const BlockRegistry& registry,
+                               std::vector<VoxelQuad>& quads);
+    static void generateBinary(const ChunkSnapshot& snapshot, const BlockRegistry& registry,
+                               std::vector<VoxelQuad>& quads);
+
+    // Stable reorder of the quads by normal ID. Greedy and Binary emit them in that
+    // order already (ALL_DIRECTIONS), PerFace interleaves them.
+    static void groupByDirection(std::vector<VoxelQuad>& quads);
+
     // Add a face to the mesh
     static void addFace(FaceDirection direction, int x, int y, int z, int blockId,
-                        std::vector<VoxelVertex>& vertices, std::vector<uint32_t>& indices);
+                        std::vector<VoxelQuad>& quads);
+    // Add a width x height rectangle of faces to the mesh (see getFaceAxes for the axes)
+    static void addQuad(FaceDirection direction, int x, int y, int z, int width, int height,
+                        int blockId, std::vector<VoxelQuad>& quads);
 };
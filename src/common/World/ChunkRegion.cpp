@@ -0,0 +1,165 @@
+#include "ChunkRegion.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+#include "ChunkInstanciator.hpp"
+
+namespace {
+constexpr int CHUNK_SIZE = Chunk::CHUNK_SIZE;
+// Cells of a member along each axis of the region grid
+constexpr int CELLS_PER_MEMBER = CHUNK_SIZE / ChunkRegion::SIZE;
+
+int floorDiv(int value, int divisor) {
+    int quotient = value / divisor;
+    return (value % divisor < 0) ? quotient - 1 : quotient;
+}
+
+size_t voxelIndex(int x, int y, int z) {
+    return static_cast<size_t>(x + (y * CHUNK_SIZE) + (z * CHUNK_SIZE * CHUNK_SIZE));
+}
+
+// Distance along one axis from the camera to the nearest member of a region
+int axisDistance(int camera, int first) {
+    const int last = first + ChunkRegion::SIZE - 1;
+    return std::max({first - camera, camera - last, 0});
+}
+} // namespace
+
+glm::ivec3 ChunkRegion::regionOf(const glm::ivec3& chunkPosition) {
+    return {floorDiv(chunkPosition.x, SIZE), floorDiv(chunkPosition.y, SIZE),
+            floorDiv(chunkPosition.z, SIZE)};
+}
+
+bool ChunkRegion::isMerged(const glm::ivec3& region, const glm::ivec3& cameraChunk) {
+    const glm::ivec3 first = firstChunkOf(region);
+    const int distance = std::max({axisDistance(cameraChunk.x, first.x),
+                                   axisDistance(cameraChunk.y, first.y),
+                                   axisDistance(cameraChunk.z, first.z)});
+    return distance > MERGE_DISTANCE;
+}
+
+int ChunkRegion::drawnLevel(const glm::ivec3& chunkPosition, const glm::ivec3& cameraChunk) {
+    if (isMerged(regionOf(chunkPosition), cameraChunk)) {
+        return LEVEL;
+    }
+    return ChunkLod::selectLevel(chunkPosition, cameraChunk);
+}
+
+RegionSnapshot::RegionSnapshot(const glm::ivec3& region, const ChunkInstanciator& world,
+                               const glm::ivec3& cameraChunk) {
+    const glm::ivec3 first = ChunkRegion::firstChunkOf(region);
+    for (int z = 0; z < ChunkRegion::SIZE; z++) {
+        for (int y = 0; y < ChunkRegion::SIZE; y++) {
+            for (int x = 0; x < ChunkRegion::SIZE; x++) {
+                const Chunk* chunk = world.findChunk(first + glm::ivec3(x, y, z));
+                if (chunk != nullptr && !chunk->isEmpty()) {
+                    _members.at(static_cast<size_t>(
+                        x + (y * ChunkRegion::SIZE) +
+                        (z * ChunkRegion::SIZE * ChunkRegion::SIZE))) = chunk->getStorage();
+                }
+            }
+        }
+    }
+
+    // The chunks just outside each face, one layer past the last member or before the
+    // first one
+    for (size_t side = 0; side < _neighbors.size(); side++) {
+        const int axis = static_cast<int>(side / 2);
+        const int layer = side % 2 == 0 ? ChunkRegion::SIZE : -1;
+        for (int v = 0; v < ChunkRegion::SIZE; v++) {
+            for (int u = 0; u < ChunkRegion::SIZE; u++) {
+                const glm::ivec3 position = first + ChunkLod::slicePosition(axis, layer, u, v);
+                Neighbor& neighbor =
+                    _neighbors.at(side).at(static_cast<size_t>(u + (v * ChunkRegion::SIZE)));
+                neighbor.level = ChunkRegion::drawnLevel(position, cameraChunk);
+                const Chunk* chunk = world.findChunk(position);
+                if (chunk != nullptr && !chunk->isEmpty()) {
+                    neighbor.blocks = chunk->getStorage();
+                }
+            }
+        }
+    }
+}
+
+ChunkSnapshot RegionSnapshot::resolve() const {
+    PalettedBlockStorage grid(Chunk::VOLUME, Chunk::AIR_BLOCK_ID);
+    auto blocks = std::make_unique<std::array<uint8_t, Chunk::VOLUME>>();
+
+    for (size_t member = 0; member < _members.size(); member++) {
+        if (!_members.at(member).has_value()) {
+            continue;
+        }
+        const auto index = static_cast<int>(member);
+        const glm::ivec3 origin = glm::ivec3(index % ChunkRegion::SIZE,
+                                             (index / ChunkRegion::SIZE) % ChunkRegion::SIZE,
+                                             index / (ChunkRegion::SIZE * ChunkRegion::SIZE)) *
+                                  CELLS_PER_MEMBER;
+
+        _members.at(member)->copyTo(*blocks);
+        ChunkLod::downsample(*blocks, ChunkRegion::LEVEL);
+        // Every voxel of a cell now holds its value, the first one stands for it
+        for (int z = 0; z < CELLS_PER_MEMBER; z++) {
+            for (int y = 0; y < CELLS_PER_MEMBER; y++) {
+                for (int x = 0; x < CELLS_PER_MEMBER; x++) {
+                    const uint8_t value = blocks->at(voxelIndex(x * ChunkRegion::SIZE,
+                                                                y * ChunkRegion::SIZE,
+                                                                z * ChunkRegion::SIZE));
+                    if (value != Chunk::AIR_BLOCK_ID) {
+                        grid.set(voxelIndex(origin.x + x, origin.y + y, origin.z + z), value);
+                    }
+                }
+            }
+        }
+    }
+    grid.compact();
+
+    std::array<std::bitset<ChunkSnapshot::FACE_AREA>, 6> borders;
+    for (size_t side = 0; side < borders.size(); side++) {
+        borders.at(side) = resolveBorder(side);
+    }
+    return {std::move(grid), borders};
+}
+
+std::bitset<ChunkSnapshot::FACE_AREA> RegionSnapshot::resolveBorder(size_t side) const {
+    // The neighbour's layer touching the region: its first on the positive side
+    const int axis = static_cast<int>(side / 2);
+    const int layer = side % 2 == 0 ? 0 : CHUNK_SIZE - 1;
+    const int cell = ChunkRegion::SIZE;
+
+    std::bitset<ChunkSnapshot::FACE_AREA> border;
+    for (int cv = 0; cv < ChunkRegion::SIZE; cv++) {
+        for (int cu = 0; cu < ChunkRegion::SIZE; cu++) {
+            const Neighbor& neighbor =
+                _neighbors.at(side).at(static_cast<size_t>(cu + (cv * ChunkRegion::SIZE)));
+            if (!neighbor.blocks.has_value()) {
+                continue;
+            }
+            // Per voxel, at the level the neighbour is drawn at. A neighbour drawn finer
+            // than the region may show air inside a cell the region would call solid:
+            // only cells it covers completely hide the region's face.
+            const std::bitset<ChunkSnapshot::FACE_AREA> slice =
+                ChunkLod::sliceSolidity(*neighbor.blocks, neighbor.level, axis, layer);
+            for (int sv = 0; sv < CELLS_PER_MEMBER; sv++) {
+                for (int su = 0; su < CELLS_PER_MEMBER; su++) {
+                    bool covered = true;
+                    for (int v = sv * cell; covered && v < (sv + 1) * cell; v++) {
+                        for (int u = su * cell; u < (su + 1) * cell; u++) {
+                            if (!slice.test(static_cast<size_t>(u + (v * CHUNK_SIZE)))) {
+                                covered = false;
+                                break;
+                            }
+                        }
+                    }
+                    if (covered) {
+                        border.set(static_cast<size_t>((cu * CELLS_PER_MEMBER) + su +
+                                                       (((cv * CELLS_PER_MEMBER) + sv) *
+                                                        CHUNK_SIZE)));
+                    }
+                }
+            }
+        }
+    }
+    return border;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <optional>
+
+#include <glm/glm.hpp>
+
+#include "Chunk.hpp"
+#include "ChunkLod.hpp"
+#include "ChunkSnapshot.hpp"
+#include "PalettedBlockStorage.hpp"
+
+class ChunkInstanciator;
+
+// Far away, SIZE^3 chunks are merged into a single region mesh: one draw and one
+// culling candidate instead of 64. The region is downsampled to LEVEL, whose cells
+// are SIZE voxels wide, so it fits the 32^3 grid the meshers expect and is drawn
+// scaled by SIZE.
+class ChunkRegion {
+  public:
+    static constexpr int SIZE = 4; // Chunks per axis
+    static constexpr int MEMBER_COUNT = SIZE * SIZE * SIZE;
+    static constexpr int LEVEL = 2;
+    static_assert(ChunkLod::getCellSize(LEVEL) == SIZE && LEVEL == ChunkLod::MAX_LEVEL);
+    // A region is merged once all of its members lie beyond this distance (in chunks),
+    // i.e. past the last ring meshed at a finer level than LEVEL
+    static constexpr int MERGE_DISTANCE = ChunkLod::LEVEL_DISTANCES.at(LEVEL - 1);
+
+    [[nodiscard]] static glm::ivec3 regionOf(const glm::ivec3& chunkPosition);
+    [[nodiscard]] static glm::ivec3 firstChunkOf(const glm::ivec3& region) {
+        return region * SIZE;
+    }
+    [[nodiscard]] static bool isMerged(const glm::ivec3& region, const glm::ivec3& cameraChunk);
+    // ChunkLod level the chunk is drawn at: LEVEL inside a merged region, its own
+    // ring's level otherwise. Neighbours take their borders at this level.
+    [[nodiscard]] static int drawnLevel(const glm::ivec3& chunkPosition,
+                                        const glm::ivec3& cameraChunk);
+};
+
+// Copies of everything needed to mesh one merged region: the blocks of its members and
+// of the chunks touching it, each with the level it is drawn at. Taken on the thread
+// that owns the chunks (cheap: the palette storages are copied as is); the expensive
+// downsampling happens in resolve(), on any thread.
+class RegionSnapshot {
+  public:
+    RegionSnapshot(const glm::ivec3& region, const ChunkInstanciator& world,
+                   const glm::ivec3& cameraChunk);
+    ~RegionSnapshot() = default;
+
+    RegionSnapshot(const RegionSnapshot&) = delete;
+    RegionSnapshot& operator=(const RegionSnapshot&) = delete;
+    RegionSnapshot(RegionSnapshot&&) = default;
+    RegionSnapshot& operator=(RegionSnapshot&&) = default;
+
+    // The region as one 32^3 grid of cells, ready for ChunkMesh
+    [[nodiscard]] ChunkSnapshot resolve() const;
+
+  private:
+    static constexpr int FACE_CHUNKS = ChunkRegion::SIZE * ChunkRegion::SIZE;
+
+    struct Neighbor {
+        std::optional<PalettedBlockStorage> blocks; // Empty when not loaded (air)
+        int level = 0;
+    };
+
+    // A border slot is only solid when every voxel the neighbour shows behind it is
+    std::bitset<ChunkSnapshot::FACE_AREA> resolveBorder(size_t side) const;
+
+    // Member (x, y, z) at x + y * SIZE + z * SIZE * SIZE, empty when not loaded
+    std::array<std::optional<PalettedBlockStorage>, ChunkRegion::MEMBER_COUNT> _members;
+    // Per BorderSide, the chunks touching that face, at u + v * SIZE in its face axes
+    std::array<std::array<Neighbor, FACE_CHUNKS>, 6> _neighbors;
+};
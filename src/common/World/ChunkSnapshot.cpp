@@ -0,0 +1,61 @@
+#include "ChunkSnapshot.hpp"
+
+#include <utility>
+
+#include "ChunkLod.hpp"
+
+namespace {
+bool isNeighborSolid(const Chunk* neighbor, int x, int y, int z) {
+    return neighbor != nullptr && neighbor->isBlockSolid(x, y, z);
+}
+} // namespace
+
+ChunkSnapshot::ChunkSnapshot(const Chunk& chunk, const Chunk* neighborNorth,
+                             const Chunk* neighborSouth, const Chunk* neighborEast,
+                             const Chunk* neighborWest, const Chunk* neighborTop,
+                             const Chunk* neighborBottom)
+    : _blocks(chunk.getStorage()), _isEmpty(chunk.isEmpty()) {
+    if (_isEmpty) {
+        return; // Nothing will be meshed, borders are never read
+    }
+
+    constexpr int LAST = SIZE - 1;
+    for (int v = 0; v < SIZE; v++) {
+        for (int u = 0; u < SIZE; u++) {
+            const auto slot = static_cast<size_t>(u + (v * SIZE));
+            _borders[EAST][slot] = isNeighborSolid(neighborEast, 0, v, u);
+            _borders[WEST][slot] = isNeighborSolid(neighborWest, LAST, v, u);
+            _borders[TOP][slot] = isNeighborSolid(neighborTop, u, 0, v);
+            _borders[BOTTOM][slot] = isNeighborSolid(neighborBottom, u, LAST, v);
+            _borders[NORTH][slot] = isNeighborSolid(neighborNorth, u, v, 0);
+            _borders[SOUTH][slot] = isNeighborSolid(neighborSouth, u, v, LAST);
+        }
+    }
+}
+
+ChunkSnapshot::ChunkSnapshot(const Chunk& chunk, int level,
+                             const std::array<const Chunk*, 6>& neighbors,
+                             const std::array<int, 6>& neighborLevels)
+    : _blocks(chunk.getStorage()), _isEmpty(chunk.isEmpty()), _level(level) {
+    if (_isEmpty) {
+        return;
+    }
+
+    // The slice touching this chunk: the near layer of a positive neighbour, the far one
+    // of a negative neighbour
+    constexpr int LAST = SIZE - 1;
+    for (size_t side = 0; side < neighbors.size(); side++) {
+        const Chunk* neighbor = neighbors.at(side);
+        if (neighbor != nullptr) {
+            _borders.at(side) = ChunkLod::sliceSolidity(neighbor->getStorage(),
+                                                        neighborLevels.at(side),
+                                                        static_cast<int>(side / 2),
+                                                        side % 2 == 0 ? 0 : LAST);
+        }
+    }
+}
+
+ChunkSnapshot::ChunkSnapshot(PalettedBlockStorage blocks,
+                             const std::array<std::bitset<FACE_AREA>, 6>& borders)
+    : _blocks(std::move(blocks)), _borders(borders),
+      _isEmpty(_blocks.isUniform() && _blocks.get(0) == Chunk::AIR_BLOCK_ID) {}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+
+#include "Chunk.hpp"
+#include "PalettedBlockStorage.hpp"
+
+// Immutable copy of everything needed to mesh one chunk: its (still compressed)
+// blocks plus the solidity of the six neighbour slices touching it.
+// Taken on the thread that owns the chunks, then safe to read from any thread
+// while the live chunks keep being edited.
+class ChunkSnapshot {
+  public:
+    static constexpr int SIZE = Chunk::CHUNK_SIZE;
+    static constexpr size_t FACE_AREA = static_cast<size_t>(SIZE) * SIZE;
+
+    // Same order as ChunkMesh's face directions and Chunk::Border
+    enum BorderSide : uint8_t { EAST, WEST, TOP, BOTTOM, NORTH, SOUTH };
+    static_assert(static_cast<int>(SOUTH) == static_cast<int>(Chunk::BORDER_SOUTH));
+
+    // Missing neighbours (nullptr) count as air
+    ChunkSnapshot(const Chunk& chunk, const Chunk* neighborNorth, const Chunk* neighborSouth,
+                  const Chunk* neighborEast, const Chunk* neighborWest, const Chunk* neighborTop,
+                  const Chunk* neighborBottom);
+    // Snapshot for a mesh at a ChunkLod level. The blocks are downsampled by the mesher
+    // (off this thread); each border is taken at the level its neighbour is meshed at,
+    // so both sides of a level transition agree on which faces exist and leave no crack.
+    // Neighbours and their levels are in BorderSide order.
+    ChunkSnapshot(const Chunk& chunk, int level, const std::array<const Chunk*, 6>& neighbors,
+                  const std::array<int, 6>& neighborLevels);
+    // Already downsampled blocks of a 32^3 mesh grid (e.g. a merged region), borders in
+    // BorderSide order
+    ChunkSnapshot(PalettedBlockStorage blocks,
+                  const std::array<std::bitset<FACE_AREA>, 6>& borders);
+    ~ChunkSnapshot() = default;
+
+    ChunkSnapshot(const ChunkSnapshot&) = default;
+    ChunkSnapshot& operator=(const ChunkSnapshot&) = default;
+    ChunkSnapshot(ChunkSnapshot&&) = default;
+    ChunkSnapshot& operator=(ChunkSnapshot&&) = default;
+
+    [[nodiscard]] const PalettedBlockStorage& getBlocks() const { return _blocks; }
+    [[nodiscard]] bool isEmpty() const { return _isEmpty; }
+    // ChunkLod level getBlocks() is to be downsampled to before meshing
+    [[nodiscard]] int getLevel() const { return _level; }
+
+    // Each border is indexed u + v * SIZE in the face axes of its side:
+    // X sides (z, y), Y sides (x, z), Z sides (x, y)
+    [[nodiscard]] bool isBorderSolid(size_t side, size_t slot) const {
+        return _borders[side][slot];
+    }
+
+  private:
+    PalettedBlockStorage _blocks;
+    std::array<std::bitset<FACE_AREA>, 6> _borders;
+    bool _isEmpty = true;
+    int _level = 0;
+};
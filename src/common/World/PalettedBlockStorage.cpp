@@ -0,0 +1,198 @@
+#include "PalettedBlockStorage.hpp"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+PalettedBlockStorage::PalettedBlockStorage(size_t size, uint8_t fillValue) : _size(size) {
+    fill(fillValue);
+}
+
+uint8_t PalettedBlockStorage::bitsForPaletteSize(size_t paletteSize) {
+    if (paletteSize <= 1) {
+        return 0;
+    }
+    if (paletteSize <= 2) {
+        return 1;
+    }
+    if (paletteSize <= 4) {
+        return 2;
+    }
+    if (paletteSize <= 16) {
+        return 4;
+    }
+    return 8;
+}
+
+uint32_t PalettedBlockStorage::readIndex(size_t index) const {
+    if (_bitsPerIndex == 0) {
+        return 0;
+    }
+    const size_t bitOffset = index * _bitsPerIndex;
+    return static_cast<uint32_t>((_data[bitOffset >> 6] >> (bitOffset & 63)) & _indexMask);
+}
+
+void PalettedBlockStorage::writeIndex(size_t index, uint32_t paletteIndex) {
+    const size_t bitOffset = index * _bitsPerIndex;
+    uint64_t& word = _data[bitOffset >> 6];
+    const uint64_t shift = bitOffset & 63;
+    word = (word & ~(_indexMask << shift)) | (static_cast<uint64_t>(paletteIndex) << shift);
+}
+
+void PalettedBlockStorage::repack(uint8_t newBitsPerIndex) {
+    PalettedBlockStorage old(*this);
+
+    _bitsPerIndex = newBitsPerIndex;
+    _indexMask = (newBitsPerIndex == 0) ? 0 : ((uint64_t{1} << newBitsPerIndex) - 1);
+    _data.assign(((_size * newBitsPerIndex) + 63) / 64, 0);
+    _data.shrink_to_fit();
+
+    if (newBitsPerIndex == 0) {
+        return;
+    }
+    for (size_t i = 0; i < _size; i++) {
+        writeIndex(i, old.readIndex(i));
+    }
+}
+
+void PalettedBlockStorage::set(size_t index, uint8_t value) {
+    if (_bitsPerIndex == 0 && _palette[0] == value) {
+        return; // Uniform fast path, nothing changes
+    }
+
+    auto it = std::find(_palette.begin(), _palette.end(), value);
+    auto paletteIndex = static_cast<uint32_t>(it - _palette.begin());
+    if (it == _palette.end()) {
+        _palette.push_back(value);
+        uint8_t neededBits = bitsForPaletteSize(_palette.size());
+        if (neededBits > _bitsPerIndex) {
+            repack(neededBits);
+        }
+    }
+    writeIndex(index, paletteIndex);
+}
+
+void PalettedBlockStorage::fill(uint8_t value) {
+    _palette.assign(1, value);
+    _bitsPerIndex = 0;
+    _indexMask = 0;
+    _data.clear();
+    _data.shrink_to_fit();
+}
+
+void PalettedBlockStorage::compact() {
+    if (_bitsPerIndex == 0) {
+        return;
+    }
+
+    std::array<bool, 256> used{};
+    for (size_t i = 0; i < _size; i++) {
+        used.at(readIndex(i)) = true;
+    }
+
+    // Build the new palette, keeping the original order of surviving entries
+    std::array<uint32_t, 256> remap{};
+    std::vector<uint8_t> newPalette;
+    for (size_t i = 0; i < _palette.size(); i++) {
+        if (used.at(i)) {
+            remap.at(i) = static_cast<uint32_t>(newPalette.size());
+            newPalette.push_back(_palette[i]);
+        }
+    }
+
+    if (newPalette.size() == _palette.size() &&
+        bitsForPaletteSize(newPalette.size()) == _bitsPerIndex) {
+        return; // Already minimal
+    }
+
+    PalettedBlockStorage old(*this);
+    _palette = std::move(newPalette);
+    _palette.shrink_to_fit();
+    _bitsPerIndex = bitsForPaletteSize(_palette.size());
+    _indexMask = (_bitsPerIndex == 0) ? 0 : ((uint64_t{1} << _bitsPerIndex) - 1);
+    _data.assign(((_size * _bitsPerIndex) + 63) / 64, 0);
+    _data.shrink_to_fit();
+
+    if (_bitsPerIndex == 0) {
+        return;
+    }
+    for (size_t i = 0; i < _size; i++) {
+        writeIndex(i, remap.at(old.readIndex(i)));
+    }
+}
+
+void PalettedBlockStorage::copyTo(std::span<uint8_t> out) const {
+    if (out.size() != _size) {
+        throw std::runtime_error("PalettedBlockStorage::copyTo: size mismatch");
+    }
+    if (_bitsPerIndex == 0) {
+        std::fill(out.begin(), out.end(), _palette[0]);
+        return;
+    }
+
+    switch (_bitsPerIndex) {
+    case 1:
+        decodeWords<1>(out);
+        break;
+    case 2:
+        decodeWords<2>(out);
+        break;
+    case 4:
+        decodeWords<4>(out);
+        break;
+    default:
+        decodeWords<8>(out);
+        break;
+    }
+}
+
+void PalettedBlockStorage::assign(std::span<const uint8_t> values) {
+    if (values.size() != _size) {
+        throw std::runtime_error("PalettedBlockStorage::assign: size mismatch");
+    }
+    // Palette in order of first appearance, like repeated set() calls would build it
+    std::array<int, 256> paletteIndex{};
+    paletteIndex.fill(-1);
+    _palette.clear();
+    for (uint8_t value : values) {
+        if (paletteIndex.at(value) < 0) {
+            paletteIndex.at(value) = static_cast<int>(_palette.size());
+            _palette.push_back(value);
+        }
+    }
+    if (_palette.empty()) {
+        _palette.push_back(0);
+    }
+    _palette.shrink_to_fit();
+    _bitsPerIndex = bitsForPaletteSize(_palette.size());
+    _indexMask = (_bitsPerIndex == 0) ? 0 : ((uint64_t{1} << _bitsPerIndex) - 1);
+    _data.assign(((_size * _bitsPerIndex) + 63) / 64, 0);
+    _data.shrink_to_fit();
+
+    if (_bitsPerIndex == 0) {
+        return;
+    }
+    for (size_t i = 0; i < _size; i++) {
+        writeIndex(i, static_cast<uint32_t>(paletteIndex.at(values[i])));
+    }
+}
+
+template <uint8_t Bits> void PalettedBlockStorage::decodeWords(std::span<uint8_t> out) const {
+    // Decode a whole word at a time; a compile-time width lets the inner loop unroll
+    constexpr size_t INDICES_PER_WORD = 64 / Bits;
+    constexpr uint64_t MASK = (uint64_t{1} << Bits) - 1;
+    size_t outIndex = 0;
+    for (uint64_t word : _data) {
+        if (_size - outIndex >= INDICES_PER_WORD) {
+            for (size_t i = 0; i < INDICES_PER_WORD; i++) {
+                out[outIndex + i] = _palette[(word >> (i * Bits)) & MASK];
+            }
+            outIndex += INDICES_PER_WORD;
+            continue;
+        }
+        for (; outIndex < _size; outIndex++) {
+            out[outIndex] = _palette[word & MASK];
+            word >>= Bits;
+        }
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Compressed block-ID array.
+// Each voxel stores an index into a small palette of block IDs, packed with
+// 1/2/4/8 bits per index depending on how many distinct blocks are present.
+// A palette of a single entry uses 0 bits: uniform volumes (all air, all stone)
+// cost a handful of bytes and need no index array at all.
+// Indices never straddle a 64-bit word since bit widths are powers of two.
+class PalettedBlockStorage {
+  public:
+    explicit PalettedBlockStorage(size_t size = 0, uint8_t fillValue = 0);
+    ~PalettedBlockStorage() = default;
+
+    PalettedBlockStorage(const PalettedBlockStorage&) = default;
+    PalettedBlockStorage& operator=(const PalettedBlockStorage&) = default;
+    PalettedBlockStorage(PalettedBlockStorage&&) = default;
+    PalettedBlockStorage& operator=(PalettedBlockStorage&&) = default;
+
+    [[nodiscard]] uint8_t get(size_t index) const {
+        if (_bitsPerIndex == 0) {
+            return _palette[0];
+        }
+        const size_t bitOffset = index * _bitsPerIndex;
+        const uint64_t word = _data[bitOffset >> 6];
+        return _palette[(word >> (bitOffset & 63)) & _indexMask];
+    }
+    void set(size_t index, uint8_t value);
+
+    // Resets every voxel to a single value and releases the index array
+    void fill(uint8_t value);
+    // Drops unused palette entries and shrinks to the smallest bit width that fits
+    void compact();
+    // Decodes every voxel into a flat array (out.size() must equal size())
+    void copyTo(std::span<uint8_t> out) const;
+    // Replaces every voxel from a flat array (values.size() must equal size()), packed
+    // straight at the smallest bit width that fits
+    void assign(std::span<const uint8_t> values);
+
+    [[nodiscard]] size_t size() const { return _size; }
+    [[nodiscard]] bool isUniform() const { return _bitsPerIndex == 0; }
+    [[nodiscard]] uint8_t getBitsPerIndex() const { return _bitsPerIndex; }
+    [[nodiscard]] size_t getPaletteSize() const { return _palette.size(); }
+    [[nodiscard]] size_t getHeapUsage() const {
+        return _palette.capacity() + (_data.capacity() * sizeof(uint64_t));
+    }
+
+  private:
+    [[nodiscard]] uint32_t readIndex(size_t index) const;
+    void writeIndex(size_t index, uint32_t paletteIndex);
+    void repack(uint8_t newBitsPerIndex);
+    template <uint8_t Bits> void decodeWords(std::span<uint8_t> out) const;
+
+    static uint8_t bitsForPaletteSize(size_t paletteSize);
+
+    size_t _size = 0;
+    uint8_t _bitsPerIndex = 0;
+    uint64_t _indexMask = 0;
+    std::vector<uint8_t> _palette;
+    std::vector<uint64_t> _data;
+};
@@ -0,0 +1,362 @@
+#include "TerrainGenerator.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "Chunk.hpp"
+#include "common/Util/perlinNoise.hpp"
+
+namespace {
+constexpr int SIZE = Chunk::CHUNK_SIZE;
+constexpr size_t FOOTPRINT = static_cast<size_t>(SIZE) * SIZE;
+
+// Heights every surface stays within (see BiomeMap)
+constexpr int MAX_SURFACE_OFFSET =
+    TerrainGenerator::CONTINENT_RISE + TerrainGenerator::HEIGHT_AMPLITUDE;
+constexpr auto MIN_SURFACE =
+    static_cast<float>(TerrainGenerator::BASE_HEIGHT - MAX_SURFACE_OFFSET);
+constexpr auto MAX_SURFACE =
+    static_cast<float>(TerrainGenerator::BASE_HEIGHT + MAX_SURFACE_OFFSET);
+constexpr auto BAND = static_cast<float>(TerrainGenerator::SURFACE_BAND);
+
+constexpr int ROUGH_CELL_SIZE = 4;  // Mountains, hills and badlands
+constexpr int SMOOTH_CELL_SIZE = 8; // Flatter biomes
+static_assert(SIZE % SMOOTH_CELL_SIZE == 0 && SMOOTH_CELL_SIZE % ROUGH_CELL_SIZE == 0);
+
+// Block at the top of the ground, under air
+uint8_t surfaceBlock(Biome biome) {
+    switch (biome) {
+    case Biome::Mountains:
+    case Biome::Tundra:
+    case Biome::Badlands:
+        return TerrainGenerator::STONE_BLOCK_ID;
+    default:
+        return TerrainGenerator::GRASS_BLOCK_ID;
+    }
+}
+
+float densityAt(float surface, int worldY, float noise) {
+    return ((surface - static_cast<float>(worldY)) / BAND) + noise;
+}
+
+// Voxels from `minY` to `minY + SIZE` (one above the chunk, for the grass test) are all
+// solid below the surface's band and all air above it
+bool isBelowBand(int minY, float lowestSurface) {
+    return static_cast<float>(minY + SIZE) < lowestSurface - BAND;
+}
+
+bool isAboveBand(int minY, float highestSurface) {
+    return static_cast<float>(minY) >= highestSurface + BAND;
+}
+
+// Local heights [start, end) that can go either way for surfaces in [lowest, highest]:
+// solid below, air from end. Up to SIZE, the voxel above the chunk, for the grass test.
+std::pair<int, int> bandRange(int minY, float lowest, float highest) {
+    const int start =
+        std::clamp(static_cast<int>(std::floor(lowest - BAND)) - minY, 0, SIZE + 1);
+    const int end =
+        std::clamp(static_cast<int>(std::ceil(highest + BAND)) - minY + 1, start, SIZE + 1);
+    return {start, end};
+}
+
+float interpolate(float a0, float a1, float w) {
+    return a0 + (w * (a1 - a0));
+}
+
+// Weight of the point `offset` voxels into a lattice cell
+float cellWeight(int offset, int cellSize) {
+    return static_cast<float>(offset) / static_cast<float>(cellSize);
+}
+
+int floorDiv(int value, int divisor) {
+    int quotient = value / divisor;
+    return (value % divisor < 0) ? quotient - 1 : quotient;
+}
+
+using Row = std::array<float, SIZE>;        // One value per x
+using Solidity = std::array<uint8_t, SIZE>; // 1 where solid, per x
+using Blocks = std::array<uint8_t, SIZE>;   // One block id per x
+
+// Clamped 3D noise on the lattice points of one chunk: every point along x and z, the
+// layers along y that the chunk's band reaches. Each lattice row is expanded along x
+// once, then slabs and voxel rows are blends of whole rows, which vectorise.
+class DensityLattice {
+  public:
+    DensityLattice(int cellSize, int minY, std::pair<int, int> band)
+        : _cellSize(cellSize), _points(SIZE / cellSize + 1), _minY(minY),
+          _firstLayer(band.first / cellSize),
+          _layerCount(band.first < band.second
+                          ? ((band.second - 1 + cellSize - 1) / cellSize) - _firstLayer + 1
+                          : 0),
+          _rows(static_cast<size_t>(_points) * _layerCount) {
+        for (int offset = 0; offset < cellSize; offset++) {
+            _weights.at(offset) = cellWeight(offset, cellSize);
+        }
+    }
+
+    // noise(localX, worldY, localZ) at every lattice point
+    template <typename Noise> void sample(const Noise& noise) {
+        std::vector<float> points(static_cast<size_t>(_points));
+        for (int k = 0; k < _points; k++) {
+            for (int layer = 0; layer < _layerCount; layer++) {
+                const int worldY = _minY + ((_firstLayer + layer) * _cellSize);
+                for (int i = 0; i < _points; i++) {
+                    points[i] = noise(i * _cellSize, worldY, k * _cellSize);
+                }
+                Row& row = rowAt(k, _firstLayer + layer);
+                for (int x = 0; x < SIZE; x++) {
+                    const int i = x / _cellSize;
+                    const int offset = x % _cellSize;
+                    row[x] = offset == 0 ? points[i]
+                                         : interpolate(points[i], points[i + 1],
+                                                       _weights.at(offset));
+                }
+            }
+        }
+    }
+
+    [[nodiscard]] size_t sampleCount() const {
+        return static_cast<size_t>(_points) * _points * _layerCount;
+    }
+
+    // Rows of the layers covering local heights [start, end) at voxel depth z, into
+    // slab[layer]
+    void interpolateSlab(int z, int start, int end, std::span<Row> slab) const {
+        if (start >= end) {
+            return;
+        }
+        const int k = z / _cellSize;
+        const int offset = z % _cellSize;
+        const float weight = _weights.at(offset);
+        for (int layer = start / _cellSize; layer <= (end - 1 + _cellSize - 1) / _cellSize;
+             layer++) {
+            const Row& near = rowAt(k, layer);
+            if (offset == 0) {
+                slab[layer] = near;
+                continue;
+            }
+            const Row& far = rowAt(k + 1, layer);
+            for (int x = 0; x < SIZE; x++) {
+                slab[layer][x] = interpolate(near[x], far[x], weight);
+            }
+        }
+    }
+
+    // Noise of the voxel row at local height y, from a slab
+    void interpolateRow(int y, std::span<const Row> slab, Row& out) const {
+        const int layer = y / _cellSize;
+        const int offset = y % _cellSize;
+        if (offset == 0) {
+            out = slab[layer];
+            return;
+        }
+        const float weight = _weights.at(offset);
+        for (int x = 0; x < SIZE; x++) {
+            out[x] = interpolate(slab[layer][x], slab[layer + 1][x], weight);
+        }
+    }
+
+  private:
+    Row& rowAt(int k, int layer) {
+        return _rows.at((static_cast<size_t>(k) * _layerCount) + (layer - _firstLayer));
+    }
+    [[nodiscard]] const Row& rowAt(int k, int layer) const {
+        return _rows.at((static_cast<size_t>(k) * _layerCount) + (layer - _firstLayer));
+    }
+
+    int _cellSize;
+    int _points; // Per axis
+    int _minY;
+    int _firstLayer;
+    int _layerCount;
+    std::array<float, SIZE> _weights{};
+    std::vector<Row> _rows; // Expanded along x, by z point then layer
+};
+
+// Solidity of the voxel row at local height y of one z slice
+void rowSolidity(int y, int minY, std::pair<int, int> band, std::span<const float, SIZE> surfaces,
+                 const DensityLattice& lattice, std::span<const Row> slab, Row& noise,
+                 Solidity& solid) {
+    if (y < band.first || y >= band.second) {
+        solid.fill(y < band.first ? 1 : 0);
+        return;
+    }
+    lattice.interpolateRow(y, slab, noise);
+    const auto worldY = static_cast<float>(minY + y);
+    for (int x = 0; x < SIZE; x++) {
+        solid[x] = ((surfaces[x] - worldY) / BAND) + noise[x] > 0.0F ? 1 : 0;
+    }
+}
+
+// Solid voxels are their column's surface block under air and stone under solid
+void writeRow(std::span<uint8_t, SIZE> blocks, const Solidity& solid, const Solidity& above,
+              const Blocks& surfaceBlocks) {
+    for (int x = 0; x < SIZE; x++) {
+        const uint8_t topBlock =
+            above[x] != 0 ? TerrainGenerator::STONE_BLOCK_ID : surfaceBlocks[x];
+        blocks[x] = solid[x] != 0 ? topBlock : Chunk::AIR_BLOCK_ID;
+    }
+}
+} // namespace
+
+TerrainGenerator::TerrainGenerator(long int seed, int maxDensityCellSize)
+    : _seed(seed), _densitySeed(static_cast<long int>(static_cast<unsigned long>(seed) + 1U)),
+      _maxDensityCellSize(maxDensityCellSize), _biomes(seed) {
+    if (maxDensityCellSize < 1 || maxDensityCellSize > SIZE ||
+        (maxDensityCellSize & (maxDensityCellSize - 1)) != 0) {
+        throw std::runtime_error("TerrainGenerator: density cell size must be a power of two "
+                                 "up to the chunk size");
+    }
+}
+
+float TerrainGenerator::noise3D(int worldX, int worldY, int worldZ) const {
+    return std::clamp(perlinNoise3D(static_cast<float>(worldX), static_cast<float>(worldY),
+                                    static_cast<float>(worldZ), DENSITY_FREQUENCY, _densitySeed,
+                                    DENSITY_OCTAVES, PERSISTENCE),
+                      -1.0F, 1.0F);
+}
+
+int TerrainGenerator::getBiomeDensityCellSize(Biome biome) {
+    switch (biome) {
+    case Biome::Mountains:
+    case Biome::Hills:
+    case Biome::Badlands:
+        return ROUGH_CELL_SIZE;
+    default:
+        return SMOOTH_CELL_SIZE;
+    }
+}
+
+int TerrainGenerator::chunkCellSize(const BiomeMap::RegionLayers& layers,
+                                    const glm::ivec2& local) const {
+    int cellSize = _maxDensityCellSize;
+    for (int z = 0; z < SIZE; z++) {
+        const size_t first = BiomeMap::RegionLayers::indexOf(local.x, local.y + z);
+        for (int x = 0; x < SIZE; x++) {
+            cellSize = std::min(cellSize, getBiomeDensityCellSize(layers.biome[first + x]));
+        }
+    }
+    return cellSize;
+}
+
+float TerrainGenerator::density(int worldX, int worldY, int worldZ) const {
+    // The cell size of the voxel's chunk, from the biomes of its footprint
+    const int chunkX = floorDiv(worldX, SIZE);
+    const int chunkZ = floorDiv(worldZ, SIZE);
+    const glm::ivec2 region = BiomeMap::regionOf(chunkX, chunkZ);
+    const glm::ivec2 local =
+        (glm::ivec2(chunkX, chunkZ) * SIZE) - (region * BiomeMap::REGION_SIZE);
+    const int cell = chunkCellSize(*_biomes.getRegion(region), local);
+
+    // The lattice cell around the voxel, blended along x, then z, then y like generate()
+    const glm::ivec3 voxel(worldX, worldY, worldZ);
+    const glm::ivec3 base(floorDiv(worldX, cell) * cell, floorDiv(worldY, cell) * cell,
+                          floorDiv(worldZ, cell) * cell);
+    const glm::ivec3 offset = voxel - base;
+    const auto alongX = [&](int j, int k) {
+        const float near = noise3D(base.x, base.y + (j * cell), base.z + (k * cell));
+        if (offset.x == 0) {
+            return near;
+        }
+        const float far = noise3D(base.x + cell, base.y + (j * cell), base.z + (k * cell));
+        return interpolate(near, far, cellWeight(offset.x, cell));
+    };
+    const auto alongZ = [&](int j) {
+        return offset.z == 0
+                   ? alongX(j, 0)
+                   : interpolate(alongX(j, 0), alongX(j, 1), cellWeight(offset.z, cell));
+    };
+    const float noise = offset.y == 0
+                            ? alongZ(0)
+                            : interpolate(alongZ(0), alongZ(1), cellWeight(offset.y, cell));
+    return densityAt(_biomes.sampleColumn(worldX, worldZ).surface, worldY, noise);
+}
+
+std::unique_ptr<Chunk> TerrainGenerator::generate(const glm::ivec3& position) const {
+    auto chunk = std::make_unique<Chunk>(position.x, position.y, position.z);
+    _generatedChunks.fetch_add(1, std::memory_order_relaxed);
+    const int minY = position.y * SIZE;
+
+    // Outside the band of every possible surface: no noise at all
+    if (isAboveBand(minY, MAX_SURFACE)) {
+        _airChunks.fetch_add(1, std::memory_order_relaxed);
+        return chunk;
+    }
+    if (isBelowBand(minY, MIN_SURFACE)) {
+        chunk->fill(STONE_BLOCK_ID);
+        _solidChunks.fetch_add(1, std::memory_order_relaxed);
+        return chunk;
+    }
+
+    // Outside the band of this footprint's surfaces: only the (cached) heightmap
+    const glm::ivec3 origin = position * SIZE;
+    const glm::ivec2 region = BiomeMap::regionOf(position.x, position.z);
+    const std::shared_ptr<const BiomeMap::RegionLayers> layers = _biomes.getRegion(region);
+    const glm::ivec2 local = glm::ivec2(origin.x, origin.z) - (region * BiomeMap::REGION_SIZE);
+    std::array<float, FOOTPRINT> surfaces{};
+    for (int z = 0; z < SIZE; z++) {
+        const size_t first = BiomeMap::RegionLayers::indexOf(local.x, local.y + z);
+        std::copy_n(layers->surface.begin() + static_cast<ptrdiff_t>(first), SIZE,
+                    surfaces.begin() + static_cast<ptrdiff_t>(z * SIZE));
+    }
+    const auto [lowest, highest] = std::minmax_element(surfaces.begin(), surfaces.end());
+    if (isAboveBand(minY, *highest)) {
+        _airChunks.fetch_add(1, std::memory_order_relaxed);
+        return chunk;
+    }
+    if (isBelowBand(minY, *lowest)) {
+        chunk->fill(STONE_BLOCK_ID);
+        _solidChunks.fetch_add(1, std::memory_order_relaxed);
+        return chunk;
+    }
+
+    DensityLattice lattice(chunkCellSize(*layers, local), minY,
+                           bandRange(minY, *lowest, *highest));
+    lattice.sample([&](int x, int worldY, int z) {
+        return noise3D(origin.x + x, worldY, origin.z + z);
+    });
+    _densitySamples.fetch_add(lattice.sampleCount(), std::memory_order_relaxed);
+
+    // One z slice at a time, each only over its own columns' band
+    std::array<uint8_t, Chunk::VOLUME> blocks{};
+    std::array<Row, SIZE + 1> slab{}; // By lattice layer
+    Row noise{};
+    Solidity solid{};
+    Solidity above{};
+    Blocks surfaceBlocks{};
+    for (int z = 0; z < SIZE; z++) {
+        const auto sliceSurfaces = std::span<const float, SIZE>(
+            surfaces.begin() + static_cast<ptrdiff_t>(z * SIZE), SIZE);
+        const auto [sliceLowest, sliceHighest] =
+            std::minmax_element(sliceSurfaces.begin(), sliceSurfaces.end());
+        const std::pair<int, int> band = bandRange(minY, *sliceLowest, *sliceHighest);
+        lattice.interpolateSlab(z, band.first, band.second, slab);
+        const size_t firstColumn = BiomeMap::RegionLayers::indexOf(local.x, local.y + z);
+        for (int x = 0; x < SIZE; x++) {
+            surfaceBlocks[x] = surfaceBlock(layers->biome[firstColumn + x]);
+        }
+
+        // Top down, so each voxel knows whether the one above is solid
+        rowSolidity(SIZE, minY, band, sliceSurfaces, lattice, slab, noise, above);
+        for (int y = SIZE - 1; y >= 0; y--) {
+            rowSolidity(y, minY, band, sliceSurfaces, lattice, slab, noise, solid);
+            writeRow(std::span<uint8_t, SIZE>(blocks.begin() + chunk->getIndex(0, y, z), SIZE),
+                     solid, above, surfaceBlocks);
+            above = solid;
+        }
+    }
+    chunk->assignBlocks(blocks);
+    return chunk;
+}
+
+TerrainGenerator::GenerationStats TerrainGenerator::getStats() const {
+    return {.generatedChunks = _generatedChunks.load(std::memory_order_relaxed),
+            .airChunks = _airChunks.load(std::memory_order_relaxed),
+            .solidChunks = _solidChunks.load(std::memory_order_relaxed),
+            .densitySamples = _densitySamples.load(std::memory_order_relaxed)};
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include <glm/glm.hpp>
+
+#include "BiomeMap.hpp"
+
+class Chunk;
+
+// Fills chunks from a density function: the BiomeMap gives each column a surface height
+// and a biome, and 3D gradient noise pushes the ground in and out around the surface
+// (overhangs, arches, floating bits). A voxel is solid where
+//   density = (surfaceHeight - y) / SURFACE_BAND + clamp(noise3D, -1, 1) > 0,
+// so it is always solid more than SURFACE_BAND voxels below its column's surface and
+// always air more than SURFACE_BAND above. 3D noise is only evaluated inside that band:
+// chunks entirely above or below it are filled without any (first from the global
+// height range, then from their own footprint), and each row of a chunk only evaluates
+// the heights its columns' bands cover, so the cost follows the surface rather than the
+// volume. The surface heights come from the BiomeMap's region cache, so chunks stacked
+// in a column share one heightmap. The biome picks the block at the top of the ground,
+// grass or stone.
+// The 3D noise itself is only evaluated on a lattice of one point every cell size voxels
+// (aligned to world multiples of it) and trilinearly interpolated in between, a row of
+// voxels at a time. A cell size of 4 takes about 40x fewer noise samples than 1, which is
+// the exact per-voxel function. Each biome has its own cell size, finer where the relief
+// is rugged, and a chunk uses the smallest one among the biomes of its columns (capped by
+// maxDensityCellSize), so a chunk astride a border keeps the detail of its roughest side.
+// Chunks with different cell sizes share the lattice points every 8 voxels along their
+// common face and only differ in between by how each interpolates, a small step at most.
+// The interpolated noise stays in [-1, 1], so the band still bounds the surface.
+// Chunks stack vertically without limit. generate() is const and safe to call from
+// several threads at once, and a chunk depends only on the seed and its position: the
+// same on any thread, in any order, on any machine (the build turns off floating-point
+// contraction and the noise does not depend on libm rounding).
+class TerrainGenerator {
+  public:
+    static constexpr long int DEFAULT_SEED = 42;
+
+    static constexpr int BASE_HEIGHT = 48;      // Mean surface height
+    static constexpr int CONTINENT_RISE = 16;   // Height added at continentalness 1
+    static constexpr int HEIGHT_AMPLITUDE = 32; // Relief at continentalness 1
+    static constexpr int SURFACE_BAND = 12;     // Reach of the 3D noise around the surface
+
+    static constexpr float HEIGHT_FREQUENCY = 0.004F;
+    static constexpr int HEIGHT_OCTAVES = 5;
+    static constexpr float DENSITY_FREQUENCY = 0.03F;
+    static constexpr int DENSITY_OCTAVES = 3;
+    static constexpr int DEFAULT_MAX_DENSITY_CELL_SIZE = 8;
+    static constexpr float PERSISTENCE = 0.5F;
+
+    static constexpr uint8_t STONE_BLOCK_ID = 1;
+    static constexpr uint8_t GRASS_BLOCK_ID = 2;
+
+    struct GenerationStats {
+        size_t generatedChunks = 0;
+        size_t airChunks = 0;   // Above the band, skipped without any noise
+        size_t solidChunks = 0; // Below the band, skipped without any noise
+        size_t densitySamples = 0;
+    };
+
+    // maxDensityCellSize must be a power of two dividing Chunk::CHUNK_SIZE (throws
+    // otherwise). 1 gives the exact function everywhere.
+    explicit TerrainGenerator(long int seed = DEFAULT_SEED,
+                              int maxDensityCellSize = DEFAULT_MAX_DENSITY_CELL_SIZE);
+    ~TerrainGenerator() = default;
+
+    TerrainGenerator(const TerrainGenerator&) = delete;
+    TerrainGenerator& operator=(const TerrainGenerator&) = delete;
+    TerrainGenerator(TerrainGenerator&&) = delete;
+    TerrainGenerator& operator=(TerrainGenerator&&) = delete;
+
+    // Builds the chunk at chunk coordinates `position`
+    [[nodiscard]] std::unique_ptr<Chunk> generate(const glm::ivec3& position) const;
+
+    // Density at a world voxel, > 0 is solid, evaluated on its own for reference and tools.
+    // Interpolates the same lattice in the same order as generate(), so they agree.
+    [[nodiscard]] float density(int worldX, int worldY, int worldZ) const;
+
+    [[nodiscard]] long int getSeed() const { return _seed; }
+    [[nodiscard]] int getMaxDensityCellSize() const { return _maxDensityCellSize; }
+    [[nodiscard]] const BiomeMap& getBiomeMap() const { return _biomes; }
+    [[nodiscard]] GenerationStats getStats() const;
+
+    // Lattice cell size the biome's relief needs: 4 for the rugged ones, 8 otherwise
+    [[nodiscard]] static int getBiomeDensityCellSize(Biome biome);
+
+  private:
+    [[nodiscard]] float noise3D(int worldX, int worldY, int worldZ) const;
+    // Cell size of the chunk column whose first voxel column is at `local` in `layers`
+    [[nodiscard]] int chunkCellSize(const BiomeMap::RegionLayers& layers,
+                                    const glm::ivec2& local) const;
+
+    long int _seed;
+    long int _densitySeed; // Decorrelated from the heightmap's
+    int _maxDensityCellSize;
+    BiomeMap _biomes;
+    mutable std::atomic<size_t> _generatedChunks{0};
+    mutable std::atomic<size_t> _airChunks{0};
+    mutable std::atomic<size_t> _solidChunks{0};
+    mutable std::atomic<size_t> _densitySamples{0};
+};
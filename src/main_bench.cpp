@@ -0,0 +1,159 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench/MeshingBenchmark.hpp"
+#include "bench/WorldBenchmark.hpp"
+#include "common/World/BlockRegistry.hpp"
+
+namespace {
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program
+              << " [--suite meshing|world|determinism|all] [--iterations N] [--world-size N]"
+                 " [--world-height N] [--threads N,N,...] [--seed N] [--expect-hash HASH]"
+                 " [--json FILE|-]\n"
+                 "  --threads      thread counts for the world and determinism suites, 0 for all\n"
+                 "                 hardware threads\n"
+                 "  --expect-hash  fails the determinism suite unless its world hash is HASH\n"
+                 "  --json         writes the world or determinism results as JSON, '-' for"
+                 " stdout.\n"
+                 "                 The meshing suite has no JSON results and rejects it\n"
+                 "'all' runs the meshing and world suites. The world suite exits with a failure\n"
+                 "when the batched noise exceeds its tolerance, the determinism suite when\n"
+                 "chunks differ between passes or from --expect-hash.\n";
+}
+
+// "1,4,0" -> {1, 4, hardware threads}
+bool parseThreadCounts(const std::string& list, std::vector<unsigned int>& threadCounts) {
+    threadCounts.clear();
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        const int count = std::atoi(item.c_str());
+        if (count < 0) {
+            return false;
+        }
+        threadCounts.push_back(count == 0 ? std::max(1U, std::thread::hardware_concurrency())
+                                          : static_cast<unsigned int>(count));
+    }
+    return !threadCounts.empty();
+}
+// A whole decimal long, rejecting trailing characters and out-of-range values
+bool parseSeed(const char* text, long int& seed) {
+    char* end = nullptr;
+    errno = 0;
+    const long int value = std::strtol(text, &end, 10);
+    if (errno != 0 || end == text || *end != '\0') {
+        return false;
+    }
+    seed = value;
+    return true;
+}
+
+// To stdout for "-", to the file otherwise, nowhere when no path was given
+void writeResults(const nlohmann::json& results, const std::string& path) {
+    if (path == "-") {
+        std::cout << results.dump(2) << "\n";
+    } else if (!path.empty()) {
+        std::ofstream file(path);
+        file << results.dump(2) << "\n";
+        if (!file) {
+            throw std::runtime_error("Failed to write " + path);
+        }
+        std::cout << "\nResults written to " << path << "\n";
+    }
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string suite = "all";
+    std::string jsonPath;
+    std::string expectedHash;
+    WorldBenchmarkOptions worldOptions;
+    // Single-threaded and every hardware thread by default
+    if (std::thread::hardware_concurrency() > 1) {
+        worldOptions.threadCounts.push_back(std::thread::hardware_concurrency());
+    }
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--iterations" && hasValue) {
+            worldOptions.iterations = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--suite" && hasValue) {
+            suite = argv[++i];
+        } else if (arg == "--world-size" && hasValue) {
+            worldOptions.worldSize = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--world-height" && hasValue) {
+            worldOptions.worldHeight = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--threads" && hasValue &&
+                   parseThreadCounts(argv[++i], worldOptions.threadCounts)) {
+            continue;
+        } else if (arg == "--seed" && hasValue && parseSeed(argv[++i], worldOptions.seed)) {
+            continue;
+        } else if (arg == "--expect-hash" && hasValue) {
+            expectedHash = argv[++i];
+        } else if (arg == "--json" && hasValue) {
+            jsonPath = argv[++i];
+        } else {
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (suite != "meshing" && suite != "world" && suite != "determinism" && suite != "all") {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (suite == "meshing" && !jsonPath.empty()) {
+        std::cerr << "--json is not supported by the meshing suite\n";
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    // JSON on stdout replaces the readable reports
+    const bool jsonToStdout = jsonPath == "-";
+
+    try {
+        if (suite == "determinism") {
+            const nlohmann::json results =
+                runDeterminismCheck(worldOptions, jsonToStdout ? nullptr : &std::cout);
+            writeResults(results, jsonPath);
+            const bool hashMatches =
+                expectedHash.empty() || results["world_hash"].get<std::string>() == expectedHash;
+            if (!hashMatches) {
+                std::cerr << "World hash " << results["world_hash"].get<std::string>()
+                          << " does not match the expected " << expectedHash << "\n";
+            }
+            return results["passed"].get<bool>() && hashMatches ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+
+        BlockRegistry registry;
+        if ((suite == "meshing" || suite == "all") && !jsonToStdout) {
+            runMeshingBenchmark(registry, worldOptions.iterations);
+        }
+        if (suite == "world" || suite == "all") {
+            if (!jsonToStdout && suite == "all") {
+                std::cout << "\n";
+            }
+            const nlohmann::json results =
+                runWorldBenchmark(registry, worldOptions, jsonToStdout ? nullptr : &std::cout);
+            writeResults(results, jsonPath);
+            if (!results["perlin"]["passed"].get<bool>()) {
+                std::cerr << "perlinNoiseBatch is further than "
+                          << results["perlin"]["tolerance"].get<double>()
+                          << " from the reference noise\n";
+                return EXIT_FAILURE;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Benchmark failed: " << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
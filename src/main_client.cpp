@@ -1,10 +1,28 @@
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 
 #include "client/Core/App.hpp"
+#include "common/World/TerrainGenerator.hpp"
+
+int main(int argc, char** argv) {
+    long int worldSeed = TerrainGenerator::DEFAULT_SEED;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            char* end = nullptr;
+            errno = 0;
+            worldSeed = std::strtol(argv[++i], &end, 10);
+            if (errno == 0 && end != argv[i] && *end == '\0') {
+                continue;
+            }
+        }
+        std::cerr << "Usage: " << argv[0] << " [--seed N]\n";
+        return EXIT_FAILURE;
+    }
 
-int main() {
     try {
-        App app;
+        App app(worldSeed);
         app.run();
     } catch (const std::exception& e) {
         std::cerr << "Application failed to start: " << e.what() << "\n";